@@ -0,0 +1,71 @@
+//
+//  benchmark_dsoft_autotune.cpp
+//  PFSOFTlib
+//
+//   Created by Denis-Michael Lux on 05. November 2015.
+//
+//   This file is part of PFSOFTlib.
+//
+//   PFSOFTlib is free software: you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License as published by
+//   the Free Software Foundation, either version 3 of the License, or
+//   (at your option) any later version.
+//
+//   PFSOFTlib is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with PFSOFTlib.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <pfsoft>
+#include <stdio.h>
+
+using namespace pfsoft;
+using namespace FourierTransforms;
+
+int main(int argc, const char** argv)
+{
+    if (argc < 5)
+    {
+        printf("usage: ./benchmark_dsoft_autotune <MIN BANDWIDTH> <MAX BANDWIDTH> <STEP> <PROFILE FILE> [RUNS PER MEASUREMENT]\n");
+        return 1;
+    }
+    
+    int START_BW = atoi(argv[1]);
+    int MAX_BW   = atoi(argv[2]);
+    int STEP     = atoi(argv[3]);
+    int LOOP_R   = (argc > 5 ? atoi(argv[5]) : 3);
+    
+    // To make things fair, we run omp once for startup. This will avoid
+    // initialization time later on:
+#ifdef _OPENMP
+    int max_procs = omp_get_num_procs();
+    #pragma omp parallel for num_threads(max_procs)
+    for (int i = 0; i < max_procs; i++);
+#endif
+    
+    printf("Tuning DSOFT from bandwidth %d to %d (step %d) with up to %d threads...\n", START_BW, MAX_BW, STEP, PFSOFT_MAX_THREADS);
+    
+    if (!DSOFT_autotune(START_BW, MAX_BW, STEP, argv[4], PFSOFT_MAX_THREADS, LOOP_R))
+    {
+        return 1;
+    }
+    
+    printf("+=====+=========+\n");
+    printf("|  B  | threads |\n");
+    printf("+=====+=========+\n");
+    
+    for (int bandwidth = START_BW; bandwidth <= MAX_BW; bandwidth += STEP)
+    {
+        printf("| %3d | %7d |\n", bandwidth, DSOFT_threads(bandwidth, PFSOFT_MAX_THREADS));
+    }
+    
+    printf("+=====+=========+\n");
+    printf("Parallel crossover: B = %d\n", DSOFT_threshold());
+    printf("Profile written to '%s'. Set PFSOFT_PROFILE=%s to use it.\n", argv[4], argv[4]);
+    
+    return 0;
+}
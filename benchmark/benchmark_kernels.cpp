@@ -0,0 +1,462 @@
+//
+//  benchmark_kernels.cpp
+//  PFSOFTlib
+//
+//   Created by Denis-Michael Lux on 05. November 2015.
+//
+//   This file is part of PFSOFTlib.
+//
+//   PFSOFTlib is free software: you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License as published by
+//   the Free Software Foundation, either version 3 of the License, or
+//   (at your option) any later version.
+//
+//   PFSOFTlib is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with PFSOFTlib.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <algorithm>
+#include <unistd.h>
+
+#include "benchmark_pfsoft.hpp"
+
+using namespace pfsoft;
+using namespace FourierTransforms;
+
+/*!
+ * @brief       Work of one kernel call
+ * @details     The flops are a model of the arithmetic in the inner loops, the
+ *              bytes the data that has to be read and written at least.
+ */
+struct kernel_work
+{
+    double elements;    //!< Processed elements
+    double bytes;       //!< Moved bytes or 0 if compute bound
+    double flops;       //!< Floating point operations or 0 if memory bound
+};
+
+/*!
+ * @brief       The measured peaks of the machine for one thread
+ * @details     The bandwidth is measured per level of the memory hierarchy. A
+ *              kernel is compared with the level its working set fits into.
+ */
+struct kernel_peak
+{
+    double capacity[4];     //!< Bytes of the L1, L2 and L3 cache and of the DRAM working set
+    double bandwidth[4];    //!< Bandwidth in GB/s of a working set in L1, L2, L3 and DRAM
+    double gflops[3];       //!< Arithmetic peak in GFLOP/s of float, double, long double
+};
+
+static const char* memory_levels[4] = { "L1", "L2", "L3", "DRAM" };
+
+/*- Peaks -*/
+// the size of a cache level in bytes or the given default if the system
+// does not report it
+static double cache_size(const int& level, const double& fallback)
+{
+    long bytes = 0;
+
+#if defined(_SC_LEVEL1_DCACHE_SIZE) && defined(_SC_LEVEL2_CACHE_SIZE) && defined(_SC_LEVEL3_CACHE_SIZE)
+    if      (level == 1) { bytes = sysconf(_SC_LEVEL1_DCACHE_SIZE); }
+    else if (level == 2) { bytes = sysconf(_SC_LEVEL2_CACHE_SIZE);  }
+    else if (level == 3) { bytes = sysconf(_SC_LEVEL3_CACHE_SIZE);  }
+#else
+    (void) level;
+#endif
+
+    return (bytes > 0 ? static_cast< double >(bytes) : fallback);
+}
+
+// Reads and writes every element in place like the flips and the transpose,
+// so the counted bytes are the moved ones. A STREAM triad would also move
+// the write-allocate of its target array without counting it. Cloned like
+// the kernels so it runs with the widest loads and stores of the processor.
+pfsoft_target_clones
+static void update(double* __restrict__ a, const size_t n)
+{
+    for (size_t i = 0; i < n; ++i) { a[i] = 0.5 * a[i] + 0.25; }
+}
+
+// in place update of an array of the given bytes. Small working sets are
+// repeated until at least 1 GB is moved per sample. The peak is the best of
+// ten samples, so a noisy sample does not lower it below the kernels.
+static double memory_peak(const double& bytes)
+{
+    const size_t n    = std::max(static_cast< size_t >(bytes / sizeof(double)), static_cast< size_t >(64));
+    const long   reps = std::max(1L, static_cast< long >((1L << 30) / (2 * sizeof(double) * n)));
+    
+    std::vector< double > a(n, 1);
+    
+    double best = 0;
+    for (int r = 0; r < 11; ++r)
+    {
+        stopwatch sw = stopwatch::tic();
+        for (long k = 0; k < reps; ++k) { update(a.data(), n); }
+        const double t = sw.toc();
+        
+        // the first run only loads the array into the level
+        if (r > 0)
+        {
+            best = std::max(best, 2 * sizeof(double) * n * reps / t / 1e9);
+        }
+    }
+    
+    // keep the update from being optimized away
+    volatile double sink = a[n / 2];
+    (void) sink;
+    
+    return best;
+}
+
+// the level of the memory hierarchy a working set of the given bytes fits into
+static int memory_level(const kernel_peak& peak, const double& bytes)
+{
+    int level = 0;
+    while (level < 3 && bytes > peak.capacity[level])
+    {
+        ++level;
+    }
+    
+    return level;
+}
+
+// W independent multiply-adds that stay in the registers. For the vector
+// units W is eight vectors of the instruction set, which covers the latency
+// of the multiply-add units. The barriers keep the compiler from merging the
+// accumulators with the array of the caller, which lives across the calls
+// of the stopwatch and therefore in memory.
+template< typename T, int W, bool FMA >
+__attribute__((always_inline))
+static inline void flop_kernel(T* acc, const T& a, const T& b, const long& n)
+{
+    T x[W];
+    for (int i = 0; i < W; ++i) { x[i] = acc[i]; }
+    
+    __asm__ __volatile__("" ::: "memory");
+    
+    for (long k = 0; k < n; ++k)
+    {
+        if (FMA) { for (int i = 0; i < W; ++i) { x[i] = std::fma(x[i], a, b); } }
+        else     { for (int i = 0; i < W; ++i) { x[i] = x[i] * a + b;         } }
+    }
+    
+    __asm__ __volatile__("" ::: "memory");
+    
+    for (int i = 0; i < W; ++i) { acc[i] = x[i]; }
+}
+
+// The x87 kernel runs in a function of its own. The register stack of the
+// x87 unit is not saved across calls, and next to the calls of the stopwatch
+// GCC keeps its accumulators in memory despite the barriers. Six
+// accumulators and the two constants fill the eight registers of the stack.
+__attribute__((noinline))
+static void flop_kernel_x87(long double* acc, const long double& a, const long double& b, const long& n)
+{
+    flop_kernel< long double, 6, false >(acc, a, b, n);
+}
+
+// times W multiply-adds with the kernel K
+template< typename T, int W, void (*K)(T*, const T&, const T&, const long&) >
+__attribute__((always_inline))
+static inline double flop_loop()
+{
+    const long n = (1 << 25) / W;
+    
+    T acc[W];
+    for (int i = 0; i < W; ++i) { acc[i] = static_cast< T >(i) * static_cast< T >(1e-3); }
+    
+    const T a = static_cast< T >(0.999999);
+    const T b = static_cast< T >(1e-7);
+    
+    double best = 0;
+    for (int r = 0; r < 5; ++r)
+    {
+        stopwatch sw = stopwatch::tic();
+        K(acc, a, b, n);
+        const double t = sw.toc();
+        
+        best = std::max(best, 2.0 * W * n / t / 1e9);
+    }
+    
+    T sum = 0;
+    for (int i = 0; i < W; ++i) { sum += acc[i]; }
+    
+    volatile T sink = sum;
+    (void) sink;
+    
+    return best;
+}
+
+// The float and double peaks have one version per instruction set of
+// pfsoft_target_clones, so they run with the vector width of the kernels.
+// The vector versions add FMA, which every processor with AVX2 or AVX-512
+// has. The long double peak runs on the x87 unit.
+#if PFSOFT_TARGET_CLONES
+__attribute__((target("avx512f,fma"))) static double flop_peak_float()  { return flop_loop< float,  128, flop_kernel< float,  128, true  > >(); }
+__attribute__((target("avx2,fma")))    static double flop_peak_float()  { return flop_loop< float,  64,  flop_kernel< float,  64,  true  > >(); }
+__attribute__((target("default")))     static double flop_peak_float()  { return flop_loop< float,  32,  flop_kernel< float,  32,  false > >(); }
+__attribute__((target("avx512f,fma"))) static double flop_peak_double() { return flop_loop< double, 64,  flop_kernel< double, 64,  true  > >(); }
+__attribute__((target("avx2,fma")))    static double flop_peak_double() { return flop_loop< double, 32,  flop_kernel< double, 32,  true  > >(); }
+__attribute__((target("default")))     static double flop_peak_double() { return flop_loop< double, 16,  flop_kernel< double, 16,  false > >(); }
+#else
+static double flop_peak_float()  { return flop_loop< float,  32, flop_kernel< float,  32, false > >(); }
+static double flop_peak_double() { return flop_loop< double, 16, flop_kernel< double, 16, false > >(); }
+#endif
+
+static double flop_peak_long_double() { return flop_loop< long double, 6, flop_kernel_x87 >(); }
+
+/*- Timing -*/
+// times f. Every sample repeats f until it takes at least a millisecond,
+// so the samples are the seconds of a single call.
+template< typename F >
+static void time_kernel(const bench_spec& spec, F f, std::vector< double >& samples)
+{
+    long reps = 1;
+    while (reps < (1L << 24))
+    {
+        stopwatch sw = stopwatch::tic();
+        for (long r = 0; r < reps; ++r) { f(); }
+        
+        if (sw.toc() >= 1e-3) { break; }
+        reps *= 2;
+    }
+    
+    for (int i = 0; i < spec.warmup + spec.runs; ++i)
+    {
+        stopwatch sw = stopwatch::tic();
+        for (long r = 0; r < reps; ++r) { f(); }
+        const double t = sw.toc() / reps;
+        
+        if (i >= spec.warmup)
+        {
+            samples.push_back(t);
+        }
+    }
+}
+
+// writes a kernel result with the derived rates. The peak is the one that
+// bounds the kernel, i.e. the bandwidth of the level its working set fits
+// into for memory bound kernels. The level names this peak.
+static void report(bench_json& json, const char* kernel, const int& bandwidth, const int& threads, const char* precision, const std::vector< double >& samples, const kernel_work& w, const double& peak, const char* level)
+{
+    const double median = bench_summarize(samples).median;
+    
+    const double gbs    = (w.bytes > 0 ? w.bytes / median / 1e9 : 0);
+    const double gflops = (w.flops > 0 ? w.flops / median / 1e9 : 0);
+    
+    json.begin_object();
+    json.value("command",   "kernels");
+    json.value("kernel",    kernel);
+    json.value("bandwidth", bandwidth);
+    json.value("threads",   threads);
+    json.value("precision", precision);
+    json.value("metric",    "seconds");
+    json.value("samples",   samples);
+    json.summary("summary", samples);
+    json.value("elements",  w.elements);
+    json.value("bytes",     w.bytes);
+    json.value("flops",     w.flops);
+    json.value("ns_per_element", 1e9 * median / w.elements);
+    
+    if (w.bytes > 0) { json.value("gb_per_s",    gbs);    }
+    if (w.flops > 0) { json.value("gflop_per_s", gflops); }
+    
+    json.value("peak_fraction", (w.flops > 0 ? gflops : gbs) / peak);
+    json.value("peak_level",    level);
+    json.end_object();
+    
+    fprintf(stderr, "| %-24s | B %4d | T %3d | %-11s | %10.3f ns/elem | %8.3f %s | %5.1f%% of %-4s peak |\n",
+            kernel, bandwidth, threads, precision, 1e9 * median / w.elements,
+            w.flops > 0 ? gflops : gbs, w.flops > 0 ? "GFLOP/s" : "GB/s   ", 100 * (w.flops > 0 ? gflops : gbs) / peak, level);
+}
+
+/*- Kernels -*/
+// the DWT building blocks for one precision
+template< typename T >
+static void dwt_kernels(const bench_spec& spec, bench_json& json, const int& bandwidth, const char* precision, const kernel_peak& peak, const double& flop_peak)
+{
+    const int    bw2  = 2 * bandwidth;
+    const int    rows = bandwidth;
+    const double n    = static_cast< double >(rows) * bw2;
+    
+    std::vector< double > samples;
+    
+    // quadrature weights, one sine per weight and a sine transform of length
+    // bandwidth. Double precision, and long double with the long double FFTW,
+    // use FFTW from bandwidth 16 on. The other precisions sum directly with a
+    // sine and four flops per term.
+    vector< T > weights(bw2);
+    time_kernel(spec, [&]() { DWT::quadrature_weights(weights); }, samples);
+    
+    const bool   fft_weights = (same_type< T, double >::value || (PFSOFT_FFTWL && same_type< T, long double >::value)) && bandwidth >= 16;
+    const double sine_flops  = fft_weights ? 2.5 * bandwidth * std::max(log2(bandwidth), 1.0) : 12.0 * bandwidth * bandwidth;
+    
+    kernel_work qw = { static_cast< double >(bandwidth), 0, sine_flops + 8.0 * bandwidth };
+    report(json, "quadrature_weights", bandwidth, 1, precision, samples, qw, flop_peak, "core");
+    
+    // wigner d-matrices of the orders (0, 0), which have the most rows.
+    // The three-term recurrence costs five flops per element.
+    matrix< T > d(rows, bw2);
+    kernel_work wd = { n, 0, 5 * n };
+    
+    samples.clear();
+    time_kernel(spec, [&]() { DWT::wigner_d_matrix(d, bandwidth, 0, 0); }, samples);
+    report(json, "wigner_d_matrix", bandwidth, 1, precision, samples, wd, flop_peak, "core");
+    
+    samples.clear();
+    time_kernel(spec, [&]() { DWT::weighted_wigner_d_matrix(d, bandwidth, 0, 0, weights); }, samples);
+    report(json, "weighted_wigner_d_matrix", bandwidth, 1, precision, samples, wd, flop_peak, "core");
+    
+    // flips read and write every element of the matrix once
+    kernel_work mv = { n, 2 * n * sizeof(T), 0 };
+    const int   lm = memory_level(peak, n * sizeof(T));
+    
+    samples.clear();
+    time_kernel(spec, [&]() { fliplr(d); }, samples);
+    report(json, "fliplr", bandwidth, 1, precision, samples, mv, peak.bandwidth[lm], memory_levels[lm]);
+    
+    samples.clear();
+    time_kernel(spec, [&]() { flipud(d); }, samples);
+    report(json, "flipud", bandwidth, 1, precision, samples, mv, peak.bandwidth[lm], memory_levels[lm]);
+    
+    samples.clear();
+    time_kernel(spec, [&]() { fliplr_ne2ndorow(d); }, samples);
+    report(json, "fliplr_ne2ndorow", bandwidth, 1, precision, samples, mv, peak.bandwidth[lm], memory_levels[lm]);
+    
+    samples.clear();
+    time_kernel(spec, [&]() { fliplr_ne2nderow(d); }, samples);
+    report(json, "fliplr_ne2nderow", bandwidth, 1, precision, samples, mv, peak.bandwidth[lm], memory_levels[lm]);
+    
+    samples.clear();
+    time_kernel(spec, [&]() { flipud_ne2ndocol(d); }, samples);
+    report(json, "flipud_ne2ndocol", bandwidth, 1, precision, samples, mv, peak.bandwidth[lm], memory_levels[lm]);
+    
+    samples.clear();
+    time_kernel(spec, [&]() { flipud_ne2ndecol(d); }, samples);
+    report(json, "flipud_ne2ndecol", bandwidth, 1, precision, samples, mv, peak.bandwidth[lm], memory_levels[lm]);
+    
+    // transposing twice restores the shape, every call moves all elements
+    samples.clear();
+    time_kernel(spec, [&]() { d.transpose(); }, samples);
+    report(json, "matrix::transpose", bandwidth, 1, precision, samples, mv, peak.bandwidth[lm], memory_levels[lm]);
+    
+    // matrix times complex vector like in the DWT, one multiply-add of the
+    // real and imaginary part per matrix element
+    matrix< T > dw(rows, bw2);
+    DWT::weighted_wigner_d_matrix(dw, bandwidth, 0, 0, weights);
+    
+    vector< complex< T > > s(bw2, vector< complex< T > >::COLUMN);
+    vector< complex< T > > sh;
+    for (int i = 0; i < bw2; ++i) { s[i] = complex< T >(static_cast< T >(i), static_cast< T >(-i)); }
+    
+    kernel_work mm = { n, n * sizeof(T), 4 * n };
+    
+    samples.clear();
+    time_kernel(spec, [&]() { sh = dw * s; }, samples);
+    report(json, "matrix*vector<complex>", bandwidth, 1, precision, samples, mm, flop_peak, "core");
+    
+    // precision conversion of a grid line like in the DWT
+    vector< complex< double > > line(bw2, vector< complex< double > >::COLUMN);
+    kernel_work cv = { static_cast< double >(bw2), static_cast< double >(bw2 * (sizeof(complex< double >) + sizeof(complex< T >))), 0 };
+    const int   lc = memory_level(peak, cv.bytes);
+    
+    samples.clear();
+    time_kernel(spec, [&]() { s = convert< T >(line); }, samples);
+    report(json, "convert<>", bandwidth, 1, precision, samples, cv, peak.bandwidth[lc], memory_levels[lc]);
+}
+
+int bench_kernels(const bench_spec& spec, bench_json& json)
+{
+    /*****************************************************************
+     ** Peaks of one thread                                         **
+     *****************************************************************/
+    // A kernel that no longer fits into a level runs from the next one with
+    // a working set just beyond the smaller level. The L1 is measured with
+    // half of its size, the L2 and L3 with four times the size of the level
+    // below but at most half of their own. The L3 a processor reports is
+    // shared by all cores, so a larger working set would mostly measure the
+    // DRAM. The DRAM is measured with twice the L3, at least 64 MB and at
+    // most 1 GB.
+    kernel_peak peak;
+    peak.capacity[0] = cache_size(1, 32 << 10);
+    peak.capacity[1] = cache_size(2, 1 << 20);
+    peak.capacity[2] = cache_size(3, 8 << 20);
+    peak.capacity[3] = std::min(std::max(2 * peak.capacity[2], 64.0 * (1 << 20)), 1024.0 * (1 << 20));
+    
+    peak.bandwidth[0] = memory_peak(peak.capacity[0] / 2);
+    peak.bandwidth[1] = memory_peak(std::min(4 * peak.capacity[0], peak.capacity[1] / 2));
+    peak.bandwidth[2] = memory_peak(std::min(4 * peak.capacity[1], peak.capacity[2] / 2));
+    peak.bandwidth[3] = memory_peak(peak.capacity[3]);
+    
+    peak.gflops[0] = flop_peak_float();
+    peak.gflops[1] = flop_peak_double();
+    peak.gflops[2] = flop_peak_long_double();
+    
+    json.begin_object();
+    json.value("command",   "kernels");
+    json.value("kernel",    "peak");
+    json.value("metric",    "peak");
+    json.value("simd",      SIMD::variant());
+    json.value("bytes_l1",  peak.capacity[0]);
+    json.value("bytes_l2",  peak.capacity[1]);
+    json.value("bytes_l3",  peak.capacity[2]);
+    json.value("gb_per_s_l1",   peak.bandwidth[0]);
+    json.value("gb_per_s_l2",   peak.bandwidth[1]);
+    json.value("gb_per_s_l3",   peak.bandwidth[2]);
+    json.value("gb_per_s_dram", peak.bandwidth[3]);
+    json.value("gflop_per_s_float",       peak.gflops[0]);
+    json.value("gflop_per_s_double",      peak.gflops[1]);
+    json.value("gflop_per_s_long_double", peak.gflops[2]);
+    json.end_object();
+    
+    fprintf(stderr, "| peak per thread: %.2f / %.2f / %.2f / %.2f GB/s (L1 / L2 / L3 / DRAM), %.2f / %.2f / %.2f GFLOP/s (float / double / long double)\n",
+            peak.bandwidth[0], peak.bandwidth[1], peak.bandwidth[2], peak.bandwidth[3], peak.gflops[0], peak.gflops[1], peak.gflops[2]);
+    
+    for (size_t b = 0; b < spec.bandwidths.size(); ++b)
+    {
+        const int bandwidth = spec.bandwidths[b];
+        
+        for (size_t p = 0; p < spec.precisions.size(); ++p)
+        {
+            const std::string& precision = spec.precisions[p];
+            
+            if      (precision == "float")       { dwt_kernels< float >      (spec, json, bandwidth, "float",       peak, peak.gflops[0]); }
+            else if (precision == "double")      { dwt_kernels< double >     (spec, json, bandwidth, "double",      peak, peak.gflops[1]); }
+            else if (precision == "long_double") { dwt_kernels< long double >(spec, json, bandwidth, "long_double", peak, peak.gflops[2]); }
+            else
+            {
+                fprintf(stderr, "kernels: unknown precision '%s'.\n", precision.c_str());
+                return 1;
+            }
+        }
+        
+        // the layer-wise FFT2 only exists in double precision. Scaling by
+        // 1/sqrt(N) keeps the values of the repeated transforms bounded.
+        const int    bw2 = 2 * bandwidth;
+        const double N   = static_cast< double >(bw2) * bw2;
+        
+        grid3D< complex< double > > grid(bw2, bw2, bw2);
+        for (int i = 0; i < bw2 * bw2 * bw2; ++i)
+        {
+            access::rwp(grid.mem)[i] = complex< double >(sin(i), cos(i));
+        }
+        
+        kernel_work fft = { N * bw2, 0, 5 * N * log2(N) * bw2 };
+        
+        for (size_t t = 0; t < spec.threads.size(); ++t)
+        {
+            const int threads = spec.threads[t];
+            
+            std::vector< double > samples;
+            time_kernel(spec, [&]() { grid.layer_wise_DFT2(complex< double >(1 / sqrt(N), 0), threads); }, samples);
+            report(json, "layer_wise_DFT2", bandwidth, threads, "double", samples, fft, threads * peak.gflops[1], "core");
+        }
+    }
+    
+    return 0;
+}
@@ -0,0 +1,222 @@
+//
+//  benchmark_latency.cpp
+//  PFSOFTlib
+//
+//   Created by Denis-Michael Lux on 05. November 2015.
+//
+//   This file is part of PFSOFTlib.
+//
+//   PFSOFTlib is free software: you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License as published by
+//   the Free Software Foundation, either version 3 of the License, or
+//   (at your option) any later version.
+//
+//   PFSOFTlib is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with PFSOFTlib.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <algorithm>
+
+#include "benchmark_pfsoft.hpp"
+
+using namespace pfsoft;
+using namespace FourierTransforms;
+
+/*- Histogram -*/
+// log-spaced histogram of latencies in ns with bins per octave bins
+static void histogram(bench_json& json, const std::vector< double >& sorted, const int& bins)
+{
+    std::vector< double > edges, counts;
+    
+    if (!sorted.empty())
+    {
+        const double lo = floor(log2(std::max(sorted.front(), 1.0)));
+        const double hi = ceil (log2(std::max(sorted.back(),  2.0)));
+        
+        for (int i = 0; i <= static_cast< int >((hi - lo) * bins); ++i)
+        {
+            edges.push_back(exp2(lo + static_cast< double >(i) / bins));
+        }
+        
+        // the samples are sorted, so every bin is a range of them
+        size_t first = 0;
+        for (size_t i = 1; i < edges.size(); ++i)
+        {
+            const size_t last = std::upper_bound(sorted.begin() + first, sorted.end(), edges[i]) - sorted.begin();
+            
+            counts.push_back(static_cast< double >(last - first));
+            first = last;
+        }
+    }
+    
+    json.begin_object("histogram");
+    json.value("edges_ns", edges);
+    json.value("counts",   counts);
+    json.end_object();
+}
+
+static void percentiles(bench_json& json, const char* key, const std::vector< double >& sorted)
+{
+    json.begin_object(key);
+    json.value("min",   sorted.empty() ? 0 : sorted.front());
+    json.value("p50",   bench_percentile(sorted, 0.5));
+    json.value("p90",   bench_percentile(sorted, 0.9));
+    json.value("p99",   bench_percentile(sorted, 0.99));
+    json.value("p99.9", bench_percentile(sorted, 0.999));
+    json.value("max",   sorted.empty() ? 0 : sorted.back());
+    json.end_object();
+}
+
+/*- Fixed overheads -*/
+// median latency in ns of calls of f
+template< typename F >
+static double probe(const int& calls, F f)
+{
+    std::vector< double > samples(calls);
+    
+    for (int i = 0; i < calls; ++i)
+    {
+        stopwatch sw = stopwatch::tic();
+        f();
+        samples[i] = sw.toc_nanos();
+    }
+    
+    std::sort(samples.begin(), samples.end());
+    return bench_percentile(samples, 0.5);
+}
+
+int bench_latency(const bench_spec& spec, bench_json& json)
+{
+    if (std::find(spec.precisions.begin(), spec.precisions.end(), "double") == spec.precisions.end())
+    {
+        fprintf(stderr, "latency: the transforms are only available in double precision.\n");
+        return 1;
+    }
+    
+    for (size_t b = 0; b < spec.bandwidths.size(); ++b)
+    {
+        const int bandwidth = spec.bandwidths[b];
+        const int bw2       = 2 * bandwidth;
+        
+        grid3D< complex< double > > sample(bw2);
+        DSOFTFourierCoefficients    coef(bandwidth);
+        DSOFTFourierCoefficients    rec_coef(bandwidth);
+        
+        // generate random coefficients between -1 and 1
+        uniform_real_distribution< double > ctx;
+        ctx.engine = random_engine::MERSENNE_TWISTER64;
+        ctx.min    = -1;
+        ctx.max    = +1;
+        
+        rand(coef, ctx);
+        IDSOFT(coef, sample);
+        
+        for (size_t t = 0; t < spec.threads.size(); ++t)
+        {
+            // the transforms decide the same way whether the loops run in parallel
+            const int  threads  = spec.threads[t];
+            const int  used     = DSOFT_threads(bandwidth, threads);
+            const bool parallel = used > 1 && bandwidth >= DSOFT_threshold();
+            
+            // Costs of a call that do not depend on the amount of work: planning
+            // the layer-wise FFT2, copying the sample and entering the parallel
+            // region of the (M, M') loops
+            const int calls = std::min(spec.calls, 1000);
+            
+            const double plan = probe(calls, [&]()
+            {
+                uzl_fftw_layer_context fft;
+                uzl_fftw_layer_context_create(&fft, bw2, bw2, bw2, reinterpret_cast< double* >(access::rwp(sample.mem)), -1);
+                uzl_fftw_layer_context_destroy(&fft);
+            });
+            
+            const double copy = probe(calls, [&]()
+            {
+                grid3D< complex< double > > tmp(sample);
+            });
+            
+            const double region = probe(calls, [&]()
+            {
+                // an empty region only pays for forking and joining the team
+                #pragma omp parallel if(parallel) num_threads(used)
+                {}
+            });
+            
+            for (int forward = 1; forward >= 0; --forward)
+            {
+                const char* command = (forward ? "forward" : "inverse");
+                
+                DSOFTStats            stats;
+                std::vector< double > latency, fft, loops;
+                
+                for (int i = 0; i < spec.warmup + spec.calls; ++i)
+                {
+                    stopwatch sw = stopwatch::tic();
+                    
+                    if (forward) { DSOFT(sample, rec_coef, stats, threads); }
+                    else         { IDSOFT(coef, sample, stats, threads);    }
+                    
+                    const double ns = sw.toc_nanos();
+                    
+                    if (i >= spec.warmup)
+                    {
+                        latency.push_back(ns);
+                        fft.push_back(1e9 * stats.time[DSOFTStats::FFT]);
+                        loops.push_back(1e9 * stats.loops);
+                    }
+                }
+                
+                std::sort(latency.begin(), latency.end());
+                
+                const double median = bench_percentile(latency, 0.5);
+                const double fixed  = plan + region + (forward ? copy : 0);
+                
+                json.begin_object();
+                json.value("command",   "latency");
+                json.value("transform", command);
+                json.value("bandwidth", bandwidth);
+                json.value("threads",   threads);
+                json.value("parallel",  parallel ? 1 : 0);
+                json.value("precision", "double");
+                json.value("metric",    "nanoseconds");
+                json.value("calls",     spec.calls);
+                percentiles(json, "latency", latency);
+                histogram(json, latency, 4);
+                
+                // medians of the fixed costs measured on their own
+                json.begin_object("overhead");
+                json.value("plan",       plan);
+                json.value("copy",       forward ? copy : 0);
+                json.value("omp_region", region);
+                json.value("fixed",      fixed);
+                json.value("fraction",   median > 0 ? fixed / median : 0);
+                json.end_object();
+                
+                // the stages of the calls themselves, the FFT includes the planning
+                if (stats.enabled)
+                {
+                    std::sort(fft.begin(),   fft.end());
+                    std::sort(loops.begin(), loops.end());
+                    
+                    json.begin_object("stages");
+                    percentiles(json, "FFT",   fft);
+                    percentiles(json, "loops", loops);
+                    json.end_object();
+                }
+                
+                json.end_object();
+                
+                fprintf(stderr, "| latency %-7s | B %4d | T %3d | p50 %10.0f ns | p90 %10.0f ns | p99 %10.0f ns | p99.9 %10.0f ns | fixed %5.1f%% (plan %.0f, copy %.0f, region %.0f ns) |\n",
+                        command, bandwidth, threads, median, bench_percentile(latency, 0.9), bench_percentile(latency, 0.99), bench_percentile(latency, 0.999),
+                        median > 0 ? 100 * fixed / median : 0, plan, forward ? copy : 0, region);
+            }
+        }
+    }
+    
+    return 0;
+}
@@ -0,0 +1,369 @@
+//
+//  benchmark_memory.cpp
+//  PFSOFTlib
+//
+//   Created by Denis-Michael Lux on 05. November 2015.
+//
+//   This file is part of PFSOFTlib.
+//
+//   PFSOFTlib is free software: you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License as published by
+//   the Free Software Foundation, either version 3 of the License, or
+//   (at your option) any later version.
+//
+//   PFSOFTlib is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with PFSOFTlib.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <algorithm>
+#include <atomic>
+#include <errno.h>
+#include <string.h>
+
+#if defined(__GLIBC__)
+    #include <malloc.h>
+#endif
+
+#include "benchmark_pfsoft.hpp"
+
+using namespace pfsoft;
+using namespace FourierTransforms;
+
+/*- Allocation counting -*/
+// The benchmark replaces the allocation functions of the C library, so every
+// allocation of the library, of FFTW, of operator new and of the OpenMP
+// runtime is counted. Needs the glibc entry points of the original functions.
+// Counting is only switched on while the memory subcommand measures a call,
+// so the other subcommands of the same executable only pay for a relaxed load
+// per allocation and no read-modify-write on shared counters.
+#if defined(__GLIBC__)
+    #define BENCH_MEMORY_COUNTS 1
+#else
+    #define BENCH_MEMORY_COUNTS 0
+#endif
+
+static std::atomic< bool >      counting(false);     // whether allocations are counted
+static std::atomic< long long > alloc_count(0);     // allocations since the last reset
+static std::atomic< long long > alloc_bytes(0);     // bytes allocated since the last reset
+static std::atomic< long long > live_bytes(0);      // bytes currently allocated
+static std::atomic< long long > peak_bytes(0);      // maximum of live_bytes since the last reset
+
+#if BENCH_MEMORY_COUNTS
+
+extern "C"
+{
+    void* __libc_malloc(size_t n);
+    void* __libc_calloc(size_t n, size_t size);
+    void* __libc_realloc(void* p, size_t n);
+    void* __libc_memalign(size_t alignment, size_t n);
+    void* __libc_valloc(size_t n);
+    void* __libc_pvalloc(size_t n);
+    void  __libc_free(void* p);
+}
+
+static void count_alloc(void* p)
+{
+    if (p == nullptr || !counting.load(std::memory_order_relaxed))
+    {
+        return;
+    }
+    
+    const long long n    = static_cast< long long >(malloc_usable_size(p));
+    const long long live = live_bytes.fetch_add(n, std::memory_order_relaxed) + n;
+    
+    alloc_count.fetch_add(1, std::memory_order_relaxed);
+    alloc_bytes.fetch_add(n, std::memory_order_relaxed);
+    
+    long long peak = peak_bytes.load(std::memory_order_relaxed);
+    while (live > peak && !peak_bytes.compare_exchange_weak(peak, live, std::memory_order_relaxed));
+}
+
+static void count_free(void* p)
+{
+    if (p != nullptr && counting.load(std::memory_order_relaxed))
+    {
+        live_bytes.fetch_sub(static_cast< long long >(malloc_usable_size(p)), std::memory_order_relaxed);
+    }
+}
+
+extern "C"
+{
+    void* malloc(size_t n)
+    {
+        void* p = __libc_malloc(n);
+        count_alloc(p);
+        
+        return p;
+    }
+    
+    void* calloc(size_t n, size_t size)
+    {
+        void* p = __libc_calloc(n, size);
+        count_alloc(p);
+        
+        return p;
+    }
+    
+    // a reallocation counts as a new allocation of the whole block. If it
+    // fails the old block is left untouched and nothing is counted.
+    void* realloc(void* p, size_t n)
+    {
+        const long long old = (p != nullptr && counting.load(std::memory_order_relaxed) ? static_cast< long long >(malloc_usable_size(p)) : 0);
+        
+        void* q = __libc_realloc(p, n);
+        
+        if (q == nullptr && n != 0)
+        {
+            return q;
+        }
+        
+        live_bytes.fetch_sub(old, std::memory_order_relaxed);
+        count_alloc(q);
+        
+        return q;
+    }
+    
+    void* reallocarray(void* p, size_t n, size_t size)
+    {
+        if (size != 0 && n > static_cast< size_t >(-1) / size)
+        {
+            errno = ENOMEM;
+            return nullptr;
+        }
+        
+        return realloc(p, n * size);
+    }
+    
+    void* memalign(size_t alignment, size_t n)
+    {
+        void* p = __libc_memalign(alignment, n);
+        count_alloc(p);
+        
+        return p;
+    }
+    
+    void* aligned_alloc(size_t alignment, size_t n)
+    {
+        return memalign(alignment, n);
+    }
+    
+    int posix_memalign(void** p, size_t alignment, size_t n)
+    {
+        if (alignment % sizeof(void*) != 0 || (alignment & (alignment - 1)) != 0)
+        {
+            return EINVAL;
+        }
+        
+        *p = memalign(alignment, n);
+        return (*p == nullptr ? ENOMEM : 0);
+    }
+    
+    void* valloc(size_t n)
+    {
+        void* p = __libc_valloc(n);
+        count_alloc(p);
+        
+        return p;
+    }
+    
+    void* pvalloc(size_t n)
+    {
+        void* p = __libc_pvalloc(n);
+        count_alloc(p);
+        
+        return p;
+    }
+    
+    void free(void* p)
+    {
+        count_free(p);
+        __libc_free(p);
+    }
+}
+
+#endif
+
+/*- Resident set size -*/
+// VmHWM or VmRSS of the process in bytes, -1 if not available
+static double rss(const char* key)
+{
+    FILE* fp = fopen("/proc/self/status", "r");
+    if (fp == nullptr)
+    {
+        return -1;
+    }
+    
+    double kb = -1;
+    char   line[256];
+    
+    while (fgets(line, sizeof(line), fp) != nullptr)
+    {
+        if (strncmp(line, key, strlen(key)) == 0)
+        {
+            sscanf(line + strlen(key), ": %lf", &kb);
+        }
+    }
+    
+    fclose(fp);
+    return 1024 * kb;
+}
+
+// sets the high water mark of the resident set to its current size. Only
+// possible on Linux, otherwise the peak of the whole process is reported.
+static bool reset_rss_peak()
+{
+    FILE* fp = fopen("/proc/self/clear_refs", "w");
+    if (fp == nullptr)
+    {
+        return false;
+    }
+    
+    const bool ok = (fputs("5", fp) >= 0);
+    return (fclose(fp) == 0 && ok);
+}
+
+/*!
+ * @brief       Memory usage of one transform call
+ */
+struct memory_usage
+{
+    double allocations;     //!< Number of allocations
+    double allocated;       //!< Bytes allocated in total
+    double heap_peak;       //!< Peak of the heap above the heap before the call
+    double rss_peak;        //!< Peak resident set size of the process
+    double rss_growth;      //!< Peak resident set size above the one before the call
+    bool   rss_reset;       //!< Whether the peak resident set size could be reset
+};
+
+// the usage of one call of f
+template< typename F >
+static memory_usage measure(F f)
+{
+    memory_usage u;
+
+#if defined(__GLIBC__)
+    // return the memory freed by previous calls to the system, so the
+    // growth of the resident set is caused by this call
+    malloc_trim(0);
+#endif
+
+    u.rss_reset = reset_rss_peak();
+    
+    const double rss_before = rss("VmRSS");
+    const long long live    = live_bytes.load();
+    
+    alloc_count = 0;
+    alloc_bytes = 0;
+    peak_bytes  = live;
+    
+    counting = true;
+    f();
+    counting = false;
+    
+    u.allocations = static_cast< double >(alloc_count.load());
+    u.allocated   = static_cast< double >(alloc_bytes.load());
+    u.heap_peak   = static_cast< double >(peak_bytes.load() - live);
+    u.rss_peak    = rss("VmHWM");
+    u.rss_growth  = u.rss_peak - rss_before;
+    
+    return u;
+}
+
+int bench_memory(const bench_spec& spec, bench_json& json)
+{
+    if (std::find(spec.precisions.begin(), spec.precisions.end(), "double") == spec.precisions.end())
+    {
+        fprintf(stderr, "memory: the transforms are only available in double precision.\n");
+        return 1;
+    }
+    
+    if (!BENCH_MEMORY_COUNTS)
+    {
+        fprintf(stderr, "memory: counting allocations needs the GNU C library, only the resident set size is reported.\n");
+    }
+    
+    for (size_t b = 0; b < spec.bandwidths.size(); ++b)
+    {
+        const int bandwidth = spec.bandwidths[b];
+        
+        grid3D< complex< double > > sample(2 * bandwidth);
+        DSOFTFourierCoefficients    coef(bandwidth);
+        DSOFTFourierCoefficients    rec_coef(bandwidth);
+        
+        // generate random coefficients between -1 and 1
+        uniform_real_distribution< double > ctx;
+        ctx.engine = random_engine::MERSENNE_TWISTER64;
+        ctx.min    = -1;
+        ctx.max    = +1;
+        
+        rand(coef, ctx);
+        IDSOFT(coef, sample);
+        
+        // size of the data the transforms work on
+        const double grid_bytes = static_cast< double >(8 * bandwidth) * bandwidth * bandwidth * sizeof(complex< double >);
+        const double coef_bytes = static_cast< double >(bandwidth) * (4 * bandwidth * bandwidth - 1) / 3 * sizeof(complex< double >);
+        
+        for (size_t t = 0; t < spec.threads.size(); ++t)
+        {
+            const int threads = spec.threads[t];
+            
+            for (int forward = 1; forward >= 0; --forward)
+            {
+                const char* command = (forward ? "forward" : "inverse");
+                
+                std::vector< double > allocations, allocated, heap_peak, rss_peak, rss_growth;
+                bool                  rss_reset = true;
+                
+                for (int i = 0; i < spec.warmup + spec.runs; ++i)
+                {
+                    const memory_usage u = (forward ? measure([&]() { DSOFT(sample, rec_coef, threads); })
+                                                    : measure([&]() { IDSOFT(coef, sample, threads);    }));
+                    
+                    if (i >= spec.warmup)
+                    {
+                        allocations.push_back(u.allocations);
+                        allocated.push_back(u.allocated);
+                        heap_peak.push_back(u.heap_peak);
+                        rss_peak.push_back(u.rss_peak);
+                        rss_growth.push_back(u.rss_growth);
+                        
+                        rss_reset = rss_reset && u.rss_reset;
+                    }
+                }
+                
+                json.begin_object();
+                json.value("command",     "memory");
+                json.value("transform",   command);
+                json.value("bandwidth",   bandwidth);
+                json.value("threads",     threads);
+                json.value("precision",   "double");
+                json.value("metric",      "bytes");
+                json.value("grid_bytes",  grid_bytes);
+                json.value("coef_bytes",  coef_bytes);
+                json.value("counted",     BENCH_MEMORY_COUNTS);
+                json.value("rss_reset",   rss_reset ? 1 : 0);
+                json.summary("allocations", allocations);
+                json.summary("allocated",   allocated);
+                json.summary("heap_peak",   heap_peak);
+                json.summary("rss_peak",    rss_peak);
+                json.summary("rss_growth",  rss_growth);
+                json.end_object();
+                
+                const bench_summary h = bench_summarize(heap_peak);
+                const bench_summary a = bench_summarize(allocated);
+                const bench_summary n = bench_summarize(allocations);
+                const bench_summary r = bench_summarize(rss_peak);
+                
+                fprintf(stderr, "| memory %-7s | B %4d | T %3d | %9.0f allocs | %10.3f MiB allocated | heap peak %10.3f MiB (%5.2f x grid) | rss peak %10.3f MiB |\n",
+                        command, bandwidth, threads, n.median, a.median / (1 << 20), h.median / (1 << 20), h.median / grid_bytes, r.median / (1 << 20));
+            }
+        }
+    }
+    
+    return 0;
+}
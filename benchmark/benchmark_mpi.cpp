@@ -0,0 +1,197 @@
+//
+//  benchmark_mpi.cpp
+//  PFSOFTlib
+//
+//   Created by Denis-Michael Lux on 05. November 2015.
+//
+//   This file is part of PFSOFTlib.
+//
+//   PFSOFTlib is free software: you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License as published by
+//   the Free Software Foundation, either version 3 of the License, or
+//   (at your option) any later version.
+//
+//   PFSOFTlib is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with PFSOFTlib.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <algorithm>
+
+#include "benchmark_pfsoft.hpp"
+
+using namespace pfsoft;
+using namespace FourierTransforms;
+
+/*- Strong scaling -*/
+// appends the record of one direction and number of ranks. Only rank 0
+// writes, the samples are the ones of the slowest rank per run.
+static void record(bench_json& json, const char* command, const int& bandwidth, const int& ranks, const int& threads, const std::string& layout, const std::vector< double >& samples, const double& error, const double& serial)
+{
+    json.begin_object();
+    json.value("command",   command);
+    json.value("bandwidth", bandwidth);
+    json.value("ranks",     ranks);
+    json.value("threads",   threads);
+    json.value("precision", "double");
+    json.value("layout",    layout.c_str());
+    json.value("metric",    "seconds");
+    json.value("samples",   samples);
+    json.summary("summary", samples);
+    json.value("max_error", error);
+    
+    const double median = bench_summarize(samples).median;
+    
+    if (serial > 0 && median > 0)
+    {
+        json.value("speedup",    serial / median);
+        json.value("efficiency", serial / median / ranks);
+    }
+    
+    json.end_object();
+    
+    const bench_summary s = bench_summarize(samples);
+    fprintf(stderr, "| %-12s | B %4d | R %3d | T %3d | %-4s | median %e s | p10 %e | p90 %e |\n", command, bandwidth, ranks, threads, layout.c_str(), s.median, s.p10, s.p90);
+}
+
+// times IDSOFT_mpi and DSOFT_mpi for all bandwidths, threads per rank and
+// numbers of ranks of the sweep. Every number of ranks p runs on the first
+// p ranks of MPI_COMM_WORLD, the others wait. The speedup and the parallel
+// efficiency are the ones of the median against a single rank.
+int bench_mpi(const bench_spec& spec, bench_json& json)
+{
+    int rank, size;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+    
+    if (spec.layout != "slab" && spec.layout != "root")
+    {
+        if (rank == 0) { fprintf(stderr, "mpi: unknown layout '%s'.\n", spec.layout.c_str()); }
+        return 1;
+    }
+    
+    // slab decomposition or the grid on rank 0 with distributed DWT
+    const bool root = (spec.layout == "root");
+    
+    // all numbers of ranks up to the size of MPI_COMM_WORLD by default
+    std::vector< int > ranks = spec.ranks;
+    if (ranks.empty())
+    {
+        for (int p = 1; p <= size; ++p) { ranks.push_back(p); }
+    }
+    
+    if (ranks.back() > size)
+    {
+        if (rank == 0) { fprintf(stderr, "mpi: %d ranks requested but only %d started.\n", ranks.back(), size); }
+        return 1;
+    }
+    
+    // one communicator per number of ranks, rank 0 is part of all of them
+    std::vector< MPI_Comm > comms(ranks.size());
+    for (size_t r = 0; r < ranks.size(); ++r)
+    {
+        MPI_Comm_split(MPI_COMM_WORLD, rank < ranks[r] ? 0 : MPI_UNDEFINED, rank, &comms[r]);
+    }
+    
+    for (size_t b = 0; b < spec.bandwidths.size(); ++b)
+    {
+        const int bandwidth = spec.bandwidths[b];
+        
+        DSOFTFourierCoefficients coef(bandwidth);
+        DSOFTFourierCoefficients rec_coef(bandwidth);
+        
+        // generate random coefficients between -1 and 1 on rank 0
+        if (rank == 0)
+        {
+            uniform_real_distribution< double > ctx;
+            ctx.engine = random_engine::MERSENNE_TWISTER64;
+            ctx.min    = -1;
+            ctx.max    = +1;
+            
+            rand(coef, ctx);
+        }
+        
+        for (size_t t = 0; t < spec.threads.size(); ++t)
+        {
+            const int threads = spec.threads[t];
+            
+            // medians of a single rank or 0 if not measured yet
+            double serial_fwd = 0, serial_inv = 0;
+            
+            for (size_t r = 0; r < ranks.size(); ++r)
+            {
+                const int p = ranks[r];
+                
+                if (comms[r] == MPI_COMM_NULL)
+                {
+                    continue;
+                }
+                
+                int first, count;
+                DSOFT_mpi_layers(bandwidth, rank, p, first, count);
+                
+                // the layers of this rank, or the whole grid on rank 0
+                const int n = (root && rank > 0 ? 2 : 2 * bandwidth);
+                grid3D< complex< double > > slab(n, n, root ? n : count);
+                
+                std::vector< double > fwd, inv;
+                
+                for (int i = 0; i < spec.warmup + spec.runs; ++i)
+                {
+                    MPI_Barrier(comms[r]);
+                    
+                    double start = MPI_Wtime();
+                    if (root) { IDSOFT_mpi(coef, slab, comms[r], threads);            }
+                    else      { IDSOFT_mpi(coef, bandwidth, slab, comms[r], threads); }
+                    const double t_inv = MPI_Wtime() - start;
+                    
+                    MPI_Barrier(comms[r]);
+                    
+                    start = MPI_Wtime();
+                    if (root) { DSOFT_mpi(slab, rec_coef, comms[r], threads);            }
+                    else      { DSOFT_mpi(slab, bandwidth, rec_coef, comms[r], threads); }
+                    const double t_fwd = MPI_Wtime() - start;
+                    
+                    if (i >= spec.warmup)
+                    {
+                        fwd.push_back(t_fwd);
+                        inv.push_back(t_inv);
+                    }
+                }
+                
+                // the slowest rank determines the runtime of a run
+                std::vector< double > slowest_fwd(fwd.size()), slowest_inv(inv.size());
+                MPI_Reduce(fwd.data(), slowest_fwd.data(), spec.runs, MPI_DOUBLE, MPI_MAX, 0, comms[r]);
+                MPI_Reduce(inv.data(), slowest_inv.data(), spec.runs, MPI_DOUBLE, MPI_MAX, 0, comms[r]);
+                
+                if (rank == 0)
+                {
+                    const double error = bench_max_error(coef, rec_coef);
+                    
+                    const double median_fwd = bench_summarize(slowest_fwd).median;
+                    const double median_inv = bench_summarize(slowest_inv).median;
+                    
+                    serial_fwd = (p == 1 ? median_fwd : serial_fwd);
+                    serial_inv = (p == 1 ? median_inv : serial_inv);
+                    
+                    record(json, "mpi_forward", bandwidth, p, threads, spec.layout, slowest_fwd, error, serial_fwd);
+                    record(json, "mpi_inverse", bandwidth, p, threads, spec.layout, slowest_inv, error, serial_inv);
+                }
+            }
+        }
+    }
+    
+    for (size_t r = 0; r < comms.size(); ++r)
+    {
+        if (comms[r] != MPI_COMM_NULL)
+        {
+            MPI_Comm_free(&comms[r]);
+        }
+    }
+    
+    return 0;
+}
@@ -0,0 +1,803 @@
+//
+//  benchmark_pfsoft.cpp
+//  PFSOFTlib
+//
+//   Created by Denis-Michael Lux on 05. November 2015.
+//
+//   This file is part of PFSOFTlib.
+//
+//   PFSOFTlib is free software: you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License as published by
+//   the Free Software Foundation, either version 3 of the License, or
+//   (at your option) any later version.
+//
+//   PFSOFTlib is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with PFSOFTlib.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <sys/utsname.h>
+#include <string.h>
+#include <time.h>
+#include <algorithm>
+#include <climits>
+
+#include "benchmark_pfsoft.hpp"
+
+using namespace pfsoft;
+using namespace FourierTransforms;
+
+/*- Statistics -*/
+// percentile with linear interpolation between the sorted samples
+double bench_percentile(const std::vector< double >& sorted, const double& p)
+{
+    if (sorted.empty())
+    {
+        return 0;
+    }
+    
+    const double pos  = p * (sorted.size() - 1);
+    const size_t low  = static_cast< size_t >(pos);
+    const size_t high = std::min(low + 1, sorted.size() - 1);
+    
+    return sorted[low] + (pos - low) * (sorted[high] - sorted[low]);
+}
+
+bench_summary bench_summarize(const std::vector< double >& samples)
+{
+    std::vector< double > sorted(samples);
+    std::sort(sorted.begin(), sorted.end());
+    
+    bench_summary s;
+    memset(&s, 0, sizeof(s));
+    
+    if (sorted.empty())
+    {
+        return s;
+    }
+    
+    for (size_t i = 0; i < sorted.size(); ++i)
+    {
+        s.mean += sorted[i] / sorted.size();
+    }
+    
+    for (size_t i = 0; i < sorted.size(); ++i)
+    {
+        s.stddev += (sorted[i] - s.mean) * (sorted[i] - s.mean);
+    }
+    
+    s.stddev = (sorted.size() > 1 ? sqrt(s.stddev / (sorted.size() - 1)) : 0);
+    s.min    = sorted.front();
+    s.max    = sorted.back();
+    s.median = bench_percentile(sorted, 0.5);
+    s.p10    = bench_percentile(sorted, 0.1);
+    s.p90    = bench_percentile(sorted, 0.9);
+    s.p99    = bench_percentile(sorted, 0.99);
+    
+    return s;
+}
+
+/*- JSON writer -*/
+bench_json::bench_json(FILE* out)
+    : fp(out)
+    , first(1, true)
+{}
+
+void bench_json::separate(const char* key)
+{
+    if (!first.back())
+    {
+        fprintf(fp, ",");
+    }
+    
+    fprintf(fp, "\n%*s", static_cast< int >(2 * (first.size() - 1)), "");
+    first.back() = false;
+    
+    if (key != nullptr)
+    {
+        fprintf(fp, "\"%s\": ", key);
+    }
+}
+
+void bench_json::begin_object(const char* key)
+{
+    if (first.size() > 1) { separate(key); }
+    
+    fprintf(fp, "{");
+    first.push_back(true);
+}
+
+void bench_json::end_object()
+{
+    first.pop_back();
+    fprintf(fp, "\n%*s}", static_cast< int >(2 * (first.size() - 1)), "");
+    
+    if (first.size() == 1) { fprintf(fp, "\n"); }
+}
+
+void bench_json::begin_array(const char* key)
+{
+    separate(key);
+    
+    fprintf(fp, "[");
+    first.push_back(true);
+}
+
+void bench_json::end_array()
+{
+    first.pop_back();
+    fprintf(fp, "\n%*s]", static_cast< int >(2 * (first.size() - 1)), "");
+}
+
+void bench_json::value(const char* key, const double& v)
+{
+    separate(key);
+    
+    // JSON has no infinities or NaN
+    if (std::isfinite(v)) { fprintf(fp, "%.9g", v); }
+    else                  { fprintf(fp, "null");    }
+}
+
+void bench_json::value(const char* key, const int& v)
+{
+    separate(key);
+    fprintf(fp, "%d", v);
+}
+
+void bench_json::value(const char* key, const char* v)
+{
+    separate(key);
+    
+    fprintf(fp, "\"");
+    for (const char* c = v; *c != '\0'; ++c)
+    {
+        if      (*c == '"' || *c == '\\')                  { fprintf(fp, "\\%c", *c);                          }
+        else if (static_cast< unsigned char >(*c) < 0x20)  { fprintf(fp, "\\u%04x", static_cast< int >(*c)); }
+        else                                               { fputc(*c, fp);                                    }
+    }
+    fprintf(fp, "\"");
+}
+
+void bench_json::value(const char* key, const std::vector< double >& v)
+{
+    separate(key);
+    
+    fprintf(fp, "[");
+    for (size_t i = 0; i < v.size(); ++i)
+    {
+        fprintf(fp, "%s%.9g", i > 0 ? ", " : "", v[i]);
+    }
+    fprintf(fp, "]");
+}
+
+void bench_json::summary(const char* key, const std::vector< double >& samples)
+{
+    const bench_summary s = bench_summarize(samples);
+    
+    begin_object(key);
+    value("min",    s.min);
+    value("p10",    s.p10);
+    value("median", s.median);
+    value("mean",   s.mean);
+    value("p90",    s.p90);
+    value("p99",    s.p99);
+    value("max",    s.max);
+    value("stddev", s.stddev);
+    end_object();
+}
+
+/*- Machine metadata -*/
+// first value of a "key : value" line of a file in /proc
+static std::string proc_value(const char* path, const char* key)
+{
+    std::string result;
+    
+    FILE* fp = fopen(path, "r");
+    if (fp == nullptr)
+    {
+        return result;
+    }
+    
+    char line[512];
+    while (result.empty() && fgets(line, sizeof(line), fp) != nullptr)
+    {
+        const char* colon = strchr(line, ':');
+        if (strncmp(line, key, strlen(key)) == 0 && colon != nullptr)
+        {
+            result = colon + 1;
+            result.erase(0, result.find_first_not_of(" \t"));
+            result.erase(result.find_last_not_of(" \t\n") + 1);
+        }
+    }
+    
+    fclose(fp);
+    return result;
+}
+
+void bench_machine(bench_json& json)
+{
+    char host[256] = "unknown";
+    gethostname(host, sizeof(host) - 1);
+    
+    struct utsname un;
+    uname(&un);
+    
+    char stamp[32];
+    time_t now = time(nullptr);
+    strftime(stamp, sizeof(stamp), "%Y-%m-%dT%H:%M:%SZ", gmtime(&now));
+    
+    char version[32];
+    snprintf(version, sizeof(version), "%d.%d.%d", PFSOFT_MAJOR, PFSOFT_MINOR, PFSOFT_PATCH);
+    
+    json.begin_object("machine");
+    json.value("timestamp",     stamp);
+    json.value("hostname",      host);
+    json.value("system",        un.sysname);
+    json.value("release",       un.release);
+    json.value("arch",          PFSOFT_PROJECT_ARCH);
+    json.value("cpu",           proc_value("/proc/cpuinfo", "model name").c_str());
+    json.value("cores",         static_cast< int >(sysconf(_SC_NPROCESSORS_ONLN)));
+    json.value("memory",        proc_value("/proc/meminfo", "MemTotal").c_str());
+    json.value("compiler",      __VERSION__);
+    json.value("max_threads",   PFSOFT_MAX_THREADS);
+    json.value("pfsoft",        version);
+    json.value("dsoft_threshold", DSOFT_threshold());
+    json.value("simd",          SIMD::variant());
+    json.end_object();
+}
+
+/*- Transform benchmarks -*/
+double bench_max_error(const DSOFTFourierCoefficients& a, const DSOFTFourierCoefficients& b)
+{
+    double e = 0;
+    for (int l = 0; l < a.bandwidth; ++l)
+    {
+        for (int M = -l; M <= l; ++M)
+        {
+            for (int Mp = -l; Mp <= l; ++Mp)
+            {
+                e = std::max(e, std::abs(a(l, M, Mp).re - b(l, M, Mp).re));
+                e = std::max(e, std::abs(a(l, M, Mp).im - b(l, M, Mp).im));
+            }
+        }
+    }
+    
+    return e;
+}
+
+static void print_progress(const char* command, const int& bandwidth, const int& threads, const char* precision, const std::vector< double >& samples, const char* unit)
+{
+    const bench_summary s = bench_summarize(samples);
+    fprintf(stderr, "| %-12s | B %4d | T %3d | %-11s | median %e %s | p10 %e | p90 %e |\n", command, bandwidth, threads, precision, s.median, unit, s.p10, s.p90);
+}
+
+// times DSOFT or IDSOFT for all bandwidths and threads. The precision is
+// the one of the DWT. It defaults to the long double DWT the library runs
+// without a profile, the double one is only measured if requested. The
+// max_error of every record guards the double one. Once a single thread
+// was measured, the records of the bandwidth carry the speedup and the
+// parallel efficiency of their median against it.
+static int bench_transform(const bench_spec& spec, bench_json& json, const bool& forward)
+{
+    const char* command = (forward ? "forward" : "inverse");
+    
+    for (size_t p = 0; p < spec.precisions.size(); ++p)
+    {
+        const std::string& precision = spec.precisions[p];
+        
+        if (precision != "double" && precision != "long_double")
+        {
+            fprintf(stderr, "%s: the DWT is not available in precision '%s'.\n", command, precision.c_str());
+            continue;
+        }
+        
+        DSOFT_set_double_dwt(precision == "double" ? INT_MAX : 0);
+        
+        for (size_t b = 0; b < spec.bandwidths.size(); ++b)
+        {
+            const int bandwidth = spec.bandwidths[b];
+            
+            grid3D< complex< double > > sample(2 * bandwidth);
+            DSOFTFourierCoefficients    coef(bandwidth);
+            DSOFTFourierCoefficients    rec_coef(bandwidth);
+            
+            // generate random coefficients between -1 and 1
+            uniform_real_distribution< double > ctx;
+            ctx.engine = random_engine::MERSENNE_TWISTER64;
+            ctx.min    = -1;
+            ctx.max    = +1;
+            
+            rand(coef, ctx);
+            IDSOFT(coef, sample);
+            
+            // median of the single thread runs or 0 if not measured yet
+            double serial = 0;
+            
+            for (size_t t = 0; t < spec.threads.size(); ++t)
+            {
+                const int threads = spec.threads[t];
+                
+                // samples of the total time and of every stage
+                DSOFTStats stats;
+                
+                std::vector< double > samples, loops, busy, ipc;
+                std::vector< std::vector< double > > stages(DSOFTStats::STAGES);
+                std::vector< std::vector< double > > counts(perf_counters::EVENTS);
+                
+                // hardware counters of all threads the transforms run on
+                perf_counters counters(spec.counters, spec.counters ? threads : 1);
+                
+                for (int i = 0; i < spec.warmup + spec.runs; ++i)
+                {
+                    if (spec.counters) { counters.start(); }
+                    
+                    if (forward) { DSOFT(sample, rec_coef, stats, threads);  }
+                    else         { IDSOFT(coef, sample, stats, threads);     }
+                    
+                    if (spec.counters) { counters.stop();  }
+                    
+                    if (i >= spec.warmup)
+                    {
+                        samples.push_back(stats.total);
+                        loops.push_back(stats.loops);
+                        ipc.push_back(counters.ipc());
+                        
+                        for (int e = 0; e < perf_counters::EVENTS; ++e)
+                        {
+                            counts[e].push_back(static_cast< double >(counters.value(static_cast< perf_counters::event >(e))));
+                        }
+                        
+                        for (int s = 0; s < DSOFTStats::STAGES; ++s)
+                        {
+                            stages[s].push_back(stats.time[s]);
+                        }
+                    }
+                }
+                
+                // accuracy of the round trip
+                if (!forward)
+                {
+                    DSOFT(sample, rec_coef, threads);
+                }
+                
+                json.begin_object();
+                json.value("command",   command);
+                json.value("bandwidth", bandwidth);
+                json.value("threads",   threads);
+                json.value("precision", precision.c_str());
+                json.value("metric",    "seconds");
+                json.value("samples",   samples);
+                json.summary("summary", samples);
+                json.value("max_error", bench_max_error(coef, rec_coef));
+                
+                const double median = bench_summarize(samples).median;
+                serial              = (threads == 1 ? median : serial);
+                
+                if (serial > 0 && median > 0)
+                {
+                    json.value("speedup",    serial / median);
+                    json.value("efficiency", serial / median / threads);
+                }
+                
+                // breakdown of the stages, the busy times are the ones of the last run
+                json.begin_object("stages");
+                json.value("enabled", stats.enabled ? 1 : 0);
+                
+                for (int s = 0; s < DSOFTStats::STAGES; ++s)
+                {
+                    json.summary(DSOFTStats::name(s), stages[s]);
+                }
+                
+                json.summary("loops", loops);
+                
+                busy.assign(stats.busy.begin(), stats.busy.end());
+                json.value("busy", busy);
+                json.end_object();
+                
+                // counters summed over the threads, -1 if not available. The flops
+                // of a long double DWT are not counted, see perf_counters
+                if (spec.counters)
+                {
+                    json.begin_object("counters");
+                    
+                    for (int e = 0; e < perf_counters::EVENTS; ++e)
+                    {
+                        json.summary(perf_counters::name(e), counts[e]);
+                    }
+                    
+                    json.summary("ipc", ipc);
+                    json.end_object();
+                }
+                
+                json.end_object();
+                
+                print_progress(command, bandwidth, threads, precision.c_str(), samples, "s");
+                
+                if (stats.enabled)
+                {
+                    stats.print(stderr);
+                }
+            }
+        }
+    }
+    
+    return 0;
+}
+
+int bench_forward(const bench_spec& spec, bench_json& json)
+{
+    return bench_transform(spec, json, true);
+}
+
+int bench_inverse(const bench_spec& spec, bench_json& json)
+{
+    return bench_transform(spec, json, false);
+}
+
+/*- DWT accuracy -*/
+// relative errors of the round trip through the wigner d-matrix and the
+// weighted one in precision T
+template< typename T >
+static void dwt_accuracy(const int& bandwidth, const int& M, const int& Mp, const int& runs, std::vector< double >& errors)
+{
+    const int rows = bandwidth - std::max(abs(M), abs(Mp));
+    
+    vector< T > weights(2 * bandwidth);
+    DWT::quadrature_weights(weights);
+    
+    matrix< T > dw(rows, 2 * bandwidth);
+    DWT::weighted_wigner_d_matrix(dw, bandwidth, M, Mp, weights);
+    
+    matrix< T > dt(rows, 2 * bandwidth);
+    DWT::wigner_d_matrix(dt, bandwidth, M, Mp);
+    dt.transpose();
+    
+    std::mt19937_64                          engine(bandwidth);
+    std::uniform_real_distribution< double > uniform(-1, 1);
+    
+    for (int i = 0; i < runs; ++i)
+    {
+        // random coefficients, inverse and forward DWT
+        vector< complex< T > > fh(rows, vector< complex< T > >::COLUMN);
+        for (int j = 0; j < rows; ++j)
+        {
+            fh[j] = complex< T >(static_cast< T >(uniform(engine)), static_cast< T >(uniform(engine)));
+        }
+        
+        vector< complex< T > > s  = dt * fh;
+        vector< complex< T > > gh = dw * s;
+        
+        long double dif = 0, org = 0;
+        for (int j = 0; j < rows; ++j)
+        {
+            const long double dr = static_cast< long double >(gh[j].re) - fh[j].re;
+            const long double di = static_cast< long double >(gh[j].im) - fh[j].im;
+            
+            dif += dr * dr + di * di;
+            org += static_cast< long double >(fh[j].re) * fh[j].re + static_cast< long double >(fh[j].im) * fh[j].im;
+        }
+        
+        errors.push_back(static_cast< double >(sqrt(dif / org)));
+    }
+}
+
+int bench_dwt_accuracy(const bench_spec& spec, bench_json& json)
+{
+    for (size_t b = 0; b < spec.bandwidths.size(); ++b)
+    {
+        const int bandwidth = spec.bandwidths[b];
+        
+        // orders of the original accuracy benchmark
+        const int orders[3][2] = { { 0, 0 }, { bandwidth / 2, 0 }, { bandwidth / 2, bandwidth / 2 } };
+        
+        for (size_t p = 0; p < spec.precisions.size(); ++p)
+        {
+            const std::string& precision = spec.precisions[p];
+            
+            for (int o = 0; o < 3; ++o)
+            {
+                std::vector< double > errors;
+                
+                if      (precision == "float")       { dwt_accuracy< float >      (bandwidth, orders[o][0], orders[o][1], spec.runs, errors); }
+                else if (precision == "double")      { dwt_accuracy< double >     (bandwidth, orders[o][0], orders[o][1], spec.runs, errors); }
+                else if (precision == "long_double") { dwt_accuracy< long double >(bandwidth, orders[o][0], orders[o][1], spec.runs, errors); }
+                else
+                {
+                    fprintf(stderr, "dwt_accuracy: unknown precision '%s'.\n", precision.c_str());
+                    return 1;
+                }
+                
+                json.begin_object();
+                json.value("command",   "dwt_accuracy");
+                json.value("bandwidth", bandwidth);
+                json.value("threads",   1);
+                json.value("precision", precision.c_str());
+                json.value("M",         orders[o][0]);
+                json.value("Mp",        orders[o][1]);
+                json.value("metric",    "relative_error");
+                json.value("samples",   errors);
+                json.summary("summary", errors);
+                json.end_object();
+                
+                print_progress("dwt_accuracy", bandwidth, 1, precision.c_str(), errors, " ");
+            }
+        }
+    }
+    
+    return 0;
+}
+
+/*- Command line -*/
+// parses "a,b,c", "from:to", "from:to:step" and "from:to*factor". The
+// word max stands for the maximal number of threads.
+static bool parse_list(const char* arg, std::vector< int >& list)
+{
+    list.clear();
+    
+    std::string spec(arg);
+    size_t      start = 0;
+    
+    while (start <= spec.size())
+    {
+        size_t end = spec.find(',', start);
+        end        = (end == std::string::npos ? spec.size() : end);
+        
+        std::string item = spec.substr(start, end - start);
+        
+        // replace max by the number of threads
+        size_t m;
+        while ((m = item.find("max")) != std::string::npos)
+        {
+            item.replace(m, 3, std::to_string(PFSOFT_MAX_THREADS));
+        }
+        
+        int  from, to, step = 1;
+        char op = ':';
+        
+        const int n = sscanf(item.c_str(), "%d:%d%c%d", &from, &to, &op, &step);
+        
+        if (n == 1)
+        {
+            list.push_back(from);
+        }
+        else if (n == 2 || (n == 4 && (op == ':' || op == '*')))
+        {
+            if (from < 1 || to < from || step < 1 || (op == '*' && step < 2))
+            {
+                return false;
+            }
+            
+            for (int v = from; v <= to; v = (op == '*' ? v * step : v + step))
+            {
+                list.push_back(v);
+            }
+        }
+        else
+        {
+            return false;
+        }
+        
+        start = end + 1;
+    }
+    
+    // max may repeat a number of threads
+    std::sort(list.begin(), list.end());
+    list.erase(std::unique(list.begin(), list.end()), list.end());
+    
+    return !list.empty();
+}
+
+static void split(const char* arg, std::vector< std::string >& list)
+{
+    list.clear();
+    
+    std::string spec(arg);
+    size_t      start = 0;
+    
+    while (start <= spec.size())
+    {
+        size_t end = spec.find(',', start);
+        end        = (end == std::string::npos ? spec.size() : end);
+        
+        list.push_back(spec.substr(start, end - start));
+        start = end + 1;
+    }
+}
+
+static void usage()
+{
+    printf("usage: ./benchmark_pfsoft <COMMAND> [OPTIONS]\n");
+    printf("\n");
+    printf("commands:\n");
+    printf("  forward              runtime, speedup and round trip error of the DSOFT per DWT precision\n");
+    printf("  inverse              runtime, speedup and round trip error of the IDSOFT per DWT precision\n");
+    printf("  dwt_accuracy         relative error of the DWT round trip per precision\n");
+    printf("  kernels              runtime of the DWT and FFT building blocks against the machine peak\n");
+    printf("  memory               allocations, heap and resident set peak of DSOFT and IDSOFT\n");
+    printf("  latency              latency percentiles of many back-to-back calls and their fixed overhead\n");
+#if PFSOFT_USE_MPI
+    printf("  mpi                  strong scaling of DSOFT_mpi and IDSOFT_mpi over the ranks, run with mpirun\n");
+#endif
+    printf("\n");
+    printf("options:\n");
+    printf("  --bandwidths LIST    e.g. 8,16,32 or 8:64 or 8:64:8 or 8:512*2 (default 8:64*2)\n");
+    printf("  --threads LIST       e.g. 1,2,4 or 1:max or 1:max*2 (default max)\n");
+    printf("  --precision LIST     float,double,long_double (default long_double)\n");
+    printf("  --runs N             recorded runs per combination (default 5)\n");
+    printf("  --warmup N           unrecorded runs per combination (default 1)\n");
+    printf("  --calls N            recorded calls per combination of latency (default 10000)\n");
+#if PFSOFT_USE_MPI
+    printf("  --ranks LIST         numbers of ranks of mpi, e.g. 1,2,4 or 1:8*2 (default all)\n");
+    printf("  --layout NAME        slab or root, the data layout of mpi (default slab)\n");
+#endif
+    printf("  --output FILE        JSON report, - for stdout (default -)\n");
+    printf("  --counters           read hardware counters of the calling thread per run\n");
+    printf("  --trace FILE         Chrome trace of all runs, needs a PFSOFT_STATS build\n");
+}
+
+int main(int argc, const char** argv)
+{
+    struct { const char* name; bench_command run; } commands[] =
+    {
+        { "forward",      bench_forward      },
+        { "inverse",      bench_inverse      },
+        { "dwt_accuracy", bench_dwt_accuracy },
+        { "kernels",      bench_kernels      },
+        { "memory",       bench_memory       },
+        { "latency",      bench_latency      },
+#if PFSOFT_USE_MPI
+        { "mpi",          bench_mpi          },
+#endif
+    };
+    
+    const size_t count = sizeof(commands) / sizeof(commands[0]);
+    
+    size_t c = count;
+    for (size_t i = 0; argc > 1 && i < count; ++i)
+    {
+        c = (strcmp(argv[1], commands[i].name) == 0 ? i : c);
+    }
+    
+    if (c == count)
+    {
+        usage();
+        return 1;
+    }
+    
+    // defaults
+    bench_spec spec;
+    parse_list("8:64*2", spec.bandwidths);
+    parse_list("max", spec.threads);
+    spec.precisions.push_back("long_double");
+    spec.runs     = 5;
+    spec.warmup   = 1;
+    spec.counters = false;
+    spec.calls    = 10000;
+    spec.layout   = "slab";
+    
+    const char* output = "-";
+    const char* trace  = nullptr;
+    
+    for (int i = 2; i < argc; i += 2)
+    {
+        // options without value
+        if (strcmp(argv[i], "--counters") == 0)
+        {
+            spec.counters = true;
+            --i;
+            continue;
+        }
+        
+        const bool has = i + 1 < argc;
+        bool       ok  = has;
+        
+        if      (has && strcmp(argv[i], "--bandwidths") == 0) { ok = parse_list(argv[i + 1], spec.bandwidths);         }
+        else if (has && strcmp(argv[i], "--threads")    == 0) { ok = parse_list(argv[i + 1], spec.threads);            }
+        else if (has && strcmp(argv[i], "--precision")  == 0) { split(argv[i + 1], spec.precisions);                   }
+        else if (has && strcmp(argv[i], "--runs")       == 0) { spec.runs   = atoi(argv[i + 1]); ok = spec.runs > 0;    }
+        else if (has && strcmp(argv[i], "--warmup")     == 0) { spec.warmup = atoi(argv[i + 1]); ok = spec.warmup >= 0; }
+        else if (has && strcmp(argv[i], "--calls")      == 0) { spec.calls  = atoi(argv[i + 1]); ok = spec.calls > 0;   }
+        else if (has && strcmp(argv[i], "--ranks")      == 0) { ok = parse_list(argv[i + 1], spec.ranks);              }
+        else if (has && strcmp(argv[i], "--layout")     == 0) { spec.layout = argv[i + 1];                             }
+        else if (has && strcmp(argv[i], "--output")     == 0) { output      = argv[i + 1];                             }
+        else if (has && strcmp(argv[i], "--trace")      == 0) { trace       = argv[i + 1];                             }
+        else                                                  { ok = false;                                            }
+        
+        if (!ok)
+        {
+            fprintf(stderr, "invalid option '%s'.\n\n", argv[i]);
+            usage();
+            return 1;
+        }
+    }
+    
+    // all ranks run the subcommands, but only rank 0 writes the report
+#if PFSOFT_USE_MPI
+    int rank;
+    
+    MPI_Init(nullptr, nullptr);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    
+    if (rank > 0)
+    {
+        output = "/dev/null";
+        trace  = nullptr;
+    }
+#endif
+    
+    FILE* fp = (strcmp(output, "-") == 0 ? stdout : fopen(output, "w"));
+    if (fp == nullptr)
+    {
+        fprintf(stderr, "could not open '%s' for writing.\n", output);
+        
+#if PFSOFT_USE_MPI
+        MPI_Abort(MPI_COMM_WORLD, 1);
+#endif
+        return 1;
+    }
+    
+    // To make things fair, we run omp once for startup. This will avoid
+    // initialization time later on:
+#ifdef _OPENMP
+    int max_procs = omp_get_num_procs();
+    #pragma omp parallel for num_threads(max_procs)
+    for (int i = 0; i < max_procs; i++);
+#endif
+
+    bench_json json(fp);
+    json.begin_object();
+    json.value("command", commands[c].name);
+    
+    bench_machine(json);
+    
+    json.begin_object("spec");
+    json.value("runs",   spec.runs);
+    json.value("warmup", spec.warmup);
+    json.value("counters", spec.counters ? 1 : 0);
+    json.value("calls",    spec.calls);
+    
+    std::vector< double > list(spec.bandwidths.begin(), spec.bandwidths.end());
+    json.value("bandwidths", list);
+    
+    list.assign(spec.threads.begin(), spec.threads.end());
+    json.value("threads", list);
+    
+    json.begin_array("precisions");
+    for (size_t i = 0; i < spec.precisions.size(); ++i) { json.value(nullptr, spec.precisions[i].c_str()); }
+    json.end_array();
+    json.end_object();
+    
+    if (trace != nullptr) { DSOFTTrace::start(); }
+    
+    json.begin_array("results");
+    const int status = commands[c].run(spec, json);
+    json.end_array();
+    
+    if (trace != nullptr)
+    {
+        DSOFTTrace::stop();
+        
+        if (DSOFTTrace::write(trace))
+        {
+            fprintf(stderr, "wrote %zu events to '%s'.\n", DSOFTTrace::size(), trace);
+        }
+    }
+    
+    json.value("status", status);
+    json.end_object();
+    
+    if (fp != stdout)
+    {
+        fclose(fp);
+    }
+    
+#if PFSOFT_USE_MPI
+    MPI_Finalize();
+#endif
+    
+    return status;
+}
@@ -0,0 +1,110 @@
+//
+//  benchmark_pfsoft.hpp
+//  PFSOFTlib
+//
+//   Created by Denis-Michael Lux on 05. November 2015.
+//
+//   This file is part of PFSOFTlib.
+//
+//   PFSOFTlib is free software: you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License as published by
+//   the Free Software Foundation, either version 3 of the License, or
+//   (at your option) any later version.
+//
+//   PFSOFTlib is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with PFSOFTlib.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef PFSOFTlib_benchmark_pfsoft_hpp
+#define PFSOFTlib_benchmark_pfsoft_hpp
+
+#include <pfsoft>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+/*!
+ * @brief       The sweep of a benchmark run
+ * @details     Every subcommand runs all combinations of bandwidths, threads and
+ *              precisions it supports. Every combination is measured runs times
+ *              after warmup runs that are not recorded.
+ */
+struct bench_spec
+{
+    std::vector< int >         bandwidths;  //!< The bandwidths of the sweep
+    std::vector< int >         threads;     //!< The numbers of threads of the sweep
+    std::vector< std::string > precisions;  //!< "float", "double" or "long_double"
+    int                        runs;        //!< Recorded runs per combination
+    int                        warmup;      //!< Unrecorded runs per combination
+    bool                       counters;    //!< Whether hardware counters are read per run
+    int                        calls;       //!< Recorded calls per combination of the latency benchmark
+    std::vector< int >         ranks;       //!< The numbers of ranks of the mpi benchmark, empty for all
+    std::string                layout;      //!< "slab" or "root", the data layout of the mpi benchmark
+};
+
+/*!
+ * @brief       Summary statistics of the samples of a combination
+ */
+struct bench_summary
+{
+    double min, max, mean, stddev;          //!< Extremes, mean and standard deviation
+    double median, p10, p90, p99;           //!< Percentiles
+};
+
+bench_summary bench_summarize(const std::vector< double >& samples);
+double        bench_percentile(const std::vector< double >& sorted, const double& p);
+
+// maximal absolute difference of the parts of two coefficient sets
+double bench_max_error(const pfsoft::DSOFTFourierCoefficients& a, const pfsoft::DSOFTFourierCoefficients& b);
+
+/*!
+ * @brief       Streaming writer for the JSON report
+ * @details     Keeps track of the nesting and the separators, so the report can
+ *              be written member by member. Keys are only used inside objects.
+ */
+class bench_json
+{
+    FILE*               fp;                 //!< The output file
+    std::vector< bool > first;              //!< Whether the current scope is still empty
+    
+    void separate(const char* key);
+
+public:
+    bench_json(FILE* out);
+    
+    void begin_object(const char* key = nullptr);
+    void end_object();
+    void begin_array(const char* key = nullptr);
+    void end_array();
+    
+    void value(const char* key, const double& v);
+    void value(const char* key, const int& v);
+    void value(const char* key, const char* v);
+    void value(const char* key, const std::vector< double >& v);
+    
+    void summary(const char* key, const std::vector< double >& samples);
+};
+
+// machine metadata of the report
+void bench_machine(bench_json& json);
+
+// subcommands, they append their results to the open "results" array
+typedef int (*bench_command)(const bench_spec& spec, bench_json& json);
+
+int bench_forward(const bench_spec& spec, bench_json& json);
+int bench_inverse(const bench_spec& spec, bench_json& json);
+int bench_dwt_accuracy(const bench_spec& spec, bench_json& json);
+int bench_kernels(const bench_spec& spec, bench_json& json);
+int bench_memory(const bench_spec& spec, bench_json& json);
+int bench_latency(const bench_spec& spec, bench_json& json);
+
+#if PFSOFT_USE_MPI
+    int bench_mpi(const bench_spec& spec, bench_json& json);
+#endif
+
+#endif /* benchmark_pfsoft.hpp */
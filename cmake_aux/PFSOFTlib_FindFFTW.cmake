@@ -4,6 +4,7 @@
 #  FFTW_INCLUDE_DIR - where to find fftw3.h
 #  FFTW_LIB   		- List of libraries when using FFTW.
 #  FFTW_FOUND       - True if FFTW found.
+#  FFTWL_LIB        - The long double FFTW library if found. Optional.
 
 IF(FFTW_INCLUDES)
     # Already in cache, be silent
@@ -33,6 +34,7 @@ SET(FFTW_LIB_SEARCH_PATHS
 
 FIND_PATH(FFTW_INCLUDE_DIR fftw3.h PATHS ${FFTW_INCLUDE_SEARCH_PATHS} SHARED IMPORTED)
 FIND_LIBRARY(FFTW_LIB NAMES fftw3 PATHS ${FFTW_LIB_SEARCH_PATHS})
+FIND_LIBRARY(FFTWL_LIB NAMES fftw3l PATHS ${FFTW_LIB_SEARCH_PATHS})
 
 # handle the QUIETLY and REQUIRED arguments and set FFTW_FOUND to TRUE if
 # all listed variables are TRUE
@@ -55,6 +57,9 @@ IF (FFTW_FOUND)
 	IF (NOT FFTW_FIND_QUIETLY)
     	MESSAGE(STATUS "~> Found FFTW libraries: ${FFTW_LIB}")
 		MESSAGE(STATUS "~> Found FFTW include: ${FFTW_INCLUDE_DIR}")
+		IF (FFTWL_LIB)
+			MESSAGE(STATUS "~> Found long double FFTW library: ${FFTWL_LIB}")
+		ENDIF (FFTWL_LIB)
 	ENDIF (NOT FFTW_FIND_QUIETLY)
 ELSE (FFTW_FOUND)
 	IF (FFTW_FIND_REQUIRED)
@@ -0,0 +1,99 @@
+//
+//  binary_io.hpp
+//  PFSOFTlib
+//
+//   Created by Denis-Michael Lux on 05. November 2015.
+//
+//   This file is part of PFSOFTlib.
+//
+//   PFSOFTlib is free software: you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License as published by
+//   the Free Software Foundation, either version 3 of the License, or
+//   (at your option) any later version.
+//
+//   PFSOFTlib is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with PFSOFTlib.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef PFSOFTlib_binary_io_hpp
+#define PFSOFTlib_binary_io_hpp
+
+PFSOFT_BEGIN
+
+/*!
+ * @brief       The kinds of data a binary file can hold
+ *
+ * @since       1.0.0
+ */
+enum binary_kind
+{
+    BINARY_COEFFICIENTS = 1,    //!< DSOFTFourierCoefficients, one chunk per degree
+    BINARY_GRID         = 2     //!< grid3D, one chunk per layer
+};
+
+/*!
+ * @brief       Header of the binary files written by
+ *              DSOFTFourierCoefficients::save and grid3D::save
+ * @details     A file consists of this header, a table with one checksum per
+ *              chunk and the raw elements. The elements start at a multiple of
+ *              BINARY_ALIGNMENT bytes, so they can be mapped directly. Their
+ *              layout is the memory layout of the container, i.e. the degrees
+ *              \f$l = 0, 1, \dots\f$ one after another for coefficients and the
+ *              layers one after another for grids. Every degree or layer is a
+ *              chunk with its own checksum, therefore a prefix of the chunks can
+ *              be loaded and verified without reading the rest of the file.
+ *
+ *              All fields are stored in the byte order of the writing machine.
+ *              The byte order mark detects files of a different byte order.
+ *
+ * @since       1.0.0
+ */
+struct binary_header
+{
+    char     magic[8];      //!< "PFSOFTB" and a terminating zero
+    uint32_t byte_order;    //!< BINARY_BYTE_ORDER in the byte order of the writer
+    uint32_t version;       //!< Version of the format
+    uint32_t kind;          //!< The binary_kind of the data
+    uint32_t precision;     //!< Size in bytes of a real or imaginary part
+    uint32_t layout;        //!< Element layout, 0 for raw elements, 1 for coefficients encoded by a DSOFTCodec
+    uint32_t reserved;      //!< Zero
+    uint64_t dims[3];       //!< Bandwidth for coefficients, rows, cols and layers for grids
+    uint64_t chunks;        //!< Number of chunks
+    uint64_t data_offset;   //!< Offset of the first element from the start of the file
+    uint64_t data_bytes;    //!< Number of bytes of all elements
+    uint64_t checksum;      //!< Checksum of the header and the chunk table
+};
+
+constexpr uint32_t BINARY_VERSION    = 1;            //!< Version of the format that is written
+constexpr uint32_t BINARY_BYTE_ORDER = 0x01020304u;  //!< Byte order mark
+constexpr uint64_t BINARY_ALIGNMENT  = 4096;         //!< Alignment of the elements in bytes
+
+/*!
+ * @brief       A binary file that is mapped into memory for reading
+ *
+ * @since       1.0.0
+ */
+struct binary_file
+{
+    binary_header   header;     //!< Header of the file
+    const uint64_t* sums;       //!< Checksum per chunk
+    const char*     data;       //!< First element
+    void*           base;       //!< Start of the mapping
+    size_t          length;     //!< Length of the mapping
+};
+
+uint64_t binary_checksum(const void* data, const size_t& bytes);
+
+bool binary_write(const char* path, binary_header& header, const void* data, const size_t* chunk_bytes);
+bool binary_open (binary_file* file, const char* path, const uint32_t& kind, const uint32_t& precision);
+bool binary_check(const binary_file* file, const size_t& chunk, const size_t& offset, const size_t& bytes);
+void binary_close(binary_file* file);
+
+PFSOFT_END
+
+#endif /* binary_io.hpp */
@@ -0,0 +1,92 @@
+//
+//  dsoft_codec.hpp
+//  PFSOFTlib
+//
+//   Created by Denis-Michael Lux on 05. November 2015.
+//
+//   This file is part of PFSOFTlib.
+//
+//   PFSOFTlib is free software: you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License as published by
+//   the Free Software Foundation, either version 3 of the License, or
+//   (at your option) any later version.
+//
+//   PFSOFTlib is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with PFSOFTlib.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef PFSOFTlib_dsoft_codec_hpp
+#define PFSOFTlib_dsoft_codec_hpp
+
+PFSOFT_BEGIN
+
+/*!
+ * @ingroup     DSOFTFourierCoefficients
+ * @{
+ */
+
+/*!
+ * @brief       Lossy encoding of DSOFT Fourier coefficients for storage
+ * @details     The coefficients are encoded degree by degree. Every degree
+ *              \f$l\f$ gets the scale \f$s_l = \max|\mathrm{Re}\,\hat{f}^l_{MM'}|,
+ *              |\mathrm{Im}\,\hat{f}^l_{MM'}|\f$ and the real and imaginary
+ *              parts divided by \f$s_l\f$ are stored in one of the formats
+ *
+ *              - FIXED: signed integers of \f$b_l\in\{2,\dots,32\}\f$ bits, the
+ *                error of every part is at most \f$s_l/(2(2^{b_l-1}-1))\f$
+ *              - FLOAT16: IEEE half precision, the error of every part is at most
+ *                \f$2^{-11}s_l\f$
+ *              - BFLOAT16: bfloat16, the error of every part is at most
+ *                \f$2^{-8}s_l\f$
+ *
+ *              Since higher degrees usually carry little energy, the number of
+ *              bits of FIXED can be given per degree. If fewer entries than
+ *              degrees are given, the last entry is used for all remaining ones.
+ *
+ * @sa          DSOFT_encode
+ * @sa          DSOFTFourierCoefficients::save
+ *
+ * @since       1.0.0
+ */
+struct DSOFTCodec
+{
+    /*!
+     * @brief   The storage format of the scaled parts
+     */
+    enum format
+    {
+        FIXED    = 1,   //!< Signed integers of a given number of bits per degree
+        FLOAT16  = 2,   //!< IEEE 754 half precision
+        BFLOAT16 = 3    //!< The upper 16 bits of a single precision float
+    };
+    
+    format             type;    //!< The storage format
+    std::vector< int > bits;    //!< Bits per part and degree for FIXED
+    
+    DSOFTCodec(const format& t = FLOAT16);
+    DSOFTCodec(const std::vector< int >& bits_per_degree);
+    
+    int    bits_of(const int& l) const;
+    double error_bound(const int& l, const double& scale) const;
+};
+
+size_t DSOFT_encoded_size(const int& bandwidth, const DSOFTCodec& codec);
+size_t DSOFT_encode(const DSOFTFourierCoefficients& fc, const DSOFTCodec& codec, std::vector< unsigned char >& out, std::vector< double >* bounds = nullptr, int threads = PFSOFT_MAX_THREADS);
+bool   DSOFT_decode(const unsigned char* data, const size_t& bytes, DSOFTFourierCoefficients& fc, const int& bandlimit = 0, int threads = PFSOFT_MAX_THREADS);
+
+size_t DSOFT_encoded_degree_size(const int& l, const int& bits);
+void   DSOFT_encode_degree(const complex< double >* coef, const int& l, const DSOFTCodec& codec, unsigned char* out, double* bound = nullptr);
+bool   DSOFT_decode_degree(const unsigned char* in, const size_t& bytes, const int& l, complex< double >* coef);
+
+/*!
+ * @}
+ */
+
+PFSOFT_END
+
+#endif /* dsoft_codec.hpp */
@@ -42,6 +42,14 @@ PFSOFT_BEGIN
  *              by the DSOFT algorithm. The fourier coefficients are
  *              indexed over three parameter.
  *
+ *              All coefficients are stored in one contiguous block. The
+ *              \f$(2l+1)^2\f$ coefficients of degree \f$l\f$ start at
+ *              \f$\sum_{i<l}(2i+1)^2 = (4l^3 - l)/3\f$ and are stored column by
+ *              column over \f$M'\f$ with the orders \f$0, 1, \dots, l, -l, \dots, -1\f$.
+ *              Therefore the coefficients up to any degree are a prefix of the
+ *              block, which is also the layout of the binary files written by
+ *              save.
+ *
  * @since       0.0.1
  *
  * @author      Denis-Michael Lux <denis.lux@icloud.com>
@@ -50,8 +58,11 @@ PFSOFT_BEGIN
 struct DSOFTFourierCoefficients
 {
 private:
-    matrix< complex< double > >* mem; //!< Coefficients storage
+    complex< double >* mem;           //!< Coefficients storage
     
+    DSOFTFourierCoefficients(const DSOFTFourierCoefficients&);
+    DSOFTFourierCoefficients& operator=(const DSOFTFourierCoefficients&);
+
 public:
     // public ivars
     const int bandwidth;              //!< Bandwidth of function
@@ -67,10 +78,36 @@ public:
           complex< double >& operator()(const int& l, const int& M, const int& Mp);
     const complex< double >& operator()(const int& l, const int& M, const int& Mp) const;
     
+    bool                     save(const char* path) const;
+    bool                     save(const char* path, const DSOFTCodec& codec) const;
+    bool                     load(const char* path, const int& bandlimit = 0);
+    
+    void                     swap(DSOFTFourierCoefficients& other);
+    
+    static size_t            offset(const int& l);
+    
     // prototype for the overloaded stream operator
     friend std::ostream& operator<<(std::ostream& o, const DSOFTFourierCoefficients& fc);
 };
 
+/*!
+ * @brief       A single Fourier coefficient \f$\hat{f}^l_{M,M'}\f$ of a sparse
+ *              coefficient set.
+ * @details     Sparse coefficient sets are lists of these entries. Entries with the
+ *              same degree and orders are summed up.
+ *
+ * @sa          FourierTransforms::IDSOFT
+ *
+ * @since       1.0.0
+ */
+struct DSOFTSparseCoefficient
+{
+    int               l;        //!< Degree of the coefficient
+    int               M;        //!< First order of the coefficient
+    int               Mp;       //!< Second order of the coefficient
+    complex< double > value;    //!< Value of the coefficient
+};
+
 /*!
  * @}
  */
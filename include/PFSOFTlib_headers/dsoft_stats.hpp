@@ -0,0 +1,166 @@
+//
+//  dsoft_stats.hpp
+//  PFSOFTlib
+//
+//   Created by Denis-Michael Lux on 05. November 2015.
+//
+//   This file is part of PFSOFTlib.
+//
+//   PFSOFTlib is free software: you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License as published by
+//   the Free Software Foundation, either version 3 of the License, or
+//   (at your option) any later version.
+//
+//   PFSOFTlib is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with PFSOFTlib.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef PFSOFTlib_dsoft_stats_hpp
+#define PFSOFTlib_dsoft_stats_hpp
+
+PFSOFT_BEGIN
+
+/*!
+ * @brief       Timing breakdown of one DSOFT or IDSOFT call
+ * @details     Filled by the overloads of FourierTransforms::DSOFT,
+ *              FourierTransforms::IDSOFT and their slab-wise variants that take a
+ *              stats argument. The stage times are only recorded if the
+ *              library is built with PFSOFT_STATS, otherwise only the total wall
+ *              time is measured and the transforms do not contain any
+ *              instrumentation.
+ *
+ *              The stages are
+ *
+ *              - FFT: the layer-wise FFT2 or IFFT2 including the copy of the sample
+ *              - WIGNER: generating and rearranging the wigner d-matrices
+ *              - DWT: the matrix-vector products of the discrete wigner transforms
+ *              - SCATTER: moving values between the grid and the coefficients
+ *
+ *              The stages inside the \f$(M, M')\f$ loops run on several threads,
+ *              so their times are summed over all threads. The wall time of the
+ *              loops is given by loops and the time every thread was busy in the
+ *              loops by busy. A thread that is busy much shorter than loops
+ *              indicates a load imbalance.
+ *
+ * @sa          FourierTransforms::DSOFT
+ * @sa          FourierTransforms::IDSOFT
+ * @sa          FourierTransforms::DSOFT_stream
+ * @sa          FourierTransforms::IDSOFT_stream
+ *
+ * @since       1.0.0
+ */
+struct DSOFTStats
+{
+    /*!
+     * @brief   The instrumented stages of the transforms
+     */
+    enum stage
+    {
+        FFT     = 0,    //!< Layer-wise FFT2 or IFFT2
+        WIGNER  = 1,    //!< Wigner d-matrix generation
+        DWT     = 2,    //!< Matrix-vector products
+        SCATTER = 3,    //!< Gather and scatter of grid lines and coefficients
+        STAGES  = 4     //!< Number of stages
+    };
+    
+    bool                  enabled;          //!< Whether the stage times were recorded
+    int                   bandwidth;        //!< The bandwidth of the grid
+    int                   threads;          //!< The number of threads of the (M, M') loops
+    double                total;            //!< Wall time of the call in seconds
+    double                loops;            //!< Wall time of the (M, M') loops in seconds
+    double                time[STAGES];     //!< Seconds per stage summed over all threads
+    std::vector< double > busy;             //!< Seconds every thread worked in the (M, M') loops
+    
+    DSOFTStats();
+    
+    void        reset(const int& bw = 0, const int& nthreads = 0);
+    void        print(FILE* fp = stdout) const;
+    static const char* name(const int& s);
+};
+
+/*!
+ * @brief       Per-thread lap timer of the instrumented transforms
+ * @details     Every lap adds the time since the previous lap to a stage.
+ *              Statements without a lap of their own are accounted to the next
+ *              lap. While DSOFTTrace records, every lap and every (M, M') group
+ *              is recorded as an event as well. A timer without stats that does
+ *              not record does not read the clock at all.
+ *
+ * @since       1.0.0
+ */
+class DSOFTStatsTimer
+{
+    DSOFTStats* stats;                      //!< The stats of the call or nullptr
+    bool        trace;                      //!< Whether events are recorded
+    double      last;                       //!< Time of the last lap
+    double      time[DSOFTStats::STAGES];   //!< Accumulated seconds per stage
+    double      start;                      //!< Start time of the current group
+    int         M, Mp;                      //!< Orders of the current group or -1
+
+public:
+    DSOFTStatsTimer(DSOFTStats* s);
+    
+    static pfsoft_inline double now()
+    {
+        struct timespec ts;
+        clock_gettime(PFSOFT_STOPWATCH_CLOCK, &ts);
+        
+        return ts.tv_sec + 1e-9 * ts.tv_nsec;
+    }
+    
+    // adds the time since the previous lap to stage s
+    pfsoft_inline void lap(const DSOFTStats::stage& s)
+    {
+        if (stats != nullptr || trace)
+        {
+            const double t = now();
+            
+            if (trace) { DSOFTTrace::record(DSOFTStats::name(s), last, t); }
+            
+            time[s] += t - last;
+            last     = t;
+        }
+    }
+    
+    // the time since the previous lap is the wall time of the (M, M') loops
+    pfsoft_inline void loops()
+    {
+        if (stats != nullptr || trace)
+        {
+            const double t = now();
+            
+            if (trace)            { DSOFTTrace::record("loops", last, t); }
+            if (stats != nullptr) { stats->loops += t - last;             }
+            
+            last = t;
+        }
+    }
+    
+    void group(const int& m, const int& mp);
+    void merge(const bool& busy);
+};
+
+// Instrumentation of the transforms. Expands to nothing unless the library
+// is built with PFSOFT_STATS.
+#if PFSOFT_STATS
+    #define pfsoft_stats_timer(name, stats)     DSOFTStatsTimer name(stats)
+    #define pfsoft_stats_lap(name, s)           name.lap(DSOFTStats::s)
+    #define pfsoft_stats_loops(name)            name.loops()
+    #define pfsoft_stats_group(name, M, Mp)     name.group(M, Mp)
+    #define pfsoft_stats_merge(name, busy)      name.merge(busy)
+#else
+    #define pfsoft_stats_timer(name, stats)
+    #define pfsoft_stats_lap(name, s)
+    #define pfsoft_stats_loops(name)
+    #define pfsoft_stats_group(name, M, Mp)
+    #define pfsoft_stats_merge(name, busy)
+#endif
+
+PFSOFT_END
+
+#endif /* dsoft_stats.hpp */
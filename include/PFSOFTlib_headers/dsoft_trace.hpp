@@ -0,0 +1,81 @@
+//
+//  dsoft_trace.hpp
+//  PFSOFTlib
+//
+//   Created by Denis-Michael Lux on 05. November 2015.
+//
+//   This file is part of PFSOFTlib.
+//
+//   PFSOFTlib is free software: you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License as published by
+//   the Free Software Foundation, either version 3 of the License, or
+//   (at your option) any later version.
+//
+//   PFSOFTlib is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with PFSOFTlib.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef PFSOFTlib_dsoft_trace_hpp
+#define PFSOFTlib_dsoft_trace_hpp
+
+PFSOFT_BEGIN
+
+/*!
+ * @brief       One recorded interval of a thread
+ */
+struct DSOFTTraceEvent
+{
+    const char* name;       //!< Static name of the event
+    double      begin;      //!< Start time in seconds
+    double      end;        //!< End time in seconds
+    int         M;          //!< Order M of a (M, M') group or -1
+    int         Mp;         //!< Order M' of a (M, M') group or -1
+};
+
+/*!
+ * @brief       Timeline of the per-thread activity of the transforms
+ * @details     While recording, every thread that runs a DSOFT or IDSOFT records
+ *              the layer-wise FFT, every \f$(M, M')\f$ symmetry group and the
+ *              stages inside the groups, i.e. the generation of the wigner
+ *              d-matrices, the matrix-vector products and every gather and
+ *              scatter between grid and coefficients. The layer-wise FFT is one
+ *              event on the calling thread, and every FFT2 of a single layer is
+ *              one event on the thread that executed it.
+ *
+ *              The events are written as Chrome trace JSON, which can be opened
+ *              with chrome://tracing or https://ui.perfetto.dev to see idle gaps
+ *              and long running groups of the dynamically scheduled loops.
+ *
+ *              Recording uses the stage instrumentation of DSOFTStats and thus
+ *              requires a library built with PFSOFT_STATS. Every thread writes to
+ *              its own buffer, so recording does not synchronize the threads.
+ *              start() and stop() may be called while transforms run. size() and
+ *              write() read the buffers of all threads and must be called after
+ *              stop() once the running transforms returned.
+ *
+ * @sa          DSOFTStats
+ *
+ * @since       1.0.0
+ */
+class DSOFTTrace
+{
+    DSOFTTrace();
+
+public:
+    static void   start();
+    static void   stop();
+    static bool   recording();
+    static size_t size();
+    static bool   write(const char* path);
+    
+    static void   record(const char* name, const double& begin, const double& end, const int& M = -1, const int& Mp = -1);
+};
+
+PFSOFT_END
+
+#endif /* dsoft_trace.hpp */
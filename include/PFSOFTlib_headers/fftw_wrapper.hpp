@@ -25,11 +25,45 @@
 
 PFSOFT_BEGIN
 
+/*!
+ * @brief       Execution context for layer-wise FFT2s on a 3D grid.
+ * @details     The context holds one FFTW plan for a single layer that gets
+ *              executed on every layer of the grid through the new-array
+ *              execute interface of FFTW. Creating and destroying a context
+ *              is serialized internally since the FFTW planner is not thread
+ *              safe. Executing a context is reentrant, therefore independent
+ *              transforms can run concurrently from several threads.
+ *
+ * @since       1.0.0
+ */
+struct uzl_fftw_layer_context
+{
+    void* plan;         //!< FFTW plan for one layer
+    int   cols;         //!< Number of columns of each layer
+    int   rows;         //!< Number of rows of each layer
+    int   lays;         //!< Number of layers
+    int   sign;         //!< -1 for the forward and +1 for the backward FFT2
+    int   alignment;    //!< FFTW alignment of the array the plan was created for
+};
+
 extern "C"
 {
     /*- FFTW FUNCTIONS -*/
+    void uzl_fftw_layer_context_create  (uzl_fftw_layer_context* ctx, int cols, int rows, int lays, double* arr, int sign);
+    void uzl_fftw_layer_context_execute (const uzl_fftw_layer_context* ctx, double* arr, int threads);
+    void uzl_fftw_layer_context_destroy (uzl_fftw_layer_context* ctx);
+    int  uzl_fftw_alignment_of          (double* arr);
+    
     void uzl_fftw_layer_wise_DFT2_grid3D (int cols, int rows, int lays, double* arr, int threads);
     void uzl_fftw_layer_wise_IDFT2_grid3D(int cols, int rows, int lays, double* arr, int threads);
+    
+    void uzl_fftw_RODFT11(int n, double* arr);
+    
+#if PFSOFT_FFTWL
+    void uzl_fftwl_RODFT11(int n, long double* arr);
+#endif
+    
+    void uzl_fftw_cleanup();
 }
 
 PFSOFT_END
@@ -0,0 +1,374 @@
+//
+//  fn_dsoft_fixed.hpp
+//  PFSOFTlib
+//
+//   Created by Denis-Michael Lux on 05. November 2015.
+//
+//   This file is part of PFSOFTlib.
+//
+//   PFSOFTlib is free software: you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License as published by
+//   the Free Software Foundation, either version 3 of the License, or
+//   (at your option) any later version.
+//
+//   PFSOFTlib is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with PFSOFTlib.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef PFSOFTlib_fn_dsoft_fixed_hpp
+#define PFSOFTlib_fn_dsoft_fixed_hpp
+
+#include <memory>
+
+PFSOFT_NAMESPACE(FourierTransforms)
+
+/*!
+ * @brief       Tables of the transforms for a fixed bandwidth
+ * @details     Holds the wigner d-matrices of every order pair \f$(M, M')\f$
+ *              with \f$|M|, |M'| < B\f$ in double precision. DWT::kernel_sign,
+ *              the normalization and for the forward transform the quadrature
+ *              weights are folded into the tables. Row \f$l - J\f$ of a pair is
+ *              the row of degree \f$l\f$, its \f$2B\f$ entries belong to the
+ *              sampling angles \f$\beta_k\f$. The tables are computed in long
+ *              double by DWT::weighted_wigner_d_matrix and DWT::wigner_d_matrix
+ *              on first use and shared by all threads.
+ *
+ * @tparam      B The bandwidth
+ *
+ * @since       1.0.0
+ */
+template< int B >
+struct DSOFTFixedTables
+{
+    static const int N     = 2 * B;                     //!< Samples per axis
+    static const int PAIRS = (2 * B - 1) * (2 * B - 1); //!< Number of order pairs
+    static const int ROWS  = B * (4 * B * B - 1) / 3;   //!< Number of coefficients
+    
+    /*!
+     * @brief   An order pair \f$(M, M')\f$
+     */
+    struct pair
+    {
+        int column;                 //!< Offset of the samples of the pair in a layer
+        int first;                  //!< First table row of the pair
+        int rows;                   //!< Number of degrees \f$B - \max(|M|, |M'|)\f$
+    };
+    
+    pair   pairs[PAIRS];            //!< The order pairs
+    size_t coef[ROWS];              //!< Index of every table row in the coefficients
+    double forward[ROWS * N];       //!< Negated, weighted and normalized d-matrices
+    double inverse[ROWS * N];       //!< Negated and normalized d-matrices
+    
+    DSOFTFixedTables();
+    
+    static const DSOFTFixedTables& get()
+    {
+        static const std::unique_ptr< DSOFTFixedTables > tables(new DSOFTFixedTables);
+        return *tables;
+    }
+};
+
+template< int B >
+inline
+DSOFTFixedTables< B >::DSOFTFixedTables()
+{
+    vector< long double > weights(N);
+    DWT::quadrature_weights(weights);
+    
+    // norm factors of DSOFT and IDSOFT, the scaling of the IFFT2 is folded
+    // into the inverse one
+    const long double fwd = constants< long double >::pi / (B * N);
+    const long double inv = (B * N) / constants< long double >::pi / (4.0L * B * B);
+    
+    int p = 0, row = 0;
+    for (int M = -(B - 1); M < B; ++M)
+    {
+        for (int Mp = -(B - 1); Mp < B; ++Mp, ++p)
+        {
+            const int J = std::max(abs(M), abs(Mp));
+            
+            // the samples of (M, M') are in row M' and column M of every layer
+            pairs[p].column = (M >= 0 ? M : N + M) * N + (Mp >= 0 ? Mp : N + Mp);
+            pairs[p].first  = row;
+            pairs[p].rows   = B - J;
+            
+            matrix< long double > dw(B - J, N);
+            DWT::weighted_wigner_d_matrix(dw, B, M, Mp, weights);
+            
+            matrix< long double > d(B - J, N);
+            DWT::wigner_d_matrix(d, B, M, Mp);
+            
+            const long double sign = DWT::kernel_sign< long double >(M, Mp);
+            
+            for (int r = 0; r < B - J; ++r, ++row)
+            {
+                // column M' and row M of degree l of the coefficients
+                const int l = J + r;
+                coef[row]   = DSOFTFourierCoefficients::offset(l) + (Mp >= 0 ? Mp : 2 * l + 1 + Mp) * (2 * l + 1) + (M >= 0 ? M : 2 * l + 1 + M);
+                
+                for (int k = 0; k < N; ++k)
+                {
+                    forward[row * N + k] = static_cast< double >(sign * fwd * dw(r, k));
+                    inverse[row * N + k] = static_cast< double >(sign * inv * d(r, k));
+                }
+            }
+        }
+    }
+}
+
+/*!
+ * @brief       Per-thread scratch space of the transforms for a fixed bandwidth
+ * @details     Holds the FFT2 grid of the forward transform and the FFTW plans
+ *              of both directions. FFTW plans can only be executed on arrays
+ *              with the alignment they were created for, so there is one plan
+ *              per direction and alignment of the grids seen so far. Every
+ *              thread creates its workspace on its first transform, later
+ *              transforms do not allocate.
+ *
+ * @tparam      B The bandwidth
+ *
+ * @since       1.0.0
+ */
+template< int B >
+struct DSOFTFixedWorkspace
+{
+    static const int N = 2 * B;                     //!< Samples per axis
+    
+    std::vector< complex< double > >      grid;     //!< The layer-wise FFT2 of the sample
+    std::vector< uzl_fftw_layer_context > plans;    //!< Layer-wise FFT2 plans
+    
+    DSOFTFixedWorkspace()
+        : grid(N * N * N)
+    {}
+    
+    ~DSOFTFixedWorkspace()
+    {
+        for (size_t i = 0; i < plans.size(); ++i)
+        {
+            uzl_fftw_layer_context_destroy(&plans[i]);
+        }
+    }
+    
+    // the plan of the layer-wise FFT2 of the given direction for arr
+    const uzl_fftw_layer_context* plan(const int& sign, double* arr)
+    {
+        const int alignment = uzl_fftw_alignment_of(arr);
+        
+        for (size_t i = 0; i < plans.size(); ++i)
+        {
+            if (plans[i].sign == sign && plans[i].alignment == alignment)
+            {
+                return &plans[i];
+            }
+        }
+        
+        plans.push_back(uzl_fftw_layer_context());
+        uzl_fftw_layer_context_create(&plans.back(), N, N, N, arr, sign);
+        
+        return &plans.back();
+    }
+    
+    static DSOFTFixedWorkspace& get()
+    {
+        static thread_local std::unique_ptr< DSOFTFixedWorkspace > workspace;
+        
+        if (!workspace)
+        {
+            workspace.reset(new DSOFTFixedWorkspace);
+        }
+        
+        return *workspace;
+    }
+
+private:
+    DSOFTFixedWorkspace(const DSOFTFixedWorkspace&);
+    DSOFTFixedWorkspace& operator=(const DSOFTFixedWorkspace&);
+};
+
+/*!
+ * @brief           The DSOFT for a fixed bandwidth
+ * @details         Computes the same Fourier coefficients as FourierTransforms::DSOFT
+ *                  for a bandwidth that is known at compile time. The wigner
+ *                  d-matrices of all order pairs are precomputed tables and all
+ *                  inner loops run over \f$2B\f$ sampling angles, so the compiler
+ *                  can unroll and vectorize them. The transform runs on the
+ *                  calling thread and does not allocate memory after the first
+ *                  call of a thread, which makes it suited for many independent
+ *                  transforms of small bandwidths, e.g. one per thread.
+ *
+ *                  Unlike FourierTransforms::DSOFT the discrete wigner transforms
+ *                  run in double precision. Coefficient containers with a
+ *                  different bandwidth are passed to FourierTransforms::DSOFT.
+ *
+ * @tparam          B The bandwidth, at most 16
+ * @param[in]       input The sample grid with \f$2B\f$ samples per axis
+ * @param[out]      fc The Fourier coefficients
+ *
+ * @sa              FourierTransforms::DSOFT
+ * @sa              FourierTransforms::IDSOFT
+ *
+ * @since           1.0.0
+ */
+template< int B >
+inline
+void DSOFT(const grid3D< complex< double > >& input, DSOFTFourierCoefficients& fc)
+{
+    static_assert(B >= 1 && B <= 16, "the fixed bandwidth DSOFT is meant for bandwidths up to 16.");
+    
+    typedef DSOFTFixedTables< B >    tables_type;
+    typedef DSOFTFixedWorkspace< B > workspace_type;
+    
+    const int N = tables_type::N;
+    
+    pfsoft_cond_w(input.rows != N || input.cols != N || input.lays != N, "%s", "DSOFT<B> sample grid does not have 2B samples per axis.");
+    
+    if (input.rows != N || input.cols != N || input.lays != N)
+    {
+        return;
+    }
+    
+    if (fc.bandwidth != B)
+    {
+        DSOFT(input, fc, 1);
+        return;
+    }
+    
+    const tables_type& t  = tables_type::get();
+    workspace_type&    ws = workspace_type::get();
+    
+    // layer-wise FFT2 of a copy of the sample
+    complex< double >* grid = ws.grid.data();
+    
+    input.copy_layers(grid, 0, N);
+    uzl_fftw_layer_context_execute(ws.plan(-1, reinterpret_cast< double* >(grid)), reinterpret_cast< double* >(grid), 1);
+    
+    complex< double >* out = &fc(0, 0, 0);
+    
+    double re[N], im[N];
+    for (int p = 0; p < tables_type::PAIRS; ++p)
+    {
+        const typename tables_type::pair& q = t.pairs[p];
+        
+        // gather the samples of (M, M') over all layers
+        for (int k = 0; k < N; ++k)
+        {
+            re[k] = grid[k * N * N + q.column].re;
+            im[k] = grid[k * N * N + q.column].im;
+        }
+        
+        // one coefficient per degree
+        for (int r = q.first; r < q.first + q.rows; ++r)
+        {
+            const double* w = t.forward + r * N;
+            
+            double sr = 0, si = 0;
+            for (int k = 0; k < N; ++k)
+            {
+                sr += w[k] * re[k];
+                si += w[k] * im[k];
+            }
+            
+            out[t.coef[r]] = complex< double >(sr, si);
+        }
+    }
+}
+
+/*!
+ * @brief           The inverse DSOFT for a fixed bandwidth
+ * @details         Computes the same synthesis as FourierTransforms::IDSOFT for a
+ *                  bandwidth that is known at compile time, see the fixed
+ *                  bandwidth FourierTransforms::DSOFT. The synthesis grid is
+ *                  transformed in place. Coefficient containers with a
+ *                  different bandwidth and strided grids are passed to
+ *                  FourierTransforms::IDSOFT.
+ *
+ * @tparam          B The bandwidth, at most 16
+ * @param[in]       fc The Fourier coefficients
+ * @param[out]      synthesis The synthesis grid with \f$2B\f$ samples per axis
+ *
+ * @sa              FourierTransforms::DSOFT
+ * @sa              FourierTransforms::IDSOFT
+ *
+ * @since           1.0.0
+ */
+template< int B >
+inline
+void IDSOFT(const DSOFTFourierCoefficients& fc, grid3D< complex< double > >& synthesis)
+{
+    static_assert(B >= 1 && B <= 16, "the fixed bandwidth IDSOFT is meant for bandwidths up to 16.");
+    
+    typedef DSOFTFixedTables< B >    tables_type;
+    typedef DSOFTFixedWorkspace< B > workspace_type;
+    
+    const int N = tables_type::N;
+    
+    pfsoft_cond_w(synthesis.rows != N || synthesis.cols != N || synthesis.lays != N, "%s", "IDSOFT<B> synthesis grid does not have 2B samples per axis.");
+    
+    if (synthesis.rows != N || synthesis.cols != N || synthesis.lays != N)
+    {
+        return;
+    }
+    
+    if (fc.bandwidth != B || !synthesis.contiguous())
+    {
+        IDSOFT(fc, synthesis, 1);
+        return;
+    }
+    
+    const tables_type& t  = tables_type::get();
+    workspace_type&    ws = workspace_type::get();
+    
+    complex< double >*       grid = access::rwp(synthesis.mem);
+    const complex< double >* in   = &fc(0, 0, 0);
+    
+    double re[N], im[N];
+    for (int p = 0; p < tables_type::PAIRS; ++p)
+    {
+        const typename tables_type::pair& q = t.pairs[p];
+        
+        for (int k = 0; k < N; ++k)
+        {
+            re[k] = 0;
+            im[k] = 0;
+        }
+        
+        // sum the degrees of (M, M') for every layer
+        for (int r = q.first; r < q.first + q.rows; ++r)
+        {
+            const double*           d = t.inverse + r * N;
+            const complex< double > c = in[t.coef[r]];
+            
+            for (int k = 0; k < N; ++k)
+            {
+                re[k] += d[k] * c.re;
+                im[k] += d[k] * c.im;
+            }
+        }
+        
+        for (int k = 0; k < N; ++k)
+        {
+            grid[k * N * N + q.column] = complex< double >(re[k], im[k]);
+        }
+    }
+    
+    // The Nyquist row and column of every layer do not belong to any order
+    for (int k = 0; k < N; ++k)
+    {
+        for (int j = 0; j < N; ++j)
+        {
+            grid[k * N * N + B * N + j] = complex< double >(0, 0);
+            grid[k * N * N + j * N + B] = complex< double >(0, 0);
+        }
+    }
+    
+    uzl_fftw_layer_context_execute(ws.plan(+1, reinterpret_cast< double* >(grid)), reinterpret_cast< double* >(grid), 1);
+}
+
+PFSOFT_NAMESPACE_END
+
+#endif /* fn_dsoft_fixed.hpp */
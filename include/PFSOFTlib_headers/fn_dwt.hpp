@@ -24,7 +24,7 @@
 #define PFSOFTlib_fn_dwt_hpp
 
 PFSOFT_NAMESPACE(DWT)
-    
+
 /*- For more information/implementation details see fn_dwt.cpp file! -*/
 
 /*!
@@ -38,7 +38,10 @@ PFSOFT_NAMESPACE(DWT)
  *                      \sin\left((2j+1)(2k+1)\frac{\pi}{4B}\right)
  *              \f}
  *              where \f$B\f$ is the bandlimit that is given and \f$0\leq j\leq 2B-1\f$.
- *              The dimension of this matrix is \f$2B\times 2B\f$
+ *              The dimension of this matrix is \f$2B\times 2B\f$. The sums are
+ *              computed in the precision of T, for double and, if FFTW was found
+ *              with its long double library, for long double with a sine transform
+ *              in \f$O(B\log B)\f$.
  *
  * @param[in]   bandwidth The given bandwidth
  * @return      A vector containing the quadrature weights that can be used to compute the DWT
@@ -67,26 +70,194 @@ void_number_type< T > quadrature_weights(vector< T >& vec)
     pfsoft_cond_w_ret(vec.size & 1, "%s", "uneven vector length in DWT::quadrature_weights. ");
     
     int i, k, bandwidth = vec.size / 2;
-    for (i = 0; i < bandwidth; ++i)
+    
+    // The sums over k are a discrete sine transform of type IV of 1 / (2k + 1),
+    // which FFTW computes in O(B log B) instead of B^2 sines. The transform is
+    // used for T = double and, with the long double FFTW, for T = long double.
+    // Any other T sums directly with the std::sin overload of its own precision.
+    // For small bandwidths planning the transform costs more than the sines.
+    std::vector< pod_type > sum(bandwidth);
+    
+    if (same_type< T, double >::value && bandwidth >= 16)
+    {
+        std::vector< double > dst(bandwidth);
+        for (k = 0; k < bandwidth; ++k)
+        {
+            dst[k] = 1.0 / (2.0 * k + 1.0);
+        }
+        
+        uzl_fftw_RODFT11(bandwidth, dst.data());
+        std::copy(dst.begin(), dst.end(), sum.begin());
+    }
+#if PFSOFT_FFTWL
+    else if (same_type< T, long double >::value && bandwidth >= 16)
     {
-        pod_type wi  = 2.0 / bandwidth * sin(constants< T >::pi * (2.0 * i + 1.0)/(4.0 * bandwidth));
-        pod_type sum = 0;
+        std::vector< long double > dst(bandwidth);
         for (k = 0; k < bandwidth; ++k)
         {
-            sum += 1.0 / (2.0 * k + 1.0) * sin((2.0 * i + 1.0) * (2.0 * k + 1.0) * constants< T >::pi / (4.0 * bandwidth));
+            dst[k] = 1.0L / (2.0L * k + 1.0L);
         }
         
-        wi                        *= sum;
+        uzl_fftwl_RODFT11(bandwidth, dst.data());
+        std::copy(dst.begin(), dst.end(), sum.begin());
+    }
+#endif
+    else
+    {
+        for (i = 0; i < bandwidth; ++i)
+        {
+            pod_type s = 0;
+            for (k = 0; k < bandwidth; ++k)
+            {
+                s += pod_type(1) / (2.0 * k + 1.0) * std::sin((2.0 * i + 1.0) * (2.0 * k + 1.0) * constants< T >::pi / (4.0 * bandwidth));
+            }
+            
+            // same scaling as the FFTW transform
+            sum[i] = 2 * s;
+        }
+    }
+    
+    for (i = 0; i < bandwidth; ++i)
+    {
+        // the factor 2 / B of the weights without the scaling of the transform
+        pod_type wi  = pod_type(1) / bandwidth * std::sin(constants< T >::pi * (2.0 * i + 1.0)/(4.0 * bandwidth));
+        
+        wi                        *= sum[i];
         vec[i]                     = wi;
         vec[2 * bandwidth - 1 - i] = wi;
     }
 }
 
+/*!
+ * @brief       Sign of the DSOFT kernel relative to the wigner d-functions of
+ *              DWT::wigner_d_matrix and DWT::wigner_d_vector
+ * @details     The transforms use \f$-d^l_{MM'}\f$ as kernel. They compute the
+ *              d-functions only for the orbit representatives \f$M\geq|M'|\f$
+ *              and derive the other orders by the symmetry
+ *              \f$d^l_{M'M} = (-1)^{M-M'}d^l_{MM'}\f$. For \f$M < M'\f$ with odd
+ *              \f$M - M'\f$ the recurrence evaluated directly at \f$(M, M')\f$
+ *              has the opposite sign of this convention. Code that evaluates the
+ *              recurrence at arbitrary orders multiplies with this sign to match
+ *              the coefficients of the transforms.
+ *
+ * @param[in]   M The order \f$M\f$
+ * @param[in]   Mp The order \f$M'\f$
+ * @return      \f$+1\f$ for \f$M < M'\f$ with odd \f$M - M'\f$, \f$-1\f$ otherwise
+ *
+ * @since       1.0.0
+ */
+template< typename T >
+inline
+T kernel_sign(const int& M, const int& Mp)
+{
+    return (M < Mp && (M - Mp) & 1 ? 1 : -1);
+}
+
+/*!
+ * @brief       Base case and recurrence coefficients of the \f$L^2\f$-normalized
+ *              Wigner d-functions of the orders \f$M, M'\f$
+ * @details     Shared by DWT::wigner_d_matrix, DWT::weighted_wigner_d_matrix and
+ *              DWT::wigner_d_vector. The base case is the d-function of the lowest
+ *              degree \f$J = \max(|M|, |M'|)\f$, every further degree follows from
+ *              the three-term recurrence
+ *              \f[
+ *                  \tilde{d}^{J+i+1}_{M,M'}(\beta) = c_1\tilde{d}^{J+i-1}_{M,M'}(\beta)
+ *                      + f_1(f_2 + \cos\beta)\tilde{d}^{J+i}_{M,M'}(\beta)
+ *              \f]
+ *              with \f$\tilde{d}^{J-1}_{M,M'} = 0\f$.
+ *
+ * @since       1.0.0
+ */
+template< typename T >
+struct wigner_d_recurrence
+{
+    typedef T pod_type;
+    
+    const int M, Mp;                        //!< The orders
+    const int minJ;                         //!< The lowest degree J
+    pod_type  normFactor;                   //!< Norm of the base case
+    pod_type  sinSign;                      //!< Sign of the base case
+    pod_type  cosPower, sinPower;           //!< Powers of the cosine and sine of the half angle
+    
+    wigner_d_recurrence(const int& m, const int& mp)
+        : M(m)
+        , Mp(mp)
+        , minJ(std::max(abs(m), abs(mp)))
+    {
+        // Compute root coefficient for the base case
+        normFactor = sqrt((2.0 * minJ + 1.0)/2.0);
+        for (int i = 0 ; i < minJ - std::min(abs(M), abs(Mp)) ; ++i)
+        {
+            normFactor *= sqrt((2.0 * minJ - i) / (i + 1.0));
+        }
+        
+        // Sin sign for the recurrence base case
+        sinSign = (minJ == abs(M) && M >= 0 && (minJ - Mp) & 1 ? 1 : -1      );
+        sinSign = (minJ != abs(M) && Mp < 0 && (minJ - Mp) & 1 ? sinSign : -1);
+        
+        // Powers
+        if (minJ == abs(M) && M >= 0)
+        {
+            cosPower = minJ + Mp;
+            sinPower = minJ - Mp;
+        }
+        else if (minJ == abs(M))
+        {
+            cosPower = minJ - Mp;
+            sinPower = minJ + Mp;
+        }
+        else if (Mp >= 0)
+        {
+            cosPower = minJ + M;
+            sinPower = minJ - M;
+        }
+        else
+        {
+            cosPower = minJ - M;
+            sinPower = minJ + M;
+        }
+    }
+    
+    // the d-function of degree J from the sine and cosine of the half angle
+    pod_type base(const pod_type& sinHalfBeta, const pod_type& cosHalfBeta) const
+    {
+        return normFactor * sinSign * pow(sinHalfBeta, sinPower) * pow(cosHalfBeta, cosPower);
+    }
+    
+    // the coefficients of the step from degree J + i to J + i + 1
+    void step(const int& i, pod_type& c1, pod_type& f1, pod_type& f2) const
+    {
+        // Index for wigner function
+        pod_type idx  = minJ + i;
+        
+        // Terms in recurrence
+        pod_type norm = sqrt((2.0 * idx + 3.0) / (2.0 * idx + 1.0));
+        pod_type nom  = (idx + 1.0) * (2.0 * idx + 1.0);
+        pod_type den  = 1.0 / sqrt(((idx + 1) * (idx + 1) - M*M) * ((idx + 1) * (idx + 1) - Mp*Mp));
+        
+        // Fractions
+        c1 = 0;
+        f1 = norm * nom * den;
+        f2 = 0;
+        
+        // Correcting undefined values from division by zero
+        if (minJ + i != 0)
+        {
+            pod_type t1 = sqrt((2.0 * idx + 3.0)/(2.0 * idx - 1.0) ) * (idx + 1.0)/idx ;
+            pod_type t2 = sqrt((idx*idx - M*M) * (idx*idx - Mp*Mp));
+            
+            c1 = -t1 * t2 * den;
+            f2 = -M*Mp / (idx * (idx + 1.0));
+        }
+    }
+};
+
 /*!
  * @brief       The Wigner d-matrix where the weights are calculated onto the matrix values.
  * @details     Calculates \f$d\cdot w\f$ where \f$d\f$ is matrix containing wigner
  *              d-Function values on each entry and \f$w\f$ is diagonal matrix containing
- *              the quadrature weights on the diagonal.
+ *              the quadrature weights on the diagonal. Like DWT::wigner_d_matrix the
+ *              matrix may have fewer than \f$B - J\f$ rows for a truncated degree.
  *
  * @param[in]   bandwidth The given bandwidth.
  * @param[in]   M The order \f$M\f$ of \f$d^J_{MM'}\f$.
@@ -109,43 +280,13 @@ void_number_type< T > weighted_wigner_d_matrix(matrix< T >& wig, const int& band
     typedef T pod_type;
     
     // Definition of used indices and the matrix that will be returned
-    int i, j, minJ = std::max(abs(M), abs(Mp));
+    int i, j;
     
-    pfsoft_cond_w_ret(wig.rows != bandwidth - minJ || wig.cols != 2 * bandwidth, "%s", "dimension mismatch between input matrix and function arguments in DWT::weighted_wigner_d_matrix.");
+    // Base case and recurrence of the orders
+    const wigner_d_recurrence< T > rec(M, Mp);
+    const int                      minJ = rec.minJ;
     
-    // Compute root coefficient for the base case
-    pod_type normFactor  = sqrt((2.0 * minJ + 1.0)/2.0);
-    for (i = 0 ; i < minJ - std::min(abs(M), abs(Mp)) ; ++i)
-    {
-        normFactor *= sqrt((2.0 * minJ - i) / (i + 1.0));
-    }
-    
-    // Sin sign for the recurrence base case
-    pod_type sinSign = (minJ == abs(M) && M >= 0 && (minJ - Mp) & 1 ? 1       : -1);
-    sinSign          = (minJ != abs(M) && Mp < 0 && (minJ - Mp) & 1 ? sinSign : -1);
-    
-    // Powers
-    pod_type cosPower, sinPower;
-    if (minJ == abs(M) && M >= 0)
-    {
-        cosPower = minJ + Mp;
-        sinPower = minJ - Mp;
-    }
-    else if (minJ == abs(M))
-    {
-        cosPower = minJ - Mp;
-        sinPower = minJ + Mp;
-    }
-    else if (Mp >= 0)
-    {
-        cosPower = minJ + M;
-        sinPower = minJ - M;
-    }
-    else
-    {
-        cosPower = minJ - M;
-        sinPower = minJ + M;
-    }
+    pfsoft_cond_w_ret(wig.rows < 1 || static_cast< int >(wig.rows) > bandwidth - minJ || static_cast< int >(wig.cols) != 2 * bandwidth, "%s", "dimension mismatch between input matrix and function arguments in DWT::weighted_wigner_d_matrix.");
     
     // Base cases and filling matrix with values
     pod_type cosBeta[2 * bandwidth];
@@ -159,39 +300,25 @@ void_number_type< T > weighted_wigner_d_matrix(matrix< T >& wig, const int& band
         cosBeta[i] = cos(((2.0 * i + 1.0) * constants< T >::pi) / (4.0 * bandwidth));
         
         // Computing base wigners. filling the first row in matrix with those values
-        wig(0, i)  = normFactor * sinSign * pow(sinHalfBeta, sinPower) * pow(cosHalfBeta, cosPower) * weights[i];
+        wig(0, i)  = rec.base(sinHalfBeta, cosHalfBeta) * weights[i];
     }
     
     // Filling wigner matrix with values. Starting with second row and
-    // iterate to last row with index B - 1
-    for(i = 0 ; i < bandwidth - minJ - 1; ++i)
+    // iterate to the last row of the matrix
+    for(i = 0 ; i < static_cast< int >(wig.rows) - 1; ++i)
     {
         // Recurrence coefficients
-        pod_type c1   = 0;
+        pod_type c1, f1, f2;
+        rec.step(i, c1, f1, f2);
         
-        // Index for wigner function
-        pod_type idx  = minJ + i;
-        
-        // Terms in recurrence
-        pod_type norm = sqrt((2.0 * idx + 3.0) / (2.0 * idx + 1.0));
-        pod_type nom  = (idx + 1.0) * (2. * idx + 1.0);
-        pod_type den  = 1.0 / sqrt(((idx + 1) * (idx + 1) - M*M) * ((idx + 1) * (idx + 1) - Mp*Mp));
-        
-        // Fractions
-        pod_type f1   = norm * nom * den;
-        pod_type f2   = 0;
-        
-        // Correcting undefined values from division by zero
-        if (minJ + i != 0)
+        //  Filling matrix with next recurrence step value. Double precision
+        //  uses the dispatched kernel.
+        if ( same_type< T, double >::value )
         {
-            pod_type t1 = sqrt((2.0 * idx + 3.0)/(2.0 * idx - 1.0) ) * (idx + 1.0)/idx ;
-            pod_type t2 = sqrt((idx*idx - M*M) * (idx*idx - Mp*Mp));
-            
-            c1   = -t1 * t2 * den;
-            f2   = -M*Mp / (idx * (idx + 1.));
+            SIMD::wigner_step(reinterpret_cast< double* >(&wig(0, 0)), wig.rows, 2 * bandwidth, i, reinterpret_cast< const double* >(cosBeta), c1, f1, f2);
+            continue;
         }
         
-        //  Filling matrix with next recurrence step value
         for (j = 0; j < 2*bandwidth; ++j)
         {
             wig(i + 1, j) = c1 * (i == 0 ? 0 : wig(i - 1, j)) + wig(i, j) * f1 * (f2 + cosBeta[j]);
@@ -204,11 +331,18 @@ void_number_type< T > weighted_wigner_d_matrix(matrix< T >& wig, const int& band
  *              contains the results of the \f$L^2\f$-normalized Wigner
  *              d-function on each entry.
  * @details     The dimension of this matrix is \f$(B-J+1)\times 2B\f$ where
- *              \f$B\f$ denotes a given bandwidth.
+ *              \f$B\f$ denotes a given bandwidth. A matrix with fewer rows gets
+ *              the degrees \f$J,\dots,J + rows - 1\f$ only, which is used for
+ *              coefficients with an effective bandlimit \f$L < B\f$. The rows
+ *              are identical to the leading rows of the full matrix.
+ *              Likewise a matrix with fewer than \f$2B\f$ columns gets the
+ *              sampling angles \f$\beta_{k_0},\dots,\beta_{k_0 + cols - 1}\f$ only,
+ *              which is used to synthesize blocks of layers.
  *
  * @param[in]   bandwidth The given bandwidth
  * @param[in]   M The order \f$M\f$ for the \f$L^2\f$-normalized Wigner d-function
  * @param[in]   Mp The order \f$M'\f$ for the \f$L^2\f$-normalized Wigner d-function
+ * @param[in]   k0 The index of the sampling angle of the first column
  * @return      The resulting matrix looks as follows
  *              \f{eqnarray*}{
  *                  \begingroup
@@ -236,101 +370,113 @@ void_number_type< T > weighted_wigner_d_matrix(matrix< T >& wig, const int& band
  */
 template< typename T >
 inline
-void_number_type< T > wigner_d_matrix(matrix< T >& wig, const int& bandwidth, const int& M, const int& Mp)
+void_number_type< T > wigner_d_matrix(matrix< T >& wig, const int& bandwidth, const int& M, const int& Mp, const int& k0 = 0)
 {
     typedef T pod_type;
     
     // Definition of used indices and the matrix that will be returned
-    int i, j, minJ = std::max(abs(M), abs(Mp));
-    
-    pfsoft_cond_w_ret(wig.rows != bandwidth - minJ || wig.cols != 2 * bandwidth, "%s", "dimension mismatch between input matrix and function arguments in DWT::weighted_wigner_d_matrix.");
-    
-    // Compute root coefficient for the base case
-    pod_type normFactor  = sqrt((2.0 * minJ + 1.0)/2.0);
-    for (i = 0 ; i < minJ - std::min(abs(M), abs(Mp)) ; ++i)
-    {
-        normFactor *= sqrt((2.0 * minJ - i) / (i + 1.0));
-    }
+    int i, j;
     
-    // Sin sign for the recurrence base case
-    pod_type sinSign = (minJ == abs(M) && M >= 0 && (minJ - Mp) & 1 ? 1 : -1      );
-    sinSign          = (minJ != abs(M) && Mp < 0 && (minJ - Mp) & 1 ? sinSign : -1);
+    // Base case and recurrence of the orders
+    const wigner_d_recurrence< T > rec(M, Mp);
+    const int                      minJ = rec.minJ;
     
-    // Powers
-    pod_type cosPower, sinPower;
-    if (minJ == abs(M) && M >= 0)
-    {
-        cosPower = minJ + Mp;
-        sinPower = minJ - Mp;
-    }
-    else if (minJ == abs(M))
-    {
-        cosPower = minJ - Mp;
-        sinPower = minJ + Mp;
-    }
-    else if (Mp >= 0)
-    {
-        cosPower = minJ + M;
-        sinPower = minJ - M;
-    }
-    else
-    {
-        cosPower = minJ - M;
-        sinPower = minJ + M;
-    }
+    pfsoft_cond_w_ret(wig.rows < 1 || static_cast< int >(wig.rows) > bandwidth - minJ || wig.cols < 1 || k0 < 0 || k0 + static_cast< int >(wig.cols) > 2 * bandwidth, "%s", "dimension mismatch between input matrix and function arguments in DWT::wigner_d_matrix.");
     
-    // Base cases and filling matrix with values
-    pod_type cosBeta[2 * bandwidth];
-    for (i = 0 ; i < 2 * bandwidth; ++i)
+    // Base cases and filling matrix with values. Column i belongs to
+    // the sampling angle with index k0 + i.
+    const int cols = static_cast< int >(wig.cols);
+    pod_type cosBeta[cols];
+    for (i = 0 ; i < cols; ++i)
     {
+        // Index of the sampling angle
+        const int k = k0 + i;
+        
         // Getting sin and cos values for the power operator
-        pod_type sinHalfBeta = sin(0.5 * ((2.0 * i + 1.0) * constants< T >::pi) / (4.0 * bandwidth));
-        pod_type cosHalfBeta = cos(0.5 * ((2.0 * i + 1.0) * constants< T >::pi) / (4.0 * bandwidth));
+        pod_type sinHalfBeta = sin(0.5 * ((2.0 * k + 1.0) * constants< T >::pi) / (4.0 * bandwidth));
+        pod_type cosHalfBeta = cos(0.5 * ((2.0 * k + 1.0) * constants< T >::pi) / (4.0 * bandwidth));
         
         // Store cosine values for reuse in recurrence loop
-        cosBeta[i] = cos(((2.0 * i + 1.0) * constants< T >::pi) / (4.0 * bandwidth));
+        cosBeta[i] = cos(((2.0 * k + 1.0) * constants< T >::pi) / (4.0 * bandwidth));
         
         // Computing base wigners
-        wig(0, i)  = normFactor * sinSign * pow(sinHalfBeta, sinPower) * pow(cosHalfBeta, cosPower);
+        wig(0, i)  = rec.base(sinHalfBeta, cosHalfBeta);
     }
     
     // Filling wigner matrix with values. Starting with second row and
-    // iterate to last row with index B - 1
-    for(i = 0 ; i < bandwidth - minJ - 1; ++i)
+    // iterate to the last row of the matrix
+    for(i = 0 ; i < static_cast< int >(wig.rows) - 1; ++i)
     {
         // Recurrence coefficients
-        pod_type c1   = 0;
-        
-        // Index for wigner function
-        pod_type idx  = minJ + i;
-        
-        // Terms in recurrence
-        pod_type norm = sqrt((2.0 * idx + 3.0) / (2.0 * idx + 1.0));
-        pod_type nom  = (idx + 1.0) * (2.0 * idx + 1.0);
-        pod_type den  = 1.0 / sqrt(((idx + 1) * (idx + 1) - M*M) * ((idx + 1) * (idx + 1) - Mp*Mp));
-        
-        // Fractions
-        pod_type f1   = norm * nom * den;
-        pod_type f2   = 0;
+        pod_type c1, f1, f2;
+        rec.step(i, c1, f1, f2);
         
-        // Correcting undefined values from division by zero
-        if (minJ + i != 0)
+        //  Filling matrix with next recurrence step value. Double precision
+        //  uses the dispatched kernel.
+        if ( same_type< T, double >::value )
         {
-            T t1 = sqrt((2.0 * idx + 3.0)/(2.0 * idx - 1.0) ) * (idx + 1.0)/idx ;
-            T t2 = sqrt((idx*idx - M*M) * (idx*idx - Mp*Mp));
-            
-            c1   = -t1 * t2 * den;
-            f2   = -M*Mp / (idx * (idx + 1.0));
+            SIMD::wigner_step(reinterpret_cast< double* >(&wig(0, 0)), wig.rows, cols, i, reinterpret_cast< const double* >(cosBeta), c1, f1, f2);
+            continue;
         }
         
-        //  Filling matrix with next recurrence step value
-        for (j = 0; j < 2 * bandwidth; ++j)
+        for (j = 0; j < cols; ++j)
         {
             wig(i + 1, j) = c1 * (i == 0 ? 0 : wig(i - 1, j)) + wig(i, j) * f1 * (f2 + cosBeta[j]);
         }
     }
 }
 
+/*!
+ * @brief       Computes the \f$L^2\f$-normalized Wigner d-function of all degrees
+ *              for a single arbitrary angle \f$\beta\f$.
+ * @details     Runs the same three-term recurrence over the degree as
+ *              DWT::wigner_d_matrix, but for one angle instead of the \f$2B\f$
+ *              sampling angles \f$\beta_k\f$. The resulting vector equals a column
+ *              of the Wigner d-matrix if \f$\beta = \beta_k\f$, therefore it can be
+ *              used to evaluate a Fourier series on \f$\mathcal{SO}(3)\f$ off the
+ *              sampling grid in \f$\mathcal{O}(B)\f$ per order pair.
+ *
+ * @param[out]  wig Vector of length \f$B - J\f$ with \f$J = \max(|M|, |M'|)\f$
+ *              that is filled with \f$\tilde{d}^J_{M,M'}(\beta),\dots,\tilde{d}^{B-1}_{M,M'}(\beta)\f$
+ * @param[in]   bandwidth The given bandwidth
+ * @param[in]   M The order \f$M\f$ for the \f$L^2\f$-normalized Wigner d-function
+ * @param[in]   Mp The order \f$M'\f$ for the \f$L^2\f$-normalized Wigner d-function
+ * @param[in]   beta The angle \f$\beta\in[0,\pi]\f$
+ *
+ * @sa          DWT::wigner_d_matrix
+ *
+ * @since       1.0.0
+ */
+template< typename T >
+inline
+void_number_type< T > wigner_d_vector(vector< T >& wig, const int& bandwidth, const int& M, const int& Mp, const T& beta)
+{
+    typedef T pod_type;
+    
+    // Definition of used indices
+    int i;
+    
+    // Base case and recurrence of the orders
+    const wigner_d_recurrence< T > rec(M, Mp);
+    const int                      minJ = rec.minJ;
+    
+    pfsoft_cond_w_ret(static_cast< int >(wig.size) != bandwidth - minJ, "%s", "dimension mismatch between input vector and function arguments in DWT::wigner_d_vector.");
+    
+    // Base case
+    pod_type cosBeta = cos(beta);
+    wig[0]           = rec.base(sin(0.5 * beta), cos(0.5 * beta));
+    
+    // Recurrence over the degree up to B - 1
+    for(i = 0 ; i < bandwidth - minJ - 1; ++i)
+    {
+        // Recurrence coefficients
+        pod_type c1, f1, f2;
+        rec.step(i, c1, f1, f2);
+        
+        wig[i + 1] = c1 * (i == 0 ? 0 : wig[i - 1]) + wig[i] * f1 * (f2 + cosBeta);
+    }
+}
+
 PFSOFT_NAMESPACE_END
 
 #endif /* fn_dwt.hpp */
@@ -48,6 +48,17 @@ void_number_type< T > fliplr(matrix< T >& mat)
     // define indices
     size_t j, k;
     
+    // double precision swaps the columns with the dispatched kernel
+    if ( same_type< T, double >::value )
+    {
+        for (j = 0; j < mat.cols / 2; ++j)
+        {
+            SIMD::swap(reinterpret_cast< double* >(&mat(0, j)), reinterpret_cast< double* >(&mat(0, mat.cols - j - 1)), mat.rows, 1, 1);
+        }
+        
+        return;
+    }
+    
     // iterate over half of columns
     for (j = 0; j < mat.cols / 2; ++j)
     {
@@ -90,6 +101,17 @@ void_number_type< T > fliplr_ne2nderow(matrix< T >& mat)
     // define indices
     size_t j, k;
     
+    // double precision swaps the columns with the dispatched kernel
+    if ( same_type< T, double >::value )
+    {
+        for (j = 0; j < mat.cols / 2; ++j)
+        {
+            SIMD::swap(reinterpret_cast< double* >(&mat(0, j)), reinterpret_cast< double* >(&mat(0, mat.cols - j - 1)), mat.rows, -1, 1);
+        }
+        
+        return;
+    }
+    
     // iterate over half of columns
     for (j = 0; j < mat.cols / 2; ++j)
     {
@@ -140,6 +162,17 @@ void_number_type< T > fliplr_ne2ndorow(matrix< T >& mat)
     // define indices
     size_t j, k;
     
+    // double precision swaps the columns with the dispatched kernel
+    if ( same_type< T, double >::value )
+    {
+        for (j = 0; j < mat.cols / 2; ++j)
+        {
+            SIMD::swap(reinterpret_cast< double* >(&mat(0, j)), reinterpret_cast< double* >(&mat(0, mat.cols - j - 1)), mat.rows, 1, -1);
+        }
+        
+        return;
+    }
+    
     // iterate over half of columns
     for (j = 0; j < mat.cols / 2; ++j)
     {
@@ -188,6 +221,17 @@ void_number_type< T > flipud(matrix< T >& mat)
     // define indices
     size_t j, k;
     
+    // double precision reverses the columns with the dispatched kernel
+    if ( same_type< T, double >::value )
+    {
+        for (k = 0; k < mat.cols; ++k)
+        {
+            SIMD::reverse(reinterpret_cast< double* >(&mat(0, k)), mat.rows, 1);
+        }
+        
+        return;
+    }
+    
     // iterate over cols
     for (k = 0; k < mat.cols; ++k)
     {
@@ -229,6 +273,17 @@ void_number_type< T > flipud_ne2ndecol(matrix< T >& mat)
     // define indices
     size_t j, k;
     
+    // double precision reverses the columns with the dispatched kernel
+    if ( same_type< T, double >::value )
+    {
+        for (k = 0; k < mat.cols; ++k)
+        {
+            SIMD::reverse(reinterpret_cast< double* >(&mat(0, k)), mat.rows, (k & 1 ? 1 : -1));
+        }
+        
+        return;
+    }
+    
     // iterate over cols
     for (k = 0; k < mat.cols; ++k)
     {
@@ -279,6 +334,17 @@ void_number_type< T > flipud_ne2ndocol(matrix< T >& mat)
     // define indices
     size_t j, k;
     
+    // double precision reverses the columns with the dispatched kernel
+    if ( same_type< T, double >::value )
+    {
+        for (k = 0; k < mat.cols; ++k)
+        {
+            SIMD::reverse(reinterpret_cast< double* >(&mat(0, k)), mat.rows, (k & 1 ? -1 : 1));
+        }
+        
+        return;
+    }
+    
     // iterate over cols
     for (k = 0; k < mat.cols; ++k)
     {
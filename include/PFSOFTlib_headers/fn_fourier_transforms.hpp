@@ -72,11 +72,59 @@ vector<complex<T> > convert(const vector<complex<U> >& v)
 }
 
 // Forward fast Fourier transform on SO(3)
-void DSOFT(grid3D< complex< double > > sample, DSOFTFourierCoefficients& fc, int threads = PFSOFT_MAX_THREADS);
+void DSOFT(const grid3D< complex< double > >& input, DSOFTFourierCoefficients& fc, int threads = PFSOFT_MAX_THREADS);
 
 // Inverse fast Fourier transform on SO(3)
 void IDSOFT(const DSOFTFourierCoefficients& fc, grid3D< complex< double > >& synthesis, int threads = PFSOFT_MAX_THREADS);
 
+// Fast Fourier transforms on SO(3) that report a timing breakdown
+void DSOFT(const grid3D< complex< double > >& input, DSOFTFourierCoefficients& fc, DSOFTStats& stats, int threads = PFSOFT_MAX_THREADS);
+void IDSOFT(const DSOFTFourierCoefficients& fc, grid3D< complex< double > >& synthesis, DSOFTStats& stats, int threads = PFSOFT_MAX_THREADS);
+
+// Batched inverse fast Fourier transform on SO(3)
+void IDSOFT(const DSOFTFourierCoefficients* const* fc, grid3D< complex< double > >* const* synthesis, const int& count, int threads = PFSOFT_MAX_THREADS);
+
+// Streaming inverse fast Fourier transform on SO(3). The callback gets a
+// block of synthesized layers and the index of its first layer.
+typedef std::function< void(const grid3D< complex< double > >& layers, const int& first) > IDSOFTLayerCallback;
+
+void IDSOFT_stream(const DSOFTFourierCoefficients& fc, const int& bandwidth, const IDSOFTLayerCallback& callback, const int& block = 1, int threads = PFSOFT_MAX_THREADS);
+void IDSOFT_stream(const DSOFTFourierCoefficients& fc, const int& bandwidth, const IDSOFTLayerCallback& callback, const int& block, DSOFTStats& stats, int threads = PFSOFT_MAX_THREADS);
+
+// Slab-wise forward fast Fourier transform on SO(3) for samples that
+// exceed the memory, e.g. memory-mapped grids
+void DSOFT_stream(const grid3D< complex< double > >& sample, DSOFTFourierCoefficients& fc, const int& block, int threads = PFSOFT_MAX_THREADS);
+void DSOFT_stream(const grid3D< complex< double > >& sample, DSOFTFourierCoefficients& fc, const int& block, DSOFTStats& stats, int threads = PFSOFT_MAX_THREADS);
+int  DSOFT_slab_layers(const int& bandwidth);
+
+#if PFSOFT_USE_MPI
+// Distributed memory fast Fourier transforms on SO(3). Every rank holds
+// a slab of beta-layers of the grid.
+void DSOFT_mpi(const grid3D< complex< double > >& slab, const int& bandwidth, DSOFTFourierCoefficients& fc, MPI_Comm comm, int threads = PFSOFT_MAX_THREADS);
+void IDSOFT_mpi(const DSOFTFourierCoefficients& fc, const int& bandwidth, grid3D< complex< double > >& slab, MPI_Comm comm, int threads = PFSOFT_MAX_THREADS);
+void DSOFT_mpi_layers(const int& bandwidth, const int& rank, const int& size, int& first, int& count);
+
+// Distributed memory fast Fourier transforms on SO(3) with the grid on
+// rank 0. Only the DWT is distributed in (M, M') symmetry groups.
+void DSOFT_mpi(const grid3D< complex< double > >& sample, DSOFTFourierCoefficients& fc, MPI_Comm comm, int threads = PFSOFT_MAX_THREADS);
+void IDSOFT_mpi(const DSOFTFourierCoefficients& fc, grid3D< complex< double > >& synthesis, MPI_Comm comm, int threads = PFSOFT_MAX_THREADS);
+#endif
+
+// Sparse inverse fast Fourier transform on SO(3)
+void IDSOFT(const std::vector< DSOFTSparseCoefficient >& coefficients, grid3D< complex< double > >& synthesis, int threads = PFSOFT_MAX_THREADS);
+
+// Evaluation of the Fourier series off the sampling grid
+complex< double > evaluate(const DSOFTFourierCoefficients& fc, const double& alpha, const double& beta, const double& gamma);
+complex< double > refine(const DSOFTFourierCoefficients& fc, double& alpha, double& beta, double& gamma, const int& iterations = 8);
+
+// Runtime tuning of the number of threads and the DWT precision per bandwidth
+bool DSOFT_autotune(const int& min_bandwidth, const int& max_bandwidth, const int& step, const char* path, int threads = PFSOFT_MAX_THREADS, int runs = 3);
+bool DSOFT_load_profile(const char* path);
+int  DSOFT_threads(const int& bandwidth, const int& threads);
+int  DSOFT_threshold();
+bool DSOFT_double_dwt(const int& bandwidth);
+void DSOFT_set_double_dwt(const int& bandwidth);
+
 PFSOFT_NAMESPACE_END
 
 #endif /* fn_fourier_transforms.hpp */
@@ -66,8 +66,15 @@ template< typename pod_type >           struct grid3D< complex< pod_type >, if_p
 // smart_array
 template< typename >                    class  smart_array;
                                         class  stopwatch;
+                                        class  perf_counters;
 
                                         struct DSOFTFourierCoefficients;
+                                        struct DSOFTSparseCoefficient;
+                                        struct DSOFTCodec;
+                                        struct DSOFTStats;
+                                        class  DSOFTTrace;
+                                        struct SO3Rotation;
+                                        class  SO3Correlation;
 
 template< typename, typename >          struct randctx;
 template< typename, typename = void >   struct uniform_int_distribution;
@@ -51,6 +51,21 @@ grid3D< complex< T >, if_pod_type< T > >
     // typedefs
     typedef T pod_type;             //!< POD type of the elements
     
+    /*!
+     * @brief       Specifing where the elements of a grid are stored
+     * @details     A grid either owns heap memory or wraps a file that
+     *              is mapped into memory. Mapped grids can be larger than
+     *              the physical memory, their pages are loaded on demand.
+     *
+     * @ingroup     grid3D
+     */
+    enum storage_type
+    {
+        HEAP,       //!< The elements are stored in heap memory owned by the grid
+        MAPPED,     //!< The elements are stored in a memory-mapped file
+        EXTERNAL    //!< The elements are stored in external memory that is not owned by the grid
+    };
+    
     // ivars
     const size_t rows;              //!< number of rows in each layer
     const size_t cols;              //!< number of cols in each layer
@@ -58,6 +73,10 @@ grid3D< complex< T >, if_pod_type< T > >
     
     const complex< pod_type >* mem; //!< storage of the 3D grid
     
+    const storage_type storage;     //!< kind of storage of the grid
+    const int          fd;          //!< file descriptor of a mapped grid, -1 otherwise
+    const size_t       strides[3];  //!< distance in elements between neighbouring rows, cols and layers
+    
     // methods
     inline                                      grid3D();
     inline                                      grid3D(const size_t& rcl);
@@ -69,6 +88,9 @@ grid3D< complex< T >, if_pod_type< T > >
     inline                                      grid3D(const grid3D< pod_type >& c);
     inline                                      grid3D(const grid3D< complex< pod_type > >& c);
     inline                                      grid3D(grid3D< complex< pod_type > >&& c);
+    inline                                      grid3D(const char* path, const size_t& rcl);
+    inline                                      grid3D(const char* path, const size_t& rows, const size_t& cols, const size_t& lays);
+    inline                                      grid3D(complex< pod_type >* external, const size_t& rows, const size_t& cols, const size_t& lays, const size_t& row_stride = 1, const size_t& col_stride = 0, const size_t& lay_stride = 0);
     inline                                     ~grid3D();
     
     inline const grid3D< complex< pod_type > >& operator=(const grid3D< pod_type >& c);
@@ -80,6 +102,20 @@ grid3D< complex< T >, if_pod_type< T > >
     
     inline       void                           layer_wise_DFT2(const complex< double >& scale = complex< pod_type >(1, 0), int threads = 1);
     inline       void                           layer_wise_IDFT2(const complex< double >& scale = complex< pod_type >(1, 0), int threads = 1);
+    
+    inline       bool                           contiguous() const;
+    inline       void                           copy_layers(complex< pod_type >* dst, const size_t& first, const size_t& count) const;
+    inline       void                           assign_layers(const complex< pod_type >* src, const size_t& first, const size_t& count);
+    
+    inline       void                           prefetch_layers(const size_t& first, const size_t& count) const;
+    inline       void                           release_layers(const size_t& first, const size_t& count) const;
+    
+    inline       bool                           save(const char* path) const;
+    inline       bool                           load(const char* path);
+
+private:
+    inline       void                           map(const char* path);
+    inline       void                           release();
 };
 
 
@@ -90,7 +126,10 @@ grid3D< complex< T >, if_pod_type< T > >::grid3D()
     : rows(0)
     , cols(0)
     , lays(0)
-, mem(nullptr)
+    , mem(nullptr)
+    , storage(HEAP)
+    , fd(-1)
+    , strides{1, rows, rows * cols}
 {}
 
 template< typename T >
@@ -99,6 +138,9 @@ grid3D< complex< T >, if_pod_type< T > >::grid3D(const size_t& rows, const size_
     : rows(rows)
     , cols(cols)
     , lays(lays)
+    , storage(HEAP)
+    , fd(-1)
+    , strides{1, rows, rows * cols}
 {
     mem = new complex< T >[rows * cols * lays];
 }
@@ -109,6 +151,9 @@ grid3D< complex< T >, if_pod_type< T > >::grid3D(const size_t& rcl)
     : rows(rcl)
     , cols(rcl)
     , lays(rcl)
+    , storage(HEAP)
+    , fd(-1)
+    , strides{1, rows, rows * cols}
 {
     mem = new complex< T >[rows * cols * lays];
 }
@@ -119,6 +164,9 @@ grid3D< complex< T >, if_pod_type< T > >::grid3D(const size_t& rows, const size_
     : rows(rows)
     , cols(cols)
     , lays(lays)
+    , storage(HEAP)
+    , fd(-1)
+    , strides{1, rows, rows * cols}
 {
     size_t cap = rows * cols * lays;
     mem        = new complex< T >[cap];
@@ -135,6 +183,9 @@ grid3D< complex< T >, if_pod_type< T > >::grid3D(const size_t& rows, const size_
     : rows(rows)
     , cols(cols)
     , lays(lays)
+    , storage(HEAP)
+    , fd(-1)
+    , strides{1, rows, rows * cols}
 {
     size_t cap  = rows * cols * lays;
     mem         = new complex< T >[cap];
@@ -152,6 +203,9 @@ grid3D< complex< T >, if_pod_type< T > >::grid3D(const size_t& rcl, const comple
     : rows(rcl)
     , cols(rcl)
     , lays(rcl)
+    , storage(HEAP)
+    , fd(-1)
+    , strides{1, rows, rows * cols}
 {
     size_t cap  = rows * cols * lays;
     mem         = new complex< T >[cap];
@@ -168,6 +222,9 @@ grid3D< complex< T >, if_pod_type< T > >::grid3D(const size_t& rcl, const T& ini
     : rows(rcl)
     , cols(rcl)
     , lays(rcl)
+    , storage(HEAP)
+    , fd(-1)
+    , strides{1, rows, rows * cols}
 {
     size_t cap  = rows * cols * lays;
     mem         = new complex< T >[cap];
@@ -185,6 +242,9 @@ grid3D< complex< T >, if_pod_type< T > >::grid3D(const grid3D< T >& c)
     : rows(c.rows)
     , cols(c.cols)
     , lays(c.lays)
+    , storage(HEAP)
+    , fd(-1)
+    , strides{1, rows, rows * cols}
 {
     size_t i, cap = rows * cols * lays;
     mem           = new complex< T >[cap];
@@ -204,13 +264,16 @@ grid3D< complex< T >, if_pod_type< T > >::grid3D(const grid3D< complex< T > >& c
     : rows(c.rows)
     , cols(c.cols)
     , lays(c.lays)
+    , storage(HEAP)
+    , fd(-1)
+    , strides{1, rows, rows * cols}
 {
     size_t cap = rows * cols * lays;
     mem        = new complex< T >[cap];
     
     if (cap > 0)
     {
-        memcpy(access::rwp(mem), access::rwp(c.mem), cap * sizeof(complex< T >));
+        c.copy_layers(access::rwp(mem), 0, lays);
     }
 }
 
@@ -220,28 +283,158 @@ grid3D< complex< T >, if_pod_type< T > >::grid3D(grid3D< complex< T > >&& c)
     : rows(c.rows)
     , cols(c.cols)
     , lays(c.lays)
+    , mem(c.mem)
+    , storage(c.storage)
+    , fd(c.fd)
+    , strides{c.strides[0], c.strides[1], c.strides[2]}
 {
-    complex< T >* tmp = mem;
-    mem               = c.mem;
-    c.mem             = tmp;
+    // leave an empty heap grid behind
+    access::rw(c.rows)    = 0;
+    access::rw(c.cols)    = 0;
+    access::rw(c.lays)    = 0;
+    access::rw(c.mem)     = nullptr;
+    access::rw(c.storage) = HEAP;
+    access::rw(c.fd)      = -1;
 }
 
+/*!
+ * @brief           Constructor for a cubic grid that is stored in a file
+ * @details         See grid3D(const char*, const size_t&, const size_t&, const size_t&)
+ *
+ * @param[in]       path The path of the file
+ * @param[in]       rcl The number of rows, cols and layers
+ */
+template< typename T >
+inline
+grid3D< complex< T >, if_pod_type< T > >::grid3D(const char* path, const size_t& rcl)
+    : rows(rcl)
+    , cols(rcl)
+    , lays(rcl)
+    , mem(nullptr)
+    , storage(MAPPED)
+    , fd(-1)
+    , strides{1, rows, rows * cols}
+{
+    map(path);
+}
+
+/*!
+ * @brief           Constructor for a grid that is stored in a file
+ * @details         Maps the given file into memory and uses it as storage of the
+ *                  grid. The file is created if it does not exist and extended to
+ *                  the size of the grid if it is too small. Existing contents are
+ *                  used as the grid elements in the usual layer-wise order, new
+ *                  contents are zero. All changes of the elements are written to
+ *                  the file.
+ *
+ *                  Only pages that are accessed are loaded, therefore a mapped grid
+ *                  can exceed the physical memory. FourierTransforms::DSOFT and
+ *                  FourierTransforms::IDSOFT process mapped grids in slabs of layers
+ *                  that are read and written sequentially. If the file can not be
+ *                  mapped the grid is empty. Assigning a grid of the same dimensions
+ *                  to a mapped grid writes its elements to the file.
+ *
+ * @param[in]       path The path of the file
+ * @param[in]       rows The number of rows of each layer
+ * @param[in]       cols The number of columns of each layer
+ * @param[in]       lays The number of layers
+ */
+template< typename T >
+inline
+grid3D< complex< T >, if_pod_type< T > >::grid3D(const char* path, const size_t& rows, const size_t& cols, const size_t& lays)
+    : rows(rows)
+    , cols(cols)
+    , lays(lays)
+    , mem(nullptr)
+    , storage(MAPPED)
+    , fd(-1)
+    , strides{1, rows, rows * cols}
+{
+    map(path);
+}
+
+/*!
+ * @brief           Constructor for a grid that views external memory
+ * @details         Wraps the given memory without copying it. The grid does not
+ *                  own the memory, which has to stay valid as long as the grid is
+ *                  used. The element in row \f$r\f$, column \f$c\f$ and layer
+ *                  \f$k\f$ is located at
+ *                  \f[
+ *                      external + r\cdot row\_stride + c\cdot col\_stride + k\cdot lay\_stride.
+ *                  \f]
+ *                  The strides are given in elements. A stride of zero for columns
+ *                  means \f$rows\cdot row\_stride\f$ and for layers
+ *                  \f$cols\cdot col\_stride\f$, i.e. the columns and layers follow
+ *                  each other without gaps, which is the dense layout for a row
+ *                  stride of one.
+ *                  Any alignment of the memory is supported, FFTW plans are adapted
+ *                  to the alignment of the memory they are executed on.
+ *
+ *                  FourierTransforms::DSOFT and FourierTransforms::IDSOFT work on
+ *                  views without copying the whole grid. Views with the dense strides
+ *                  are transformed in place like heap grids, all other views are read
+ *                  or written slab by slab. Assigning a grid of the same dimensions
+ *                  to a view copies its elements into the external memory.
+ *
+ * @param[in]       external The memory of the first element
+ * @param[in]       rows The number of rows of each layer
+ * @param[in]       cols The number of columns of each layer
+ * @param[in]       lays The number of layers
+ * @param[in]       row_stride The distance of two neighbouring rows in elements
+ * @param[in]       col_stride The distance of two neighbouring columns in elements
+ * @param[in]       lay_stride The distance of two neighbouring layers in elements
+ */
+template< typename T >
+inline
+grid3D< complex< T >, if_pod_type< T > >::grid3D(complex< T >* external, const size_t& rows, const size_t& cols, const size_t& lays, const size_t& row_stride, const size_t& col_stride, const size_t& lay_stride)
+    : rows(rows)
+    , cols(cols)
+    , lays(lays)
+    , mem(external)
+    , storage(EXTERNAL)
+    , fd(-1)
+    , strides{row_stride, (col_stride != 0 ? col_stride : rows * row_stride), (lay_stride != 0 ? lay_stride : cols * (col_stride != 0 ? col_stride : rows * row_stride))}
+{}
+
 template< typename T >
 inline
 grid3D< complex< T >, if_pod_type< T > >::~grid3D()
 {
-    delete [] mem;
+    release();
 }
 
 template< typename T >
 inline
 const grid3D< complex< T > >& grid3D< complex< T >, if_pod_type< T > >::operator=(const grid3D< T >& c)
 {
-    rows = c.rows;
-    cols = c.cols;
-    lays = c.lays;
+    // views and mapped grids of the same dimensions are written through
+    if (storage != HEAP && mem != nullptr && rows == c.rows && cols == c.cols && lays == c.lays)
+    {
+        complex< T >* layer = new complex< T >[rows * cols];
+        
+        for (size_t k = 0; k < lays; ++k)
+        {
+            for (size_t i = 0; i < rows * cols; ++i)
+            {
+                layer[i] = complex< T >(c.mem[k * rows * cols + i], 0);
+            }
+            
+            assign_layers(layer, k, 1);
+        }
+        
+        delete [] layer;
+        return *this;
+    }
+    
+    pfsoft_cond_w(storage != HEAP, "%s", "dimension mismatch in the assignment to a grid view or a mapped grid. The grid is reallocated on the heap.");
     
-    delete [] mem;
+    release();
+    
+    access::rw(rows)       = c.rows;
+    access::rw(cols)       = c.cols;
+    access::rw(lays)       = c.lays;
+    access::rw(strides[1]) = rows;
+    access::rw(strides[2]) = rows * cols;
     
     size_t cap = rows * cols * lays;
     mem = new complex< T >[cap];
@@ -251,55 +444,97 @@ const grid3D< complex< T > >& grid3D< complex< T >, if_pod_type< T > >::operator
         size_t i;
         for (i = 0; i < cap; ++i)
         {
-            mem[i] = complex< T >(c.mem[i], 0);
+            access::rw(mem[i]) = complex< T >(c.mem[i], 0);
         }
     }
+    
+    return *this;
 }
 
 template< typename T >
 inline
 const grid3D< complex< T > >& grid3D< complex< T >, if_pod_type< T > >::operator=(const grid3D< complex< T > >& c)
 {
-    rows = c.rows;
-    cols = c.cols;
-    lays = c.lays;
+    if (this == &c)
+    {
+        return *this;
+    }
     
-    delete [] mem;
+    // views and mapped grids of the same dimensions are written through layer
+    // by layer, which also works if c views the same memory
+    if (storage != HEAP && mem != nullptr && rows == c.rows && cols == c.cols && lays == c.lays)
+    {
+        complex< T >* layer = new complex< T >[rows * cols];
+        
+        for (size_t k = 0; k < lays; ++k)
+        {
+            c.copy_layers(layer, k, 1);
+            assign_layers(layer, k, 1);
+        }
+        
+        delete [] layer;
+        return *this;
+    }
+    
+    pfsoft_cond_w(storage != HEAP, "%s", "dimension mismatch in the assignment to a grid view or a mapped grid. The grid is reallocated on the heap.");
+    
+    release();
+    
+    access::rw(rows)       = c.rows;
+    access::rw(cols)       = c.cols;
+    access::rw(lays)       = c.lays;
+    access::rw(strides[1]) = rows;
+    access::rw(strides[2]) = rows * cols;
     
     size_t cap = rows * cols * lays;
     mem = new complex< T >[cap];
     
     if (cap > 0)
     {
-        memcpy(access::rwp(mem), access::rwp(c.mem), rows * cols * lays * sizeof(complex< T >));
+        c.copy_layers(access::rwp(mem), 0, lays);
     }
+    
+    return *this;
 }
 
 template< typename T >
 inline
 const grid3D< complex< T > >& grid3D< complex< T >, if_pod_type< T > >::operator=(grid3D< complex< T > >&& c)
 {
-    rows = c.rows;
-    cols = c.cols;
-    lays = c.lays;
+    // views and mapped grids keep their storage like in the copy assignment
+    if (storage != HEAP && mem != nullptr && rows == c.rows && cols == c.cols && lays == c.lays)
+    {
+        return operator=(static_cast< const grid3D< complex< T > >& >(c));
+    }
     
-    complex< T >* tmp = mem;
-    mem               = c.mem;
-    c.mem             = tmp;
+    // swap everything, the moved grid releases the old storage
+    std::swap(access::rw(rows),    access::rw(c.rows));
+    std::swap(access::rw(cols),    access::rw(c.cols));
+    std::swap(access::rw(lays),    access::rw(c.lays));
+    std::swap(access::rw(mem),     access::rw(c.mem));
+    std::swap(access::rw(storage), access::rw(c.storage));
+    std::swap(access::rw(fd),      access::rw(c.fd));
+    
+    for (int i = 0; i < 3; ++i)
+    {
+        std::swap(access::rw(strides[i]), access::rw(c.strides[i]));
+    }
+    
+    return *this;
 }
 
 template< typename T >
 inline
 complex< T >& grid3D< complex< T >, if_pod_type< T > >::operator()(const size_t& row, const size_t& col, const size_t& lay)
 {
-    return access::rw(mem[rows * cols * lay + cols * col + row]);
+    return access::rw(mem[strides[2] * lay + strides[1] * col + strides[0] * row]);
 }
 
 template< typename T >
 inline
 const complex< T >& grid3D< complex< T >, if_pod_type< T > >::operator()(const size_t& row, const size_t& col, const size_t& lay) const
 {
-    return mem[rows * cols * lay + cols * col + row];
+    return mem[strides[2] * lay + strides[1] * col + strides[0] * row];
 }
 
 
@@ -308,6 +543,14 @@ template< typename T >
 inline
 void grid3D< complex< T >, if_pod_type< T > >::layer_wise_DFT2(const complex< double >& scale, int threads)
 {
+    // the FFT2 runs in place on dense layers
+    pfsoft_cond_w(!contiguous(), "%s", "layer-wise FFT2 needs a grid with dense strides. Copy the view into a heap grid first.");
+    
+    if (!contiguous())
+    {
+        return;
+    }
+    
     // declare variables
     size_t i;
     double* data;
@@ -344,10 +587,7 @@ void grid3D< complex< T >, if_pod_type< T > >::layer_wise_DFT2(const complex< do
         // scale data
         if ( same_type< T, double >::value )
         {
-            for (i = 0; i < rows * cols * lays; ++i)
-            {
-                access::rw(mem[i]) *= scale;
-            }
+            SIMD::scale(data, rows * cols * lays, scale.re, scale.im);
         }
         else
         {
@@ -369,6 +609,14 @@ template< typename T >
 inline
 void grid3D< complex< T >, if_pod_type< T > >::layer_wise_IDFT2(const complex< double >& scale, int threads)
 {
+    // the FFT2 runs in place on dense layers
+    pfsoft_cond_w(!contiguous(), "%s", "layer-wise FFT2 needs a grid with dense strides. Copy the view into a heap grid first.");
+    
+    if (!contiguous())
+    {
+        return;
+    }
+    
     // declare variables
     size_t i;
     double* data;
@@ -405,10 +653,7 @@ void grid3D< complex< T >, if_pod_type< T > >::layer_wise_IDFT2(const complex< d
         // scale data
         if ( same_type< T, double >::value )
         {
-            for (i = 0; i < rows * cols * lays; ++i)
-            {
-                access::rw(mem[i]) *= scale;
-            }
+            SIMD::scale(data, rows * cols * lays, scale.re, scale.im);
         }
         else
         {
@@ -426,6 +671,352 @@ void grid3D< complex< T >, if_pod_type< T > >::layer_wise_IDFT2(const complex< d
     }
 }
 
+/*!
+ * @brief           Whether the elements are stored densely
+ * @details         A grid is contiguous if its strides are \f$1\f$, \f$rows\f$
+ *                  and \f$rows\cdot cols\f$, i.e. if the element in row \f$r\f$,
+ *                  column \f$c\f$ and layer \f$k\f$ is located at
+ *                  \f$mem[k\cdot rows\cdot cols + c\cdot rows + r]\f$. Heap and mapped
+ *                  grids are always contiguous.
+ *
+ * @return          True if the grid is contiguous, false otherwise
+ */
+template< typename T >
+inline
+bool grid3D< complex< T >, if_pod_type< T > >::contiguous() const
+{
+    return strides[0] == 1 && strides[1] == rows && strides[2] == rows * cols;
+}
+
+/*!
+ * @brief           Copies layers into dense memory
+ * @details         Copies the layers \f$first,\dots,first + count - 1\f$ into the
+ *                  given memory in the dense layout of a heap grid. Contiguous grids
+ *                  are copied with a single memcpy.
+ *
+ * @param[out]      dst The memory for \f$rows\cdot cols\cdot count\f$ elements
+ * @param[in]       first The index of the first layer
+ * @param[in]       count The number of layers
+ */
+template< typename T >
+inline
+void grid3D< complex< T >, if_pod_type< T > >::copy_layers(complex< T >* dst, const size_t& first, const size_t& count) const
+{
+    if (contiguous())
+    {
+        memcpy(reinterpret_cast< char* >(dst), reinterpret_cast< const char* >(mem + first * strides[2]), rows * cols * count * sizeof(complex< T >));
+        return;
+    }
+    
+    for (size_t k = 0; k < count; ++k)
+    {
+        for (size_t c = 0; c < cols; ++c)
+        {
+            const complex< T >* src = mem + (first + k) * strides[2] + c * strides[1];
+            for (size_t r = 0; r < rows; ++r, ++dst)
+            {
+                *dst = src[r * strides[0]];
+            }
+        }
+    }
+}
+
+/*!
+ * @brief           Assigns layers from dense memory
+ * @details         The counterpart of grid3D::copy_layers. Overwrites the layers
+ *                  \f$first,\dots,first + count - 1\f$ with the given memory in the
+ *                  dense layout of a heap grid.
+ *
+ * @param[in]       src The memory of \f$rows\cdot cols\cdot count\f$ elements
+ * @param[in]       first The index of the first layer
+ * @param[in]       count The number of layers
+ */
+template< typename T >
+inline
+void grid3D< complex< T >, if_pod_type< T > >::assign_layers(const complex< T >* src, const size_t& first, const size_t& count)
+{
+    if (contiguous())
+    {
+        memcpy(reinterpret_cast< char* >(access::rwp(mem) + first * strides[2]), reinterpret_cast< const char* >(src), rows * cols * count * sizeof(complex< T >));
+        return;
+    }
+    
+    for (size_t k = 0; k < count; ++k)
+    {
+        for (size_t c = 0; c < cols; ++c)
+        {
+            complex< T >* dst = access::rwp(mem) + (first + k) * strides[2] + c * strides[1];
+            for (size_t r = 0; r < rows; ++r, ++src)
+            {
+                dst[r * strides[0]] = *src;
+            }
+        }
+    }
+}
+
+/*!
+ * @brief           Advises the system to load the given layers
+ * @details         For a mapped grid the pages of the layers
+ *                  \f$first,\dots,first + count - 1\f$ are requested to be read
+ *                  ahead, so that a sequential pass over the layers does not stall
+ *                  on page faults. Has no effect on heap grids.
+ *
+ * @param[in]       first The index of the first layer
+ * @param[in]       count The number of layers
+ */
+template< typename T >
+inline
+void grid3D< complex< T >, if_pod_type< T > >::prefetch_layers(const size_t& first, const size_t& count) const
+{
+    if (storage != MAPPED || mem == nullptr || count == 0 || first >= lays)
+    {
+        return;
+    }
+    
+    const size_t page  = static_cast< size_t >(sysconf(_SC_PAGESIZE));
+    const size_t layer = rows * cols * sizeof(complex< T >);
+    const size_t end   = std::min(first + count, lays) * layer;
+    
+    // round the range outwards to page boundaries
+    const size_t begin = (first * layer) / page * page;
+    
+    madvise(reinterpret_cast< char* >(access::rwp(mem)) + begin, end - begin, MADV_WILLNEED);
+    
+    #ifdef POSIX_FADV_WILLNEED
+    posix_fadvise(fd, begin, end - begin, POSIX_FADV_WILLNEED);
+    #endif
+}
+
+/*!
+ * @brief           Advises the system that the given layers are not needed soon
+ * @details         For a mapped grid the writeback of modified pages of the layers
+ *                  \f$first,\dots,first + count - 1\f$ is started and the pages are
+ *                  dropped from the resident memory. The contents of the grid are
+ *                  not changed, the pages are loaded again on the next access. Has
+ *                  no effect on heap grids.
+ *
+ * @param[in]       first The index of the first layer
+ * @param[in]       count The number of layers
+ */
+template< typename T >
+inline
+void grid3D< complex< T >, if_pod_type< T > >::release_layers(const size_t& first, const size_t& count) const
+{
+    if (storage != MAPPED || mem == nullptr || count == 0 || first >= lays)
+    {
+        return;
+    }
+    
+    const size_t page  = static_cast< size_t >(sysconf(_SC_PAGESIZE));
+    const size_t layer = rows * cols * sizeof(complex< T >);
+    
+    // round the range inwards to page boundaries, pages that are shared
+    // with neighbouring layers stay resident
+    const size_t begin = (first * layer + page - 1) / page * page;
+    const size_t end   = (std::min(first + count, lays) * layer) / page * page;
+    
+    if (end <= begin)
+    {
+        return;
+    }
+    
+    char* addr = reinterpret_cast< char* >(access::rwp(mem)) + begin;
+    
+    msync(addr, end - begin, MS_ASYNC);
+    madvise(addr, end - begin, MADV_DONTNEED);
+    
+    #ifdef POSIX_FADV_DONTNEED
+    posix_fadvise(fd, begin, end - begin, POSIX_FADV_DONTNEED);
+    #endif
+}
+
+/*!
+ * @brief           Writes the grid to a binary file
+ * @details         The file starts with a binary_header, followed by one checksum
+ *                  per layer and the elements in the layout of the grid. The
+ *                  elements are written with a single gathered write and start at a
+ *                  page aligned offset. Mapped grids are written the same way, views
+ *                  with other strides are written in the dense layout.
+ *
+ * @param[in]       path The path of the file
+ * @return          True if the file was written, false otherwise
+ *
+ * @sa              grid3D::load
+ */
+template< typename T >
+inline
+bool grid3D< complex< T >, if_pod_type< T > >::save(const char* path) const
+{
+    binary_header header;
+    memset(&header, 0, sizeof(header));
+    
+    header.kind      = BINARY_GRID;
+    header.precision = sizeof(T);
+    header.dims[0]   = rows;
+    header.dims[1]   = cols;
+    header.dims[2]   = lays;
+    header.chunks    = lays;
+    
+    // one chunk per layer
+    std::vector< size_t > chunks(lays, rows * cols * sizeof(complex< T >));
+    
+    if (contiguous())
+    {
+        return binary_write(path, header, mem, chunks.data());
+    }
+    
+    // views with other strides are written in the dense layout
+    std::vector< complex< T > > dense(rows * cols * lays);
+    copy_layers(dense.data(), 0, lays);
+    
+    return binary_write(path, header, dense.data(), chunks.data());
+}
+
+/*!
+ * @brief           Reads the grid from a binary file
+ * @details         Maps a file that was written by grid3D::save, verifies the
+ *                  checksum of every layer and copies the elements into heap
+ *                  memory. The grid takes the dimensions of the file. It is left
+ *                  unchanged if reading fails.
+ *
+ * @param[in]       path The path of the file
+ * @return          True if the grid was read, false otherwise
+ *
+ * @sa              grid3D::save
+ */
+template< typename T >
+inline
+bool grid3D< complex< T >, if_pod_type< T > >::load(const char* path)
+{
+    binary_file file;
+    if (!binary_open(&file, path, BINARY_GRID, sizeof(T)))
+    {
+        return false;
+    }
+    
+    const size_t layer = file.header.dims[0] * file.header.dims[1] * sizeof(complex< T >);
+    
+    // verify all layers
+    bool ok = file.header.layout == 0 && file.header.chunks == file.header.dims[2] && file.header.data_bytes == layer * file.header.dims[2];
+    for (size_t k = 0; ok && k < file.header.dims[2]; ++k)
+    {
+        ok = binary_check(&file, k, k * layer, layer);
+    }
+    
+    pfsoft_cond_w(!ok, "grid in binary file '%s' is corrupted.", path);
+    
+    if (ok)
+    {
+        release();
+        
+        access::rw(rows)       = file.header.dims[0];
+        access::rw(cols)       = file.header.dims[1];
+        access::rw(lays)       = file.header.dims[2];
+        access::rw(strides[1]) = rows;
+        access::rw(strides[2]) = rows * cols;
+        
+        mem = new complex< T >[rows * cols * lays];
+        memcpy(access::rwp(mem), file.data, file.header.data_bytes);
+    }
+    
+    binary_close(&file);
+    
+    return ok;
+}
+
+/*!
+ * @brief           Maps the given file as storage of the grid
+ * @details         Opens or creates the file, extends it to the size of the grid
+ *                  and maps it shared into memory. The whole mapping is advised for
+ *                  sequential access. On failure the grid becomes empty.
+ *
+ * @param[in]       path The path of the file
+ */
+template< typename T >
+inline
+void grid3D< complex< T >, if_pod_type< T > >::map(const char* path)
+{
+    const size_t bytes = rows * cols * lays * sizeof(complex< T >);
+    
+    int file = open(path, O_RDWR | O_CREAT, 0644);
+    pfsoft_cond_w(file < 0, "could not open grid3D file '%s'.", path);
+    
+    // extend the file if it is too small
+    struct stat st;
+    bool ok = file >= 0 && fstat(file, &st) == 0;
+    if (ok && static_cast< size_t >(st.st_size) < bytes)
+    {
+        ok = ftruncate(file, bytes) == 0;
+        pfsoft_cond_w(!ok, "could not resize grid3D file '%s'.", path);
+    }
+    
+    void* addr = MAP_FAILED;
+    if (ok && bytes > 0)
+    {
+        addr = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+        pfsoft_cond_w(addr == MAP_FAILED, "could not map grid3D file '%s'.", path);
+    }
+    
+    if (addr == MAP_FAILED)
+    {
+        if (file >= 0)
+        {
+            close(file);
+        }
+        
+        access::rw(rows)    = 0;
+        access::rw(cols)    = 0;
+        access::rw(lays)    = 0;
+        access::rw(storage) = HEAP;
+        
+        return;
+    }
+    
+    madvise(addr, bytes, MADV_SEQUENTIAL);
+    
+    #ifdef POSIX_FADV_SEQUENTIAL
+    posix_fadvise(file, 0, bytes, POSIX_FADV_SEQUENTIAL);
+    #endif
+    
+    access::rw(mem) = static_cast< complex< T >* >(addr);
+    access::rw(fd)  = file;
+}
+
+/*!
+ * @brief           Frees the storage of the grid
+ * @details         Deletes the heap memory or unmaps and closes the file of a
+ *                  mapped grid. External memory is left untouched.
+ */
+template< typename T >
+inline
+void grid3D< complex< T >, if_pod_type< T > >::release()
+{
+    if (storage == MAPPED)
+    {
+        if (mem != nullptr)
+        {
+            munmap(access::rwp(mem), rows * cols * lays * sizeof(complex< T >));
+        }
+        
+        if (fd >= 0)
+        {
+            close(fd);
+        }
+    }
+    else if (storage == HEAP)
+    {
+        delete [] mem;
+    }
+    
+    // the grid is an empty dense heap grid afterwards
+    access::rw(mem)        = nullptr;
+    access::rw(storage)    = HEAP;
+    access::rw(fd)         = -1;
+    access::rw(strides[0]) = 1;
+    access::rw(strides[1]) = rows;
+    access::rw(strides[2]) = rows * cols;
+}
+
 template< typename S >
 std::ostream& operator<<(std::ostream& o, const grid3D< complex< S > >& c)
 {
@@ -511,7 +1102,7 @@ std::ostream& operator<<(std::ostream& o, const grid3D< complex< S > >& c)
                 
                 // set filling character
                 o << std::setfill(' ') << std::right << std::setw(width) << str;
-                
+            
             }
             o << std::endl;
         }
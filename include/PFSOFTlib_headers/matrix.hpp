@@ -364,6 +364,13 @@ vector< complex< T > > matrix< T, if_pod_type< T > >::operator*(const vector< co
     
     cx_T_vector result(rows, 0, v.type);
     
+    // double precision uses the dispatched kernel
+    if ( same_type< T, double >::value )
+    {
+        SIMD::gemv(reinterpret_cast< const double* >(access::rw(mem).begin()), rows, cols, reinterpret_cast< const double* >(&v[0]), reinterpret_cast< double* >(&result[0]));
+        return result;
+    }
+    
     size_t i, j;
     for (i = 0; i < cols; ++i)
     {
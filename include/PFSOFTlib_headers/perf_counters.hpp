@@ -0,0 +1,97 @@
+//
+//  perf_counters.hpp
+//  PFSOFTlib
+//
+//   Created by Denis-Michael Lux on 05. November 2015.
+//
+//   This file is part of PFSOFTlib.
+//
+//   PFSOFTlib is free software: you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License as published by
+//   the Free Software Foundation, either version 3 of the License, or
+//   (at your option) any later version.
+//
+//   PFSOFTlib is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with PFSOFTlib.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef PFSOFTlib_perf_counters_hpp
+#define PFSOFTlib_perf_counters_hpp
+
+PFSOFT_BEGIN
+
+/*!
+ * @brief   Hardware performance counters of the calling thread or an OpenMP team
+ * @details Reads the cycles, retired instructions, last level cache misses and
+ *          floating point operations of a code snippet through the Linux
+ *          perf_event_open interface. Only user space events are counted. A
+ *          counter of the kernel belongs to a single thread, therefore the
+ *          counters of a team are opened by every thread of an OpenMP region
+ *          of the given size and summed up. The transforms run their parallel
+ *          loops on the same threads of the OpenMP runtime, as long as they
+ *          are not called from a parallel region.
+ *
+ *          Events that the kernel or the processor do not provide are not
+ *          available and return -1. This is the case on other systems than
+ *          Linux, if perf_event_paranoid forbids user space measurements or
+ *          inside most virtual machines. The floating point operations are
+ *          the double precision operations of the FP_ARITH_INST_RETIRED events
+ *          of Intel processors weighted by the vector width. They do not include
+ *          x87 instructions, which are used for long double arithmetic, so the
+ *          long double DWT of DSOFT and IDSOFT is not part of the count, only
+ *          the double one (see FourierTransforms::DSOFT_double_dwt). If the
+ *          processor has fewer counters than events, the kernel multiplexes them
+ *          and the counts are extrapolated.
+ *
+ * @sa      stopwatch
+ *
+ * @since   1.0.0
+ */
+class perf_counters
+{
+public:
+    /*!
+     * @brief   The measured events
+     */
+    enum event
+    {
+        CYCLES       = 0,   //!< Core cycles
+        INSTRUCTIONS = 1,   //!< Retired instructions
+        LLC_MISSES   = 2,   //!< Last level cache misses
+        FLOPS        = 3,   //!< Floating point operations
+        EVENTS       = 4    //!< Number of events
+    };
+
+private:
+    static const int FLOP_EVENTS = 4;               //!< Scalar, 128, 256 and 512 bit double events
+    
+    static const int FDS         = EVENTS - 1 + FLOP_EVENTS;    //!< File descriptors per thread
+    
+    std::vector< int > fd;                          //!< The event file descriptors of every thread or -1
+    long long          counts[EVENTS];              //!< The counts of the last measurement
+    
+    perf_counters(const perf_counters&);
+    perf_counters& operator=(const perf_counters&);
+
+public:
+    perf_counters(const bool& flops = true, const int& threads = 1);
+    ~perf_counters();
+    
+    void start();
+    void stop();
+    
+    bool      available(const event& e) const;
+    long long value(const event& e) const;
+    double    ipc() const;
+    
+    static const char* name(const int& e);
+};
+
+PFSOFT_END
+
+#endif /* perf_counters.hpp */
@@ -0,0 +1,55 @@
+//
+//  simd_kernels.hpp
+//  PFSOFTlib
+//
+//   Created by Denis-Michael Lux on 05. November 2015.
+//
+//   This file is part of PFSOFTlib.
+//
+//   PFSOFTlib is free software: you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License as published by
+//   the Free Software Foundation, either version 3 of the License, or
+//   (at your option) any later version.
+//
+//   PFSOFTlib is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with PFSOFTlib.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef PFSOFTlib_simd_kernels_hpp
+#define PFSOFTlib_simd_kernels_hpp
+
+/*!
+ * @brief       Double precision kernels with runtime instruction set dispatch
+ * @details     The inner loops of the double precision matrices, vectors and
+ *              grids call these kernels instead of their generic template code.
+ *              If the library is built with PFSOFT_TARGET_CLONES, every kernel
+ *              is compiled for AVX-512, AVX2 and the SSE2 baseline of x86-64.
+ *              The dynamic loader selects the best variant for the processor
+ *              once when the library is loaded, so a single binary runs on all
+ *              nodes of a heterogeneous cluster.
+ *
+ *              Complex values are passed as interleaved real and imaginary
+ *              parts. Matrices are stored in column major order.
+ *
+ * @since       1.0.0
+ */
+PFSOFT_NAMESPACE(SIMD)
+
+const char* variant();
+
+void scale(double* x, const size_t& n, const double& re, const double& im);
+void gemv(const double* A, const size_t& rows, const size_t& cols, const double* x, double* y);
+void wigner_step(double* wig, const size_t& rows, const size_t& cols, const size_t& i, const double* cosBeta, const double& c1, const double& f1, const double& f2);
+void swap(double* a, double* b, const size_t& n, const double& even, const double& odd);
+void reverse(double* a, const size_t& n, const double& sign);
+void scatter(const double* x, const size_t& n, const double& factor, double* fc, const int& first, const int& M, const int& Mp);
+void gather(const double* fc, const size_t& n, const double& factor, double* x, const int& first, const int& M, const int& Mp);
+
+PFSOFT_NAMESPACE_END
+
+#endif /* simd_kernels.hpp */
@@ -0,0 +1,136 @@
+//
+//  so3_correlation.hpp
+//  PFSOFTlib
+//
+//   Created by Denis-Michael Lux on 05. November 2015.
+//
+//   This file is part of PFSOFTlib.
+//
+//   PFSOFTlib is free software: you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License as published by
+//   the Free Software Foundation, either version 3 of the License, or
+//   (at your option) any later version.
+//
+//   PFSOFTlib is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with PFSOFTlib.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef PFSOFTlib_so3_correlation_hpp
+#define PFSOFTlib_so3_correlation_hpp
+
+PFSOFT_BEGIN
+
+/*!
+ * @brief       Collection of functions and classes for rotational matching
+ *              of functions on the sphere
+ * @defgroup    SO3Correlation SO(3) correlation
+ * @{
+ */
+
+/*!
+ * @brief       A rotation in ZYZ Euler angles together with the value of the
+ *              correlation at this rotation.
+ * @details     The rotation is \f$R = R_z(\alpha)R_y(\beta)R_z(\gamma)\f$.
+ *
+ * @since       1.0.0
+ */
+struct SO3Rotation
+{
+    double            alpha;    //!< First Euler angle \f$\alpha\in[0, 2\pi)\f$
+    double            beta;     //!< Second Euler angle \f$\beta\in(0, \pi)\f$
+    double            gamma;    //!< Third Euler angle \f$\gamma\in[0, 2\pi)\f$
+    complex< double > value;    //!< Value of the correlation at this rotation
+};
+
+/*!
+ * @brief       Correlation of two functions on the sphere over all rotations
+ * @details     For two bandlimited functions \f$f, g\f$ on the sphere the
+ *              correlation
+ *              \f[
+ *                  C(R) = \int_{S^2} f(\omega)\overline{g(R^{-1}\omega)}\,d\omega
+ *                  = \sum\limits_{l=0}^{B-1}\sum\limits_{m,m'=-l}^{l}f_{lm}
+ *                      \overline{g_{lm'}}\,\overline{D^l_{mm'}(R)}
+ *              \f]
+ *              is an SO(3) Fourier series. The correlation object builds its
+ *              DSOFT Fourier coefficients directly from the spherical harmonic
+ *              coefficients \f$f_{lm}, g_{lm}\f$ of both functions and synthesizes
+ *              \f$C\f$ on the \f$2B\times 2B\times 2B\f$ Euler angle grid with one
+ *              IDSOFT. The rotation \f$R\f$ that maximizes
+ *              \f$\mathrm{Re}\,C(R)\f$ is the one that best aligns \f$g\f$ to
+ *              \f$f\f$, i.e. minimizes \f$\|f - g(R^{-1}\cdot)\|\f$.
+ *
+ *              Spherical harmonic coefficients are passed as vectors of length
+ *              \f$B^2\f$ where \f$f_{lm}\f$ is stored at index \f$l^2 + l + m\f$.
+ *              They refer to orthonormal spherical harmonics with Condon-Shortley
+ *              phase, \f$D^l_{mm'}(R) = e^{-im\alpha}d^l_{mm'}(\beta)e^{-im'\gamma}\f$.
+ *
+ *              All memory is allocated once per bandwidth on construction, so
+ *              a match costs one coefficient sweep and a single IDSOFT.
+ *
+ *              To match one query against many templates the object holds a
+ *              batch of coefficient containers and grids. The templates are
+ *              processed in chunks of the batch size with the batched IDSOFT,
+ *              which shares the wigner d-matrices and the FFTW plan between all
+ *              transforms of a chunk. Only the best rotations per template are
+ *              kept, therefore never more than batch size grids are resident.
+ *              Afterwards the coefficients of the templates of the last chunk
+ *              can be refined by their template index. The accessors without
+ *              index only refer to the last single correlation.
+ *
+ * @since       1.0.0
+ */
+class SO3Correlation
+{
+    DSOFTFourierCoefficients**    coef;       //!< Fourier coefficients of the correlations per batch slot
+    grid3D< complex< double > >** synthesis;  //!< Correlations on the Euler angle grid per batch slot
+    vector< double >              factors;    //!< Normalization factor per degree
+    long                          first;      //!< Template in slot 0 after a batch or -1 after a single correlation
+    int                           chunk;      //!< Number of occupied slots of the last correlation
+    
+    SO3Correlation(const SO3Correlation&);
+    SO3Correlation& operator=(const SO3Correlation&);
+    
+    void                                products(const vector< complex< double > >& f, const vector< complex< double > >* const* g, const int& chunk, DSOFTFourierCoefficients** c) const;
+    bool                                local_max(const grid3D< complex< double > >& grid, const size_t& idx) const;
+    void                                best(const int& slot, const size_t& k, SO3Rotation* rotations) const;
+    SO3Rotation                         rotation(const int& slot, const size_t& row, const size_t& col, const size_t& lay) const;
+    int                                 template_slot(const size_t& t) const;
+    SO3Rotation                         refine_slot(const int& slot, const SO3Rotation& peak, const int& iterations) const;
+    
+public:
+    // public ivars
+    const int bandwidth;                      //!< Bandwidth of the correlated functions
+    const int batch;                          //!< Number of correlations that are synthesized at once
+    
+    // constructors
+    SO3Correlation(int bandlimit, int batchsize = 1);
+    
+    // destructor
+    ~SO3Correlation();
+    
+    // methods
+    void                                coefficients(const vector< complex< double > >& f, const vector< complex< double > >& g);
+    SO3Rotation                         correlate(const vector< complex< double > >& f, const vector< complex< double > >& g, int threads = PFSOFT_MAX_THREADS);
+    std::vector< SO3Rotation >          correlate(const vector< complex< double > >& f, const std::vector< vector< complex< double > > >& templates, const size_t& k, int threads = PFSOFT_MAX_THREADS);
+    SO3Rotation                         argmax() const;
+    SO3Rotation                         refine(const SO3Rotation& peak, const int& iterations = 8) const;
+    SO3Rotation                         refine(const size_t& t, const SO3Rotation& peak, const int& iterations = 8) const;
+    SO3Rotation                         rotation(const size_t& row, const size_t& col, const size_t& lay) const;
+    
+    const DSOFTFourierCoefficients&     fourier_coefficients() const;
+    const DSOFTFourierCoefficients&     fourier_coefficients(const size_t& t) const;
+    const grid3D< complex< double > >&  correlation() const;
+};
+
+/*!
+ * @}
+ */
+
+PFSOFT_END
+
+#endif /* so3_correlation.hpp */
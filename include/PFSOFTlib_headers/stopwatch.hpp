@@ -25,6 +25,13 @@
 
 PFSOFT_BEGIN
 
+// The clock of the stopwatch. The raw monotonic clock is not slewed by NTP.
+#ifdef CLOCK_MONOTONIC_RAW
+    #define PFSOFT_STOPWATCH_CLOCK CLOCK_MONOTONIC_RAW
+#else
+    #define PFSOFT_STOPWATCH_CLOCK CLOCK_MONOTONIC
+#endif
+
 /*!
  * @brief   A measurment tool for getting execution time of code snippets.
  * @details The stop watch can be used to measure the execution time of a
@@ -39,20 +46,25 @@ PFSOFT_BEGIN
  */
 class stopwatch
 {
-    struct timeval start;   //!< The start time reference
+    struct timespec start;  //!< The start time reference
     
     stopwatch();            
     
+    double lap();
+    
 public:
     static stopwatch tic();
     ~stopwatch();
     
     double toc();
+    double toc_nanos();
     double toc_micros();
     double toc_millis();
     double toc_seconds();
     double toc_minutes();
     double toc_hours();
+    
+    static uint64_t ticks();
 };
 
 PFSOFT_END
@@ -0,0 +1,310 @@
+//
+//  binary_io.cpp
+//  PFSOFTlib
+//
+//   Created by Denis-Michael Lux on 05. November 2015.
+//
+//   This file is part of PFSOFTlib.
+//
+//   PFSOFTlib is free software: you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License as published by
+//   the Free Software Foundation, either version 3 of the License, or
+//   (at your option) any later version.
+//
+//   PFSOFTlib is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with PFSOFTlib.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <sys/uio.h>
+#include <cerrno>
+#include <string>
+
+#include <pfsoft>
+
+PFSOFT_BEGIN
+
+/*!
+ * @brief           64 bit FNV-1a checksum of a memory range
+ * @details         The range is hashed in words of eight bytes and the remaining
+ *                  bytes one by one, which makes the checksum fast enough to verify
+ *                  large transforms while it is read.
+ *
+ * @param[in]       data The start of the range
+ * @param[in]       bytes The length of the range in bytes
+ * @return          The checksum of the range
+ *
+ * @since           1.0.0
+ */
+uint64_t binary_checksum(const void* data, const size_t& bytes)
+{
+    const unsigned char* p = static_cast< const unsigned char* >(data);
+    
+    uint64_t hash = 14695981039346656037ull;
+    size_t   i    = 0;
+    
+    for (; i + 8 <= bytes; i += 8)
+    {
+        uint64_t word;
+        memcpy(&word, p + i, 8);
+        
+        hash ^= word;
+        hash *= 1099511628211ull;
+    }
+    
+    for (; i < bytes; ++i)
+    {
+        hash ^= p[i];
+        hash *= 1099511628211ull;
+    }
+    
+    return hash;
+}
+
+/*!
+ * @brief           Checksum of a header together with its chunk table
+ */
+static uint64_t header_checksum(const binary_header& header, const uint64_t* sums)
+{
+    binary_header tmp = header;
+    tmp.checksum      = 0;
+    
+    return binary_checksum(&tmp, sizeof(tmp)) ^ binary_checksum(sums, header.chunks * sizeof(uint64_t));
+}
+
+/*!
+ * @brief           Writes a binary file
+ * @details         Completes the given header, computes the checksum of every chunk
+ *                  and writes the header, the chunk table and the data with a single
+ *                  gathered write. The file is written under a temporary name and
+ *                  renamed afterwards, so readers never see a partially written file.
+ *
+ * @param[in]       path The path of the file
+ * @param[in,out]   header The header. kind, precision, dims and chunks have to be set.
+ * @param[in]       data The elements of all chunks one after another
+ * @param[in]       chunk_bytes The size of every chunk in bytes
+ * @return          True if the file was written, false otherwise
+ *
+ * @since           1.0.0
+ */
+bool binary_write(const char* path, binary_header& header, const void* data, const size_t* chunk_bytes)
+{
+    const char* bytes = static_cast< const char* >(data);
+    
+    // chunk table
+    std::vector< uint64_t > sums(header.chunks);
+    
+    size_t total = 0;
+    for (size_t i = 0; i < header.chunks; ++i)
+    {
+        sums[i] = binary_checksum(bytes + total, chunk_bytes[i]);
+        total  += chunk_bytes[i];
+    }
+    
+    // complete the header
+    memcpy(header.magic, "PFSOFTB", 8);
+    header.byte_order  = BINARY_BYTE_ORDER;
+    header.version     = BINARY_VERSION;
+    header.reserved    = 0;
+    header.data_bytes  = total;
+    header.data_offset = (sizeof(binary_header) + sums.size() * sizeof(uint64_t) + BINARY_ALIGNMENT - 1) / BINARY_ALIGNMENT * BINARY_ALIGNMENT;
+    header.checksum    = header_checksum(header, sums.data());
+    
+    // header, chunk table and padding in one block
+    std::vector< char > prefix(header.data_offset, 0);
+    memcpy(prefix.data(), &header, sizeof(binary_header));
+    memcpy(prefix.data() + sizeof(binary_header), sums.data(), sums.size() * sizeof(uint64_t));
+    
+    std::string tmp = std::string(path) + ".tmp";
+    
+    int fd = open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    pfsoft_cond_w(fd < 0, "could not open binary file '%s' for writing.", tmp.c_str());
+    
+    if (fd < 0)
+    {
+        return false;
+    }
+    
+    struct iovec io[2];
+    io[0].iov_base = prefix.data();
+    io[0].iov_len  = prefix.size();
+    io[1].iov_base = const_cast< char* >(bytes);
+    io[1].iov_len  = total;
+    
+    // writev may write less than requested, continue with the rest
+    bool   ok   = true;
+    int    n    = 0;
+    size_t left = io[0].iov_len + io[1].iov_len;
+    while (ok && left > 0)
+    {
+        ssize_t written = writev(fd, io + n, 2 - n);
+        if (written < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        
+        ok = written > 0;
+        if (!ok)
+        {
+            break;
+        }
+        
+        left    -= written;
+        size_t w = written;
+        while (n < 2 && w >= io[n].iov_len)
+        {
+            w -= io[n].iov_len;
+            ++n;
+        }
+        
+        if (n < 2)
+        {
+            io[n].iov_base = static_cast< char* >(io[n].iov_base) + w;
+            io[n].iov_len -= w;
+        }
+    }
+    
+    ok = close(fd) == 0 && ok;
+    ok = ok && rename(tmp.c_str(), path) == 0;
+    
+    pfsoft_cond_w(!ok, "could not write binary file '%s'.", path);
+    
+    if (!ok)
+    {
+        unlink(tmp.c_str());
+    }
+    
+    return ok;
+}
+
+/*!
+ * @brief           Opens a binary file for reading
+ * @details         Maps the whole file read-only into memory and validates the
+ *                  header. The pages of the elements are only read when they are
+ *                  accessed, so loading a prefix of the chunks does not read the
+ *                  rest of the file. The layout of the elements is checked by the
+ *                  caller.
+ *
+ * @param[out]      file The opened file
+ * @param[in]       path The path of the file
+ * @param[in]       kind The expected binary_kind
+ * @param[in]       precision The expected size of a real or imaginary part
+ * @return          True if the file could be mapped and its header is valid. The
+ *                  file does not have to be closed otherwise.
+ *
+ * @since           1.0.0
+ */
+bool binary_open(binary_file* file, const char* path, const uint32_t& kind, const uint32_t& precision)
+{
+    file->base   = nullptr;
+    file->length = 0;
+    
+    int fd = open(path, O_RDONLY);
+    pfsoft_cond_w(fd < 0, "could not open binary file '%s'.", path);
+    
+    if (fd < 0)
+    {
+        return false;
+    }
+    
+    struct stat st;
+    bool ok = fstat(fd, &st) == 0 && static_cast< size_t >(st.st_size) >= sizeof(binary_header);
+    
+    void* base = MAP_FAILED;
+    if (ok)
+    {
+        base = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    
+    close(fd);
+    
+    pfsoft_cond_w(base == MAP_FAILED, "could not map binary file '%s'.", path);
+    
+    if (base == MAP_FAILED)
+    {
+        return false;
+    }
+    
+    madvise(base, st.st_size, MADV_SEQUENTIAL);
+    
+    file->base   = base;
+    file->length = st.st_size;
+    
+    memcpy(&file->header, base, sizeof(binary_header));
+    
+    const binary_header& h = file->header;
+    
+    // validate the header before the chunk table is touched
+    ok = memcmp(h.magic, "PFSOFTB", 8) == 0 && h.byte_order == BINARY_BYTE_ORDER && h.version == BINARY_VERSION;
+    ok = ok && h.data_offset >= sizeof(binary_header) && h.chunks <= (h.data_offset - sizeof(binary_header)) / sizeof(uint64_t);
+    ok = ok && h.data_offset <= file->length && h.data_bytes <= file->length - h.data_offset;
+    
+    pfsoft_cond_w(!ok, "'%s' is not a PFSOFT binary file of this byte order and version.", path);
+    
+    if (ok)
+    {
+        file->sums = reinterpret_cast< const uint64_t* >(static_cast< const char* >(base) + sizeof(binary_header));
+        file->data = static_cast< const char* >(base) + h.data_offset;
+        
+        ok = header_checksum(h, file->sums) == h.checksum;
+        pfsoft_cond_w(!ok, "header checksum of binary file '%s' does not match.", path);
+    }
+    
+    if (ok)
+    {
+        ok = h.kind == kind && h.precision == precision;
+        pfsoft_cond_w(!ok, "binary file '%s' holds a different kind or precision of data.", path);
+    }
+    
+    if (!ok)
+    {
+        binary_close(file);
+    }
+    
+    return ok;
+}
+
+/*!
+ * @brief           Verifies the checksum of a chunk of an opened binary file
+ *
+ * @param[in]       file The opened file
+ * @param[in]       chunk The index of the chunk
+ * @param[in]       offset The offset of the chunk from the first element in bytes
+ * @param[in]       bytes The size of the chunk in bytes
+ * @return          True if the chunk lies inside the file and its checksum matches
+ *
+ * @since           1.0.0
+ */
+bool binary_check(const binary_file* file, const size_t& chunk, const size_t& offset, const size_t& bytes)
+{
+    if (chunk >= file->header.chunks || offset + bytes > file->header.data_bytes)
+    {
+        return false;
+    }
+    
+    return binary_checksum(file->data + offset, bytes) == file->sums[chunk];
+}
+
+/*!
+ * @brief           Unmaps an opened binary file
+ *
+ * @param[in,out]   file The opened file
+ *
+ * @since           1.0.0
+ */
+void binary_close(binary_file* file)
+{
+    if (file->base != nullptr)
+    {
+        munmap(file->base, file->length);
+    }
+    
+    file->base   = nullptr;
+    file->length = 0;
+}
+
+PFSOFT_END
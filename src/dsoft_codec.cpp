@@ -0,0 +1,541 @@
+//
+//  dsoft_codec.cpp
+//  PFSOFTlib
+//
+//   Created by Denis-Michael Lux on 05. November 2015.
+//
+//   This file is part of PFSOFTlib.
+//
+//   PFSOFTlib is free software: you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License as published by
+//   the Free Software Foundation, either version 3 of the License, or
+//   (at your option) any later version.
+//
+//   PFSOFTlib is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with PFSOFTlib.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <algorithm>
+
+#include <pfsoft>
+
+PFSOFT_BEGIN
+
+/*- Conversions between single and 16 bit floating point numbers -*/
+// Branch free so that the loops over a degree vectorize. Rounding is to
+// nearest even. The scaled parts never exceed 1, therefore overflow,
+// infinities and NaN do not occur.
+static inline uint16_t float_to_half(const float& f)
+{
+    uint32_t u;
+    memcpy(&u, &f, 4);
+    
+    const uint32_t sign = (u >> 16) & 0x8000u;
+    u &= 0x7fffffffu;
+    
+    // subnormal halfs: add a magic number so that the FPU does the rounding
+    const uint32_t magic_bits = ((127 - 15) + (23 - 10) + 1) << 23;
+    float magic, t;
+    memcpy(&magic, &magic_bits, 4);
+    memcpy(&t, &u, 4);
+    t += magic;
+    
+    uint32_t sub;
+    memcpy(&sub, &t, 4);
+    sub -= magic_bits;
+    
+    // normal halfs: rebias the exponent and round the mantissa
+    const uint32_t norm = (u + ((uint32_t)(15 - 127) << 23) + 0xfffu + ((u >> 13) & 1u)) >> 13;
+    
+    return static_cast< uint16_t >(sign | (u < (113u << 23) ? sub : norm));
+}
+
+static inline float half_to_float(const uint16_t& h)
+{
+    const uint32_t magic_bits = 113u << 23;
+    float magic;
+    memcpy(&magic, &magic_bits, 4);
+    
+    uint32_t o = static_cast< uint32_t >(h & 0x7fffu) << 13;
+    const uint32_t exp = o & (0x7c00u << 13);
+    
+    o += (127 - 15) << 23;
+    
+    // subnormal halfs are renormalized by the FPU
+    float f;
+    uint32_t sub = o + (1u << 23);
+    memcpy(&f, &sub, 4);
+    f -= magic;
+    memcpy(&sub, &f, 4);
+    
+    o = (exp == 0 ? sub : o) | (static_cast< uint32_t >(h & 0x8000u) << 16);
+    
+    memcpy(&f, &o, 4);
+    return f;
+}
+
+static inline uint16_t float_to_bfloat(const float& f)
+{
+    uint32_t u;
+    memcpy(&u, &f, 4);
+    
+    return static_cast< uint16_t >((u + 0x7fffu + ((u >> 16) & 1u)) >> 16);
+}
+
+static inline float bfloat_to_float(const uint16_t& b)
+{
+    const uint32_t u = static_cast< uint32_t >(b) << 16;
+    
+    float f;
+    memcpy(&f, &u, 4);
+    return f;
+}
+
+/*- Unaligned access to the packed parts -*/
+// The sizes of the encoded degrees are not padded, so with different bits per
+// degree the parts of a degree can start at any address. memcpy of a single
+// value compiles to a plain load or store.
+template< typename T >
+static inline T load(const unsigned char* p, const size_t& i)
+{
+    T v;
+    memcpy(&v, p + i * sizeof(T), sizeof(T));
+    return v;
+}
+
+template< typename T >
+static inline void store(unsigned char* p, const size_t& i, const T& v)
+{
+    memcpy(p + i * sizeof(T), &v, sizeof(T));
+}
+
+/*!
+ * @brief           Constructor for a codec with a 16 bit floating point format
+ * @details         For FIXED the parts are stored with 16 bits in every degree.
+ *
+ * @param[in]       t The storage format
+ */
+DSOFTCodec::DSOFTCodec(const format& t)
+    : type(t)
+    , bits(1, 16)
+{}
+
+/*!
+ * @brief           Constructor for a codec with fixed point parts
+ * @details         The entry \f$l\f$ of the given vector is the number of bits of
+ *                  every real and imaginary part of degree \f$l\f$. The last entry
+ *                  is used for all higher degrees.
+ *
+ * @param[in]       bits_per_degree The number of bits per degree, each within 2 and 32
+ */
+DSOFTCodec::DSOFTCodec(const std::vector< int >& bits_per_degree)
+    : type(FIXED)
+    , bits(bits_per_degree)
+{
+    pfsoft_cond_w(bits.empty(), "%s", "DSOFTCodec without bits per degree. Using 16 bits.");
+    
+    if (bits.empty())
+    {
+        bits.push_back(16);
+    }
+    
+    for (size_t i = 0; i < bits.size(); ++i)
+    {
+        pfsoft_cond_w(bits[i] < 2 || bits[i] > 32, "DSOFTCodec bits of degree %zu clamped to [2, 32].", i);
+        bits[i] = std::max(2, std::min(32, bits[i]));
+    }
+}
+
+/*!
+ * @brief           The number of bits of every part of a degree
+ *
+ * @param[in]       l The degree
+ * @return          The number of bits per real or imaginary part
+ */
+int DSOFTCodec::bits_of(const int& l) const
+{
+    if (type != FIXED)
+    {
+        return 16;
+    }
+    
+    return bits[std::min(static_cast< size_t >(l), bits.size() - 1)];
+}
+
+/*!
+ * @brief           Bound of the encoding error of a degree
+ * @details         Every real and imaginary part of the decoded coefficients of
+ *                  degree \f$l\f$ differs from the original one by at most the
+ *                  returned value.
+ *
+ * @param[in]       l The degree
+ * @param[in]       scale The scale \f$s_l\f$ of the degree, i.e. its largest part
+ * @return          The bound of the absolute error per part
+ */
+double DSOFTCodec::error_bound(const int& l, const double& scale) const
+{
+    switch (type)
+    {
+        case FLOAT16:
+            return ldexp(scale, -11);
+        case BFLOAT16:
+            return ldexp(scale, -8);
+        default:
+            return scale / (2. * (ldexp(1., bits_of(l) - 1) - 1));
+    }
+}
+
+/*!
+ * @brief           The size of an encoded degree in bytes
+ * @details         An encoded degree consists of the format, the number of bits,
+ *                  six bytes of padding, the scale as double and the
+ *                  \f$2(2l+1)^2\f$ packed parts.
+ *
+ * @param[in]       l The degree
+ * @param[in]       bits The number of bits per part
+ * @return          The size in bytes
+ */
+size_t DSOFT_encoded_degree_size(const int& l, const int& bits)
+{
+    const size_t parts = 2 * static_cast< size_t >(2 * l + 1) * (2 * l + 1);
+    return 16 + (parts * bits + 7) / 8;
+}
+
+/*!
+ * @brief           The size of all encoded degrees of a bandwidth in bytes
+ *
+ * @param[in]       bandwidth The bandwidth of the coefficients
+ * @param[in]       codec The codec
+ * @return          The size in bytes including the leading bandwidth
+ */
+size_t DSOFT_encoded_size(const int& bandwidth, const DSOFTCodec& codec)
+{
+    size_t bytes = sizeof(uint64_t);
+    for (int l = 0; l < bandwidth; ++l)
+    {
+        bytes += DSOFT_encoded_degree_size(l, codec.bits_of(l));
+    }
+    
+    return bytes;
+}
+
+/*!
+ * @brief           Encodes the coefficients of a single degree
+ * @details         The coefficients are given in the layout of the container. The
+ *                  scaling and rounding loops have no branches and vectorize, the
+ *                  parts of FIXED with 8, 16 or 32 bits are stored directly, other
+ *                  widths are packed into a bit stream.
+ *
+ * @param[in]       coef The \f$(2l+1)^2\f$ coefficients of the degree
+ * @param[in]       l The degree
+ * @param[in]       codec The codec
+ * @param[out]      out Memory of DSOFT_encoded_degree_size bytes
+ * @param[out]      bound If not null, the bound of the error of every part
+ */
+void DSOFT_encode_degree(const complex< double >* coef, const int& l, const DSOFTCodec& codec, unsigned char* out, double* bound)
+{
+    const int    bits  = codec.bits_of(l);
+    const size_t parts = 2 * static_cast< size_t >(2 * l + 1) * (2 * l + 1);
+    const double* x    = reinterpret_cast< const double* >(coef);
+    
+    // scale of the degree
+    double scale = 0;
+    for (size_t i = 0; i < parts; ++i)
+    {
+        scale = std::max(scale, std::abs(x[i]));
+    }
+    
+    scale = (scale > 0 ? scale : 1);
+    
+    memset(out, 0, 16);
+    out[0] = static_cast< unsigned char >(codec.type);
+    out[1] = static_cast< unsigned char >(bits);
+    memcpy(out + 8, &scale, sizeof(double));
+    
+    unsigned char* payload = out + 16;
+    const double   inv     = 1 / scale;
+    
+    if (codec.type == DSOFTCodec::FLOAT16 || codec.type == DSOFTCodec::BFLOAT16)
+    {
+        if (codec.type == DSOFTCodec::FLOAT16)
+        {
+            for (size_t i = 0; i < parts; ++i) { store(payload, i, float_to_half(static_cast< float >(x[i] * inv)));  }
+        }
+        else
+        {
+            for (size_t i = 0; i < parts; ++i) { store(payload, i, float_to_bfloat(static_cast< float >(x[i] * inv))); }
+        }
+    }
+    else
+    {
+        // round to the nearest integer in [-qmax, qmax]
+        const double qmax = ldexp(1., bits - 1) - 1;
+        
+        if (bits == 8 || bits == 16 || bits == 32)
+        {
+            for (size_t i = 0; i < parts; ++i)
+            {
+                const double  v = x[i] * inv * qmax;
+                const int64_t q = static_cast< int64_t >(v + (v < 0 ? -0.5 : 0.5));
+                
+                if      (bits == 8)  { store(payload, i, static_cast< int8_t  >(q)); }
+                else if (bits == 16) { store(payload, i, static_cast< int16_t >(q)); }
+                else                 { store(payload, i, static_cast< int32_t >(q)); }
+            }
+        }
+        else
+        {
+            // bit stream of two's complement values, least significant bits first
+            const uint64_t mask = (1ull << bits) - 1;
+            
+            uint64_t acc  = 0;
+            int      fill = 0;
+            size_t   pos  = 0;
+            
+            for (size_t i = 0; i < parts; ++i)
+            {
+                const double  v = x[i] * inv * qmax;
+                const int64_t q = static_cast< int64_t >(v + (v < 0 ? -0.5 : 0.5));
+                
+                acc  |= (static_cast< uint64_t >(q) & mask) << fill;
+                fill += bits;
+                
+                while (fill >= 8)
+                {
+                    payload[pos++] = static_cast< unsigned char >(acc);
+                    acc          >>= 8;
+                    fill          -= 8;
+                }
+            }
+            
+            if (fill > 0)
+            {
+                payload[pos] = static_cast< unsigned char >(acc);
+            }
+        }
+    }
+    
+    if (bound != nullptr)
+    {
+        *bound = codec.error_bound(l, scale);
+    }
+}
+
+/*!
+ * @brief           Decodes the coefficients of a single degree
+ *
+ * @param[in]       in The encoded degree
+ * @param[in]       bytes The number of bytes that are available at in
+ * @param[in]       l The degree
+ * @param[out]      coef Memory for the \f$(2l+1)^2\f$ coefficients of the degree
+ * @return          True if the degree could be decoded, false if it is malformed
+ */
+bool DSOFT_decode_degree(const unsigned char* in, const size_t& bytes, const int& l, complex< double >* coef)
+{
+    if (bytes < 16)
+    {
+        return false;
+    }
+    
+    const int type = in[0];
+    const int bits = in[1];
+    
+    if (type < DSOFTCodec::FIXED || type > DSOFTCodec::BFLOAT16 || bits < 2 || bits > 32 || (type != DSOFTCodec::FIXED && bits != 16))
+    {
+        return false;
+    }
+    
+    if (bytes < DSOFT_encoded_degree_size(l, bits))
+    {
+        return false;
+    }
+    
+    double scale;
+    memcpy(&scale, in + 8, sizeof(double));
+    
+    const size_t         parts   = 2 * static_cast< size_t >(2 * l + 1) * (2 * l + 1);
+    const unsigned char* payload = in + 16;
+    double*              x       = reinterpret_cast< double* >(coef);
+    
+    if (type == DSOFTCodec::FLOAT16)
+    {
+        for (size_t i = 0; i < parts; ++i) { x[i] = scale * half_to_float(load< uint16_t >(payload, i));   }
+    }
+    else if (type == DSOFTCodec::BFLOAT16)
+    {
+        for (size_t i = 0; i < parts; ++i) { x[i] = scale * bfloat_to_float(load< uint16_t >(payload, i)); }
+    }
+    else
+    {
+        const double step = scale / (ldexp(1., bits - 1) - 1);
+        
+        if (bits == 8)
+        {
+            for (size_t i = 0; i < parts; ++i) { x[i] = step * load< int8_t >(payload, i); }
+        }
+        else if (bits == 16)
+        {
+            for (size_t i = 0; i < parts; ++i) { x[i] = step * load< int16_t >(payload, i); }
+        }
+        else if (bits == 32)
+        {
+            for (size_t i = 0; i < parts; ++i) { x[i] = step * load< int32_t >(payload, i); }
+        }
+        else
+        {
+            const uint64_t mask = (1ull << bits) - 1;
+            const int      up   = 64 - bits;
+            
+            uint64_t acc  = 0;
+            int      fill = 0;
+            size_t   pos  = 0;
+            
+            for (size_t i = 0; i < parts; ++i)
+            {
+                while (fill < bits)
+                {
+                    acc  |= static_cast< uint64_t >(payload[pos++]) << fill;
+                    fill += 8;
+                }
+                
+                // sign extend the two's complement value
+                const int64_t q = static_cast< int64_t >((acc & mask) << up) >> up;
+                
+                acc  >>= bits;
+                fill  -= bits;
+                x[i]   = step * q;
+            }
+        }
+    }
+    
+    return true;
+}
+
+/*!
+ * @brief           Encodes all coefficients of a container
+ * @details         The encoding is the bandwidth as 64 bit integer followed by the
+ *                  encoded degrees \f$0, 1, \dots, B-1\f$. The offset of every degree
+ *                  is known from the codec, so the degrees are encoded in parallel.
+ *
+ * @param[in]       fc The Fourier coefficients
+ * @param[in]       codec The codec
+ * @param[out]      out The encoded coefficients
+ * @param[out]      bounds If not null, the error bound of every degree
+ * @param[in]       threads The number of threads used for encoding
+ * @return          The size of the encoding in bytes
+ *
+ * @sa              DSOFT_decode
+ *
+ * @ingroup         DSOFTFourierCoefficients
+ *
+ * @since           1.0.0
+ */
+size_t DSOFT_encode(const DSOFTFourierCoefficients& fc, const DSOFTCodec& codec, std::vector< unsigned char >& out, std::vector< double >* bounds, int threads)
+{
+    const int bandwidth = fc.bandwidth;
+    
+    // offsets of all degrees
+    std::vector< size_t > offsets(bandwidth + 1, sizeof(uint64_t));
+    for (int l = 0; l < bandwidth; ++l)
+    {
+        offsets[l + 1] = offsets[l] + DSOFT_encoded_degree_size(l, codec.bits_of(l));
+    }
+    
+    out.resize(offsets[bandwidth]);
+    
+    const uint64_t bw = bandwidth;
+    memcpy(out.data(), &bw, sizeof(uint64_t));
+    
+    if (bounds != nullptr)
+    {
+        bounds->resize(bandwidth);
+    }
+    
+    // largest degrees first
+    int l;
+    #pragma omp parallel for schedule(dynamic) num_threads(threads) if(threads > 1 && bandwidth > 8)
+    for (l = bandwidth - 1; l >= 0; --l)
+    {
+        DSOFT_encode_degree(&fc(l, 0, 0), l, codec, out.data() + offsets[l], bounds != nullptr ? &(*bounds)[l] : nullptr);
+    }
+    
+    return out.size();
+}
+
+/*!
+ * @brief           Decodes coefficients that were encoded by DSOFT_encode
+ * @details         The container is resized to the decoded bandwidth. If a
+ *                  bandlimit \f$L\f$ is given only the degrees \f$l < L\f$ are
+ *                  decoded. The container is left unchanged if the encoding is
+ *                  malformed.
+ *
+ * @param[in]       data The encoded coefficients
+ * @param[in]       bytes The size of the encoding in bytes
+ * @param[out]      fc The decoded Fourier coefficients
+ * @param[in]       bandlimit The number of degrees to decode, 0 decodes all degrees
+ * @param[in]       threads The number of threads used for decoding
+ * @return          True if the coefficients were decoded, false otherwise
+ *
+ * @sa              DSOFT_encode
+ *
+ * @ingroup         DSOFTFourierCoefficients
+ *
+ * @since           1.0.0
+ */
+bool DSOFT_decode(const unsigned char* data, const size_t& bytes, DSOFTFourierCoefficients& fc, const int& bandlimit, int threads)
+{
+    uint64_t bw = 0;
+    if (bytes >= sizeof(uint64_t))
+    {
+        memcpy(&bw, data, sizeof(uint64_t));
+    }
+    
+    // offsets of all degrees from the header of every degree
+    const int degrees = static_cast< int >(bandlimit > 0 ? std::min< uint64_t >(bandlimit, bw) : bw);
+    
+    std::vector< size_t > offsets(degrees + 1, sizeof(uint64_t));
+    
+    bool ok = bytes >= sizeof(uint64_t) && bw < (1u << 16);
+    for (int l = 0; ok && l < degrees; ++l)
+    {
+        ok = offsets[l] + 16 <= bytes && data[offsets[l] + 1] >= 2 && data[offsets[l] + 1] <= 32;
+        
+        if (ok)
+        {
+            offsets[l + 1] = offsets[l] + DSOFT_encoded_degree_size(l, data[offsets[l] + 1]);
+            ok             = offsets[l + 1] <= bytes;
+        }
+    }
+    
+    pfsoft_cond_w(!ok, "%s", "malformed DSOFT coefficient encoding.");
+    
+    if (!ok)
+    {
+        return false;
+    }
+    
+    DSOFTFourierCoefficients tmp(degrees);
+    
+    int l;
+    #pragma omp parallel for schedule(dynamic) num_threads(threads) if(threads > 1 && degrees > 8) reduction(&&:ok)
+    for (l = degrees - 1; l >= 0; --l)
+    {
+        ok = DSOFT_decode_degree(data + offsets[l], offsets[l + 1] - offsets[l], l, &tmp(l, 0, 0)) && ok;
+    }
+    
+    pfsoft_cond_w(!ok, "%s", "malformed DSOFT coefficient encoding.");
+    
+    if (ok)
+    {
+        fc.swap(tmp);
+    }
+    
+    return ok;
+}
+
+PFSOFT_END
@@ -20,6 +20,8 @@
 //   along with PFSOFTlib.  If not, see <http://www.gnu.org/licenses/>.
 //
 
+#include <algorithm>
+
 #include <pfsoft>
 
 PFSOFT_BEGIN
@@ -48,12 +50,7 @@ DSOFTFourierCoefficients::DSOFTFourierCoefficients()
 DSOFTFourierCoefficients::DSOFTFourierCoefficients(int bandlimit)
     : bandwidth(bandlimit)
 {
-    mem = new matrix< complex< double > >[bandlimit];
-    
-    for (int i = 0; i < bandlimit; ++i)
-    {
-        mem[i] = matrix< complex< double > >(2 * i + 1, 2 * i + 1);
-    }
+    mem = new complex< double >[offset(bandlimit)];
 }
 
 /*!
@@ -65,6 +62,206 @@ DSOFTFourierCoefficients::~DSOFTFourierCoefficients()
     delete [] mem;
 }
 
+/*!
+ * @brief           The position of the first coefficient of a degree in the
+ *                  storage of a container
+ * @details         The degrees are stored one after another, therefore the
+ *                  coefficients of degree \f$l\f$ start at
+ *                  \f[
+ *                      \sum\limits_{i=0}^{l-1}(2i+1)^2 = \frac{4l^3 - l}{3}
+ *                  \f]
+ *                  which is also the number of coefficients of a container of
+ *                  bandwidth \f$l\f$.
+ *
+ * @param[in]       l The degree
+ * @return          The offset of degree \f$l\f$
+ */
+size_t DSOFTFourierCoefficients::offset(const int& l)
+{
+    const size_t L = static_cast< size_t >(l);
+    return (4 * L * L * L - L) / 3;
+}
+
+/*!
+ * @brief           Writes the coefficients to a binary file
+ * @details         The file starts with a binary_header, followed by one checksum
+ *                  per degree and the coefficients in the layout of the container.
+ *                  The coefficients are written with a single gathered write and
+ *                  start at a page aligned offset, so they can be mapped directly.
+ *
+ * @param[in]       path The path of the file
+ * @return          True if the file was written, false otherwise
+ *
+ * @sa              DSOFTFourierCoefficients::load
+ */
+bool DSOFTFourierCoefficients::save(const char* path) const
+{
+    binary_header header;
+    memset(&header, 0, sizeof(header));
+    
+    header.kind      = BINARY_COEFFICIENTS;
+    header.precision = sizeof(double);
+    header.dims[0]   = bandwidth;
+    header.chunks    = bandwidth;
+    
+    // one chunk per degree
+    std::vector< size_t > chunks(bandwidth);
+    for (int l = 0; l < bandwidth; ++l)
+    {
+        chunks[l] = (2 * l + 1) * (2 * l + 1) * sizeof(complex< double >);
+    }
+    
+    return binary_write(path, header, mem, chunks.data());
+}
+
+/*!
+ * @brief           Writes the coefficients encoded by a DSOFTCodec to a binary file
+ * @details         Same as DSOFTFourierCoefficients::save, but every degree is a chunk
+ *                  encoded by DSOFT_encode_degree and the header is marked with
+ *                  layout 1. load decodes these files transparently.
+ *
+ * @param[in]       path The path of the file
+ * @param[in]       codec The codec for the coefficients
+ * @return          True if the file was written, false otherwise
+ *
+ * @sa              DSOFTFourierCoefficients::load
+ * @sa              DSOFT_encode
+ */
+bool DSOFTFourierCoefficients::save(const char* path, const DSOFTCodec& codec) const
+{
+    binary_header header;
+    memset(&header, 0, sizeof(header));
+    
+    header.kind      = BINARY_COEFFICIENTS;
+    header.precision = sizeof(double);
+    header.layout    = 1;
+    header.dims[0]   = bandwidth;
+    header.chunks    = bandwidth;
+    
+    std::vector< unsigned char > encoded;
+    DSOFT_encode(*this, codec, encoded);
+    
+    // one chunk per encoded degree without the leading bandwidth
+    std::vector< size_t > chunks(bandwidth);
+    for (int l = 0; l < bandwidth; ++l)
+    {
+        chunks[l] = DSOFT_encoded_degree_size(l, codec.bits_of(l));
+    }
+    
+    return binary_write(path, header, encoded.data() + sizeof(uint64_t), chunks.data());
+}
+
+/*!
+ * @brief           Reads the coefficients from a binary file
+ * @details         Maps a file that was written by DSOFTFourierCoefficients::save
+ *                  and copies the coefficients into the container, which is resized
+ *                  to the bandwidth that is loaded. If a bandlimit \f$L\f$ is given
+ *                  only the degrees \f$l < L\f$ are read and verified, the rest of
+ *                  the file is never touched. The checksum of every loaded degree is
+ *                  verified. Files with encoded coefficients are decoded. The
+ *                  container is left unchanged if reading fails.
+ *
+ * @param[in]       path The path of the file
+ * @param[in]       bandlimit The number of degrees to load, 0 loads all degrees of the file
+ * @return          True if the coefficients were read, false otherwise
+ *
+ * @sa              DSOFTFourierCoefficients::save
+ */
+bool DSOFTFourierCoefficients::load(const char* path, const int& bandlimit)
+{
+    binary_file file;
+    if (!binary_open(&file, path, BINARY_COEFFICIENTS, sizeof(double)))
+    {
+        return false;
+    }
+    
+    const int  available = static_cast< int >(file.header.dims[0]);
+    const int  degrees   = (bandlimit > 0 ? std::min(bandlimit, available) : available);
+    const bool encoded   = file.header.layout == 1;
+    
+    // chunk offsets of the loaded degrees
+    std::vector< size_t > offsets(degrees + 1, 0);
+    
+    bool ok = file.header.chunks == static_cast< uint64_t >(available) && file.header.layout <= 1;
+    ok      = ok && (encoded || file.header.data_bytes == offset(available) * sizeof(complex< double >));
+    
+    for (int l = 0; ok && l < degrees; ++l)
+    {
+        if (encoded)
+        {
+            // the number of bits is stored in the second byte of every degree
+            ok = offsets[l] + 16 <= file.header.data_bytes;
+            
+            const int bits = (ok ? static_cast< unsigned char >(file.data[offsets[l] + 1]) : 0);
+            
+            ok             = ok && bits >= 2 && bits <= 32;
+            offsets[l + 1] = offsets[l] + (ok ? DSOFT_encoded_degree_size(l, bits) : 0);
+        }
+        else
+        {
+            offsets[l + 1] = offset(l + 1) * sizeof(complex< double >);
+        }
+        
+        // verify the loaded degrees
+        ok = ok && binary_check(&file, l, offsets[l], offsets[l + 1] - offsets[l]);
+    }
+    
+    // decode into new storage, so the container stays unchanged if a
+    // degree is malformed
+    complex< double >* loaded = nullptr;
+    
+    if (ok)
+    {
+        loaded = new complex< double >[offset(degrees)];
+        
+        if (encoded)
+        {
+            const unsigned char* data = reinterpret_cast< const unsigned char* >(file.data);
+            for (int l = 0; ok && l < degrees; ++l)
+            {
+                ok = DSOFT_decode_degree(data + offsets[l], offsets[l + 1] - offsets[l], l, loaded + offset(l));
+            }
+        }
+        else
+        {
+            memcpy(reinterpret_cast< char* >(loaded), file.data, offset(degrees) * sizeof(complex< double >));
+        }
+    }
+    
+    pfsoft_cond_w(!ok, "coefficients in binary file '%s' are corrupted.", path);
+    
+    if (ok)
+    {
+        delete [] mem;
+        
+        mem                   = loaded;
+        access::rw(bandwidth) = degrees;
+    }
+    else
+    {
+        delete [] loaded;
+    }
+    
+    binary_close(&file);
+    
+    return ok;
+}
+
+/*!
+ * @brief           Exchanges the coefficients of two containers
+ * @details         Only the storage is exchanged, no coefficient is copied.
+ *
+ * @param[in,out]   other The other container
+ */
+void DSOFTFourierCoefficients::swap(DSOFTFourierCoefficients& other)
+{
+    std::swap(mem, other.mem);
+    
+    const int tmp               = bandwidth;
+    access::rw(bandwidth)       = other.bandwidth;
+    access::rw(other.bandwidth) = tmp;
+}
+
 /*!
  * @brief           Accessor operator for the DSOFTFourierCoefficients manager
  * @details         Makes the memory for the coefficents accessable by using
@@ -82,10 +279,11 @@ complex< double >& DSOFTFourierCoefficients::operator()(const int& l, const int&
     pfsoft_cond_e(M > l || Mp > l || M < -l || Mp < -l, "%s", "illegal parameter for DSOFTFourierCoefficients. Condition |M|,|Mp| <= l violated.");
     
     // if M or Mp are negative count from behind
-    size_t idx_M  = (M  >= 0 ? M  : mem[l].rows + M );
-    size_t idx_Mp = (Mp >= 0 ? Mp : mem[l].cols + Mp);
+    const size_t dim    = 2 * l + 1;
+    const size_t idx_M  = (M  >= 0 ? M  : dim + M );
+    const size_t idx_Mp = (Mp >= 0 ? Mp : dim + Mp);
     
-    return mem[l](idx_M, idx_Mp);
+    return mem[offset(l) + idx_Mp * dim + idx_M];
 }
 
 /*!
@@ -105,10 +303,11 @@ const complex< double >& DSOFTFourierCoefficients::operator()(const int& l, cons
     pfsoft_cond_e(M > l || Mp > l || M < -l || Mp < -l, "%s", "illegal parameter for DSOFTFourierCoefficients. Condition |M|,|Mp| <= l violated.");
     
     // if M or Mp are negative count from behind
-    size_t idx_M  = (M  >= 0 ? M  : mem[l].rows + M );
-    size_t idx_Mp = (Mp >= 0 ? Mp : mem[l].cols + Mp);
+    const size_t dim    = 2 * l + 1;
+    const size_t idx_M  = (M  >= 0 ? M  : dim + M );
+    const size_t idx_Mp = (Mp >= 0 ? Mp : dim + Mp);
     
-    return mem[l](idx_M, idx_Mp);
+    return mem[offset(l) + idx_Mp * dim + idx_M];
 }
 
 /*!
@@ -128,8 +327,18 @@ std::ostream& operator<<(std::ostream& o, const DSOFTFourierCoefficients& fc)
     
     for (int i = 0; i < fc.bandwidth; ++i)
     {
+        // degree i as matrix
+        const size_t dim = 2 * i + 1;
+        const size_t off = DSOFTFourierCoefficients::offset(i);
+        
+        matrix< complex< double > > degree(dim, dim);
+        for (size_t j = 0; j < dim * dim; ++j)
+        {
+            degree(j % dim, j / dim) = fc.mem[off + j];
+        }
+        
         o << "DSOFTFourierCoefficients[M_{0,1,2,...,-2,-1} x M'_{0,1,2,...,-2,-1}] ~> [l = " << i << "]" << std::endl;
-        o << fc.mem[i] << std::endl;
+        o << degree << std::endl;
     }
     
     std::cout.flags( f );
@@ -0,0 +1,496 @@
+//
+//  dsoft_profile.cpp
+//  PFSOFTlib
+//
+//   Created by Denis-Michael Lux on 05. November 2015.
+//
+//   This file is part of PFSOFTlib.
+//
+//   PFSOFTlib is free software: you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License as published by
+//   the Free Software Foundation, either version 3 of the License, or
+//   (at your option) any later version.
+//
+//   PFSOFTlib is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with PFSOFTlib.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <algorithm>
+
+#include <pfsoft>
+
+PFSOFT_NAMESPACE(FourierTransforms)
+
+/*!
+ * @brief           Tuning profile consulted by the transforms
+ * @details         Stores the parallel crossover bandwidth and the number of
+ *                  threads that performed best for every tuned bandwidth. The
+ *                  entries are sorted by bandwidth. An empty profile means that
+ *                  the compile-time DSOFT_THRESHOLD is used. The DWT runs in double
+ *                  instead of long double precision up to the double_dwt bandwidth.
+ */
+struct dsoft_profile
+{
+    int threshold;                  //!< Smallest bandwidth that runs in parallel
+    std::vector< int > bandwidths;  //!< Tuned bandwidths in ascending order
+    std::vector< int > threads;     //!< Best number of threads per tuned bandwidth
+    bool loaded;                    //!< Whether the profile holds tuned values
+    int double_dwt;                 //!< Largest bandwidth with a double precision DWT
+};
+
+static std::shared_ptr< const dsoft_profile > profile = std::make_shared< const dsoft_profile >(dsoft_profile { DSOFT_THRESHOLD, {}, {}, false, 0 });
+static std::mutex                              profile_mutex;
+static std::once_flag                          profile_env_flag;
+
+// Whether DSOFT_autotune measures on the calling thread right now. Only the
+// transforms of the tuning thread ignore the profile. They run the DWT in
+// double precision if tuning_double is set.
+static thread_local bool tuning        = false;
+static thread_local bool tuning_double = false;
+
+/*!
+ * @brief           Marks the calling thread as tuning thread while in scope
+ */
+struct tuning_scope
+{
+    tuning_scope()  { tuning = true;                          }
+    ~tuning_scope() { tuning = false; tuning_double = false;  }
+};
+
+/*!
+ * @brief           The profile that is consulted by the transforms
+ * @details         Published profiles are never modified. A reader keeps its
+ *                  profile alive until it drops the returned pointer, even if a
+ *                  newer profile gets published meanwhile.
+ */
+static std::shared_ptr< const dsoft_profile > current_profile()
+{
+    return std::atomic_load(&profile);
+}
+
+/*!
+ * @brief           Makes the given profile the one consulted by the transforms
+ * @details         The caller has to hold profile_mutex.
+ */
+static void publish_profile(dsoft_profile p)
+{
+    std::atomic_store(&profile, std::make_shared< const dsoft_profile >(std::move(p)));
+}
+
+/*!
+ * @brief           Loads the profile named by the PFSOFT_PROFILE environment
+ *                  variable once per process.
+ */
+static void load_env_profile()
+{
+    std::call_once(profile_env_flag, []
+    {
+        const char* path = getenv("PFSOFT_PROFILE");
+        if (path != nullptr && *path != '\0')
+        {
+            DSOFT_load_profile(path);
+        }
+    });
+}
+
+/*!
+ * @brief           Loads a tuning profile for the DSOFT and IDSOFT
+ * @details         Reads a profile file that was written by DSOFT_autotune and
+ *                  makes it the profile that is consulted by the transforms. If
+ *                  the environment variable PFSOFT_PROFILE names a profile file it
+ *                  is loaded automatically before the first transform runs. The
+ *                  bandwidth entries may appear in any order. Of several entries
+ *                  for the same bandwidth the last one is used.
+ *
+ * @param[in]       path The path of the profile file
+ * @return          True if the profile could be read, false otherwise. The
+ *                  current profile stays untouched if reading failed.
+ *
+ * @sa              DSOFT_autotune
+ *
+ * @ingroup         FourierTransforms
+ *
+ * @since           1.0.0
+ */
+bool DSOFT_load_profile(const char* path)
+{
+    FILE* fp = fopen(path, "r");
+    pfsoft_cond_w(fp == nullptr, "could not open DSOFT profile '%s'.", path);
+    
+    if (fp == nullptr)
+    {
+        return false;
+    }
+    
+    dsoft_profile tmp = { DSOFT_THRESHOLD, {}, {}, true, 0 };
+    
+    char line[256];
+    int  max_threads = 0;
+    while (fgets(line, sizeof(line), fp) != nullptr)
+    {
+        int b, t;
+        
+        // skip comments and empty lines
+        if (line[0] == '#' || line[0] == '\n')
+        {
+            continue;
+        }
+        
+        if (sscanf(line, "max_threads %d", &t) == 1)
+        {
+            max_threads = t;
+        }
+        else if (sscanf(line, "threshold %d", &b) == 1)
+        {
+            tmp.threshold = b;
+        }
+        else if (sscanf(line, "double_dwt %d", &b) == 1)
+        {
+            tmp.double_dwt = b;
+        }
+        else if (sscanf(line, "%d %d", &b, &t) == 2 && b > 0 && t > 0)
+        {
+            tmp.bandwidths.push_back(b);
+            tmp.threads.push_back(t);
+        }
+    }
+    
+    fclose(fp);
+    
+    // sort the entries by bandwidth. Of several entries for one bandwidth the
+    // last one in the file is kept.
+    std::vector< std::pair< int, int > > entries;
+    for (size_t i = 0; i < tmp.bandwidths.size(); ++i)
+    {
+        entries.push_back(std::make_pair(tmp.bandwidths[i], tmp.threads[i]));
+    }
+    
+    std::stable_sort(entries.begin(), entries.end(), [](const std::pair< int, int >& a, const std::pair< int, int >& b) { return a.first < b.first; });
+    
+    tmp.bandwidths.clear();
+    tmp.threads.clear();
+    
+    bool duplicates = false;
+    for (size_t i = 0; i < entries.size(); ++i)
+    {
+        if (!tmp.bandwidths.empty() && tmp.bandwidths.back() == entries[i].first)
+        {
+            tmp.threads.back() = entries[i].second;
+            duplicates         = true;
+            continue;
+        }
+        
+        tmp.bandwidths.push_back(entries[i].first);
+        tmp.threads.push_back(entries[i].second);
+    }
+    
+    pfsoft_cond_w(duplicates, "DSOFT profile '%s' contains several entries for a bandwidth. The last one is used.", path);
+    pfsoft_cond_w(tmp.bandwidths.empty(), "DSOFT profile '%s' does not contain any tuned bandwidth.", path);
+    pfsoft_cond_w(max_threads != 0 && max_threads != PFSOFT_MAX_THREADS, "DSOFT profile '%s' was tuned for %d threads but %d are available.", path, max_threads, PFSOFT_MAX_THREADS);
+    
+    if (tmp.bandwidths.empty())
+    {
+        return false;
+    }
+    
+    std::lock_guard< std::mutex > lock(profile_mutex);
+    publish_profile(std::move(tmp));
+    
+    return true;
+}
+
+/*!
+ * @brief           The number of threads the DSOFT and IDSOFT use for a bandwidth
+ * @details         Consults the loaded tuning profile. The entry of the largest
+ *                  tuned bandwidth that does not exceed the given bandwidth is used,
+ *                  and the smallest entry for bandwidths below all tuned ones. The
+ *                  result never exceeds the requested number of threads. Without a
+ *                  profile the requested number of threads is returned unchanged.
+ *
+ * @param[in]       bandwidth The bandwidth of the transform
+ * @param[in]       threads The number of threads requested by the caller
+ * @return          The number of threads that should be used
+ *
+ * @ingroup         FourierTransforms
+ *
+ * @since           1.0.0
+ */
+int DSOFT_threads(const int& bandwidth, const int& threads)
+{
+    load_env_profile();
+    
+    std::shared_ptr< const dsoft_profile > p = current_profile();
+    if (!p->loaded || tuning)
+    {
+        return threads;
+    }
+    
+    // find the last tuned bandwidth that is not larger than the given one
+    size_t idx = std::upper_bound(p->bandwidths.begin(), p->bandwidths.end(), bandwidth) - p->bandwidths.begin();
+    idx        = (idx == 0 ? 0 : idx - 1);
+    
+    return std::max(1, std::min(threads, p->threads[idx]));
+}
+
+/*!
+ * @brief           The smallest bandwidth for which the (M, M') loops of the
+ *                  DSOFT and IDSOFT run in parallel
+ * @details         Returns the crossover of the loaded tuning profile, or the
+ *                  compile-time DSOFT_THRESHOLD if no profile is loaded.
+ *
+ * @return          The parallel crossover bandwidth
+ *
+ * @ingroup         FourierTransforms
+ *
+ * @since           1.0.0
+ */
+int DSOFT_threshold()
+{
+    load_env_profile();
+    
+    if (tuning)
+    {
+        return 0;
+    }
+    
+    return current_profile()->threshold;
+}
+
+/*!
+ * @brief           Whether the DWT of the DSOFT and IDSOFT runs in double precision
+ *                  for a bandwidth
+ * @details         The DWT runs in long double precision by default. In double
+ *                  precision the wigner d-matrices, their flips and the products
+ *                  with the \f$\beta\f$-lines use the SIMD kernels instead of the
+ *                  x87 unit, at the price of a larger rounding error that grows
+ *                  with the bandwidth. DSOFT_autotune enables it only up to the
+ *                  largest bandwidth whose round trip error stays close to the one
+ *                  of long double precision.
+ *
+ * @param[in]       bandwidth The bandwidth of the transform
+ * @return          True if the bandwidth does not exceed the double_dwt bandwidth
+ *                  of the current profile
+ *
+ * @sa              DSOFT_set_double_dwt
+ *
+ * @ingroup         FourierTransforms
+ *
+ * @since           1.0.0
+ */
+bool DSOFT_double_dwt(const int& bandwidth)
+{
+    load_env_profile();
+    
+    if (tuning)
+    {
+        return tuning_double;
+    }
+    
+    return bandwidth <= current_profile()->double_dwt;
+}
+
+/*!
+ * @brief           Sets the largest bandwidth for which the DWT of the DSOFT and
+ *                  IDSOFT runs in double precision
+ * @details         Publishes a copy of the current profile with the given value,
+ *                  so transforms that already run keep their precision. A value
+ *                  of 0 restores the long double DWT for all bandwidths.
+ *
+ * @param[in]       bandwidth The largest bandwidth with a double precision DWT
+ *
+ * @sa              DSOFT_double_dwt
+ *
+ * @ingroup         FourierTransforms
+ *
+ * @since           1.0.0
+ */
+void DSOFT_set_double_dwt(const int& bandwidth)
+{
+    load_env_profile();
+    
+    std::lock_guard< std::mutex > lock(profile_mutex);
+    
+    dsoft_profile p = *current_profile();
+    p.double_dwt    = bandwidth;
+    
+    publish_profile(std::move(p));
+}
+
+/*!
+ * @brief           Tunes the number of threads of the DSOFT and IDSOFT per bandwidth
+ * @details         Measures a forward and an inverse transform for every bandwidth
+ *                  \f$B_{min}, B_{min} + s, \dots, B_{max}\f$ serially and with 2, 4,
+ *                  8, ... up to the given number of threads. The fastest number of
+ *                  threads is stored per bandwidth. The smallest bandwidth for which
+ *                  a parallel run wins becomes the parallel crossover. The DWT runs
+ *                  in double precision up to the largest bandwidth below which every
+ *                  round trip with it was faster and at most ten times less accurate
+ *                  than with the long double DWT, see DSOFT_double_dwt. The result is
+ *                  written to the given profile file and loaded afterwards.
+ *
+ *                  This function is meant to run once at startup or install time.
+ *                  Only the transforms of the tuning thread ignore the profile,
+ *                  transforms that run concurrently on other threads keep using
+ *                  the current one.
+ *
+ * @param[in]       min_bandwidth The smallest bandwidth that gets tuned
+ * @param[in]       max_bandwidth The largest bandwidth that gets tuned
+ * @param[in]       step The distance between two tuned bandwidths
+ * @param[in]       path The path of the profile file that gets written
+ * @param[in]       threads The maximum number of threads that gets tried
+ * @param[in]       runs The number of runs per measurement. The fastest run is taken.
+ * @return          True if the profile could be written, false otherwise
+ *
+ * @sa              DSOFT_load_profile
+ *
+ * @ingroup         FourierTransforms
+ *
+ * @since           1.0.0
+ */
+bool DSOFT_autotune(const int& min_bandwidth, const int& max_bandwidth, const int& step, const char* path, int threads, int runs)
+{
+    pfsoft_cond_w(min_bandwidth < 2 || max_bandwidth < min_bandwidth || step < 1, "%s", "invalid bandwidth range for DSOFT_autotune.");
+    
+    if (min_bandwidth < 2 || max_bandwidth < min_bandwidth || step < 1)
+    {
+        return false;
+    }
+    
+    // candidate numbers of threads are powers of two and the maximum
+    std::vector< int > candidates;
+    for (int t = 1; t < threads; t *= 2)
+    {
+        candidates.push_back(t);
+    }
+    candidates.push_back(std::max(1, threads));
+    
+    tuning_scope scope;
+    
+    dsoft_profile tuned = { max_bandwidth + 1, {}, {}, true, 0 };
+    
+    // the double precision DWT stays enabled while it passes every bandwidth
+    bool double_dwt = true;
+    
+    for (int bandwidth = min_bandwidth; bandwidth <= max_bandwidth; bandwidth += step)
+    {
+        // create a sample from random coefficients
+        grid3D< complex< double > > sample(2 * bandwidth);
+        DSOFTFourierCoefficients coef(bandwidth);
+        
+        uniform_real_distribution< double > ctx;
+        ctx.min = -1;
+        ctx.max = +1;
+        
+        rand(coef, ctx);
+        IDSOFT(coef, sample, 1);
+        
+        // measure each candidate and keep the fastest one
+        int    best_threads = 1;
+        double best_time    = 0;
+        for (size_t c = 0; c < candidates.size(); ++c)
+        {
+            double fastest = 0;
+            for (int r = 0; r < runs; ++r)
+            {
+                stopwatch sw = stopwatch::tic();
+                DSOFT(sample, coef, candidates[c]);
+                IDSOFT(coef, sample, candidates[c]);
+                double time  = sw.toc();
+                
+                fastest = (r == 0 || time < fastest ? time : fastest);
+            }
+            
+            if (c == 0 || fastest < best_time)
+            {
+                best_time    = fastest;
+                best_threads = candidates[c];
+            }
+        }
+        
+        tuned.bandwidths.push_back(bandwidth);
+        tuned.threads.push_back(best_threads);
+        
+        // accuracy guard of the double precision DWT. The round trip has to be
+        // faster and its error must stay within ten times the one of the long
+        // double DWT.
+        double error[2], time[2];
+        for (int d = 0; d < 2 && double_dwt; ++d)
+        {
+            tuning_double = (d == 1);
+            
+            DSOFTFourierCoefficients rec(bandwidth);
+            for (int r = 0; r < runs; ++r)
+            {
+                stopwatch sw = stopwatch::tic();
+                IDSOFT(coef, sample, best_threads);
+                DSOFT(sample, rec, best_threads);
+                double t     = sw.toc();
+                
+                time[d] = (r == 0 || t < time[d] ? t : time[d]);
+            }
+            
+            error[d] = 0;
+            for (int l = 0; l < bandwidth; ++l)
+            {
+                for (int M = -l; M <= l; ++M)
+                {
+                    for (int Mp = -l; Mp <= l; ++Mp)
+                    {
+                        error[d] = std::max(error[d], std::abs(rec(l, M, Mp).re - coef(l, M, Mp).re));
+                        error[d] = std::max(error[d], std::abs(rec(l, M, Mp).im - coef(l, M, Mp).im));
+                    }
+                }
+            }
+        }
+        
+        tuning_double = false;
+        double_dwt    = double_dwt && time[1] < time[0] && error[1] <= 10 * std::max(error[0], 1e-15);
+        
+        if (double_dwt)
+        {
+            tuned.double_dwt = bandwidth;
+        }
+        
+        if (best_threads > 1 && tuned.threshold > max_bandwidth)
+        {
+            tuned.threshold = bandwidth;
+        }
+    }
+    
+    // write profile
+    FILE* fp = fopen(path, "w");
+    pfsoft_cond_w(fp == nullptr, "could not write DSOFT profile '%s'.", path);
+    
+    if (fp != nullptr)
+    {
+        fprintf(fp, "# PFSOFTlib %d.%d.%d DSOFT tuning profile\n", PFSOFT_MAJOR, PFSOFT_MINOR, PFSOFT_PATCH);
+        fprintf(fp, "# arch %s, double precision\n", PFSOFT_PROJECT_ARCH);
+        fprintf(fp, "max_threads %d\n", PFSOFT_MAX_THREADS);
+        fprintf(fp, "threshold %d\n", tuned.threshold);
+        fprintf(fp, "double_dwt %d\n", tuned.double_dwt);
+        fprintf(fp, "# bandwidth threads\n");
+        
+        for (size_t i = 0; i < tuned.bandwidths.size(); ++i)
+        {
+            fprintf(fp, "%d %d\n", tuned.bandwidths[i], tuned.threads[i]);
+        }
+        
+        fclose(fp);
+    }
+    
+    std::lock_guard< std::mutex > lock(profile_mutex);
+    publish_profile(std::move(tuned));
+    
+    return fp != nullptr;
+}
+
+PFSOFT_NAMESPACE_END
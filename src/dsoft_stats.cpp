@@ -0,0 +1,188 @@
+//
+//  dsoft_stats.cpp
+//  PFSOFTlib
+//
+//   Created by Denis-Michael Lux on 05. November 2015.
+//
+//   This file is part of PFSOFTlib.
+//
+//   PFSOFTlib is free software: you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License as published by
+//   the Free Software Foundation, either version 3 of the License, or
+//   (at your option) any later version.
+//
+//   PFSOFTlib is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with PFSOFTlib.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <pfsoft>
+
+PFSOFT_BEGIN
+
+/*!
+ * @brief           Creates empty stats
+ */
+DSOFTStats::DSOFTStats()
+{
+    reset();
+}
+
+/*!
+ * @brief           Clears all times for a new call
+ * @param[in]       bw The bandwidth of the transformed grid
+ * @param[in]       nthreads The number of threads of the (M, M') loops
+ */
+void DSOFTStats::reset(const int& bw, const int& nthreads)
+{
+    enabled   = PFSOFT_STATS;
+    bandwidth = bw;
+    threads   = nthreads;
+    total     = 0;
+    loops     = 0;
+    
+    for (int s = 0; s < STAGES; ++s)
+    {
+        time[s] = 0;
+    }
+    
+    busy.assign(nthreads, 0);
+}
+
+/*!
+ * @brief           The name of a stage
+ */
+const char* DSOFTStats::name(const int& s)
+{
+    static const char* names[STAGES] = { "fft", "wigner", "dwt", "scatter" };
+    
+    return (s >= 0 && s < STAGES ? names[s] : "unknown");
+}
+
+/*!
+ * @brief           Prints the breakdown as a table
+ * @details         Every stage is printed with its share of the summed stage
+ *                  times. The busy time of every thread is printed relative to
+ *                  the wall time of the (M, M') loops.
+ *
+ * @param[in]       fp The file to print to
+ */
+void DSOFTStats::print(FILE* fp) const
+{
+    fprintf(fp, "| B %d, %d threads, total %e s\n", bandwidth, threads, total);
+    
+    if (!enabled)
+    {
+        fprintf(fp, "| stage times not recorded, build with PFSOFT_STATS\n");
+        return;
+    }
+    
+    double sum = 0;
+    for (int s = 0; s < STAGES; ++s)
+    {
+        sum += time[s];
+    }
+    
+    for (int s = 0; s < STAGES; ++s)
+    {
+        fprintf(fp, "| %-8s %e s (%5.1f%%)\n", name(s), time[s], sum > 0 ? 100 * time[s] / sum : 0);
+    }
+    
+    fprintf(fp, "| loops    %e s\n", loops);
+    
+    for (size_t t = 0; t < busy.size(); ++t)
+    {
+        fprintf(fp, "| thread %2d busy %e s (%5.1f%%)\n", static_cast< int >(t), busy[t], loops > 0 ? 100 * busy[t] / loops : 0);
+    }
+}
+
+/*!
+ * @brief           Starts the first lap
+ * @param[in]       s The stats of the call or nullptr if not recorded
+ */
+DSOFTStatsTimer::DSOFTStatsTimer(DSOFTStats* s)
+    : stats(s)
+    , trace(DSOFTTrace::recording())
+    , last(s != nullptr || trace ? now() : 0)
+    , start(last)
+    , M(-1)
+    , Mp(-1)
+{
+    for (int i = 0; i < DSOFTStats::STAGES; ++i)
+    {
+        time[i] = 0;
+    }
+}
+
+/*!
+ * @brief           Starts the next (M, M') group of the calling thread
+ * @details         The previous group ends with its last lap, so no clock is read.
+ *                  Groups are only used for the recorded events.
+ *
+ * @param[in]       m The order M of the group
+ * @param[in]       mp The order M' of the group
+ */
+void DSOFTStatsTimer::group(const int& m, const int& mp)
+{
+    if (!trace)
+    {
+        return;
+    }
+    
+    if (M >= 0)
+    {
+        DSOFTTrace::record("group", start, last, M, Mp);
+    }
+    
+    start = last;
+    M     = m;
+    Mp    = mp;
+}
+
+/*!
+ * @brief           Adds the laps to the stats of the call
+ * @details         May be called by several threads at once. Records the last
+ *                  (M, M') group of the thread if events are recorded.
+ *
+ * @param[in]       busy Whether the laps are the share of the calling thread in
+ *                  the (M, M') loops
+ */
+void DSOFTStatsTimer::merge(const bool& busy)
+{
+    if (trace && M >= 0)
+    {
+        DSOFTTrace::record("group", start, last, M, Mp);
+    }
+    
+    if (stats == nullptr)
+    {
+        return;
+    }
+    
+    int thread = 0;
+    #ifdef _OPENMP
+    thread = omp_get_thread_num();
+    #endif
+    
+    double sum = 0;
+    
+    #pragma omp critical(pfsoft_stats)
+    {
+        for (int s = 0; s < DSOFTStats::STAGES; ++s)
+        {
+            stats->time[s] += time[s];
+            sum            += time[s];
+        }
+        
+        if (busy && thread < static_cast< int >(stats->busy.size()))
+        {
+            stats->busy[thread] += sum;
+        }
+    }
+}
+
+PFSOFT_END
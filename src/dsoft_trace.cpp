@@ -0,0 +1,198 @@
+//
+//  dsoft_trace.cpp
+//  PFSOFTlib
+//
+//   Created by Denis-Michael Lux on 05. November 2015.
+//
+//   This file is part of PFSOFTlib.
+//
+//   PFSOFTlib is free software: you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License as published by
+//   the Free Software Foundation, either version 3 of the License, or
+//   (at your option) any later version.
+//
+//   PFSOFTlib is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with PFSOFTlib.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+#include <pfsoft>
+
+PFSOFT_BEGIN
+
+/*!
+ * @brief           The events of one thread
+ */
+struct trace_buffer
+{
+    int                            tid;         //!< Index of the thread in the trace
+    unsigned                       generation;  //!< The recording the events belong to
+    std::vector< DSOFTTraceEvent > events;      //!< The recorded events
+};
+
+static std::atomic< bool >                          trace_on(false);
+static std::atomic< unsigned >                      trace_generation(0);
+static double                                       trace_origin = 0;
+static std::mutex                                   trace_mutex;
+static std::vector< std::unique_ptr< trace_buffer > > trace_buffers;
+
+// buffer of the calling thread, registered on its first event
+static thread_local trace_buffer*                   trace_local = nullptr;
+
+/*!
+ * @brief           Discards all events and starts recording
+ * @details         Only the owning thread touches a buffer while recording. start()
+ *                  begins a new generation of the trace, and every thread clears
+ *                  its own buffer on its first event of the new generation.
+ *                  Buffers of older generations are ignored by size() and write().
+ */
+void DSOFTTrace::start()
+{
+    std::lock_guard< std::mutex > lock(trace_mutex);
+    
+    trace_origin = DSOFTStatsTimer::now();
+    trace_generation.fetch_add(1);
+    trace_on     = true;
+    
+    pfsoft_cond_w(!PFSOFT_STATS, "%s", "tracing requires a library built with PFSOFT_STATS. No events will be recorded.");
+}
+
+/*!
+ * @brief           Stops recording. The events are kept until the next start().
+ */
+void DSOFTTrace::stop()
+{
+    trace_on = false;
+}
+
+/*!
+ * @brief           Whether the transforms record events right now
+ */
+bool DSOFTTrace::recording()
+{
+    return trace_on.load(std::memory_order_relaxed);
+}
+
+/*!
+ * @brief           The number of recorded events of all threads
+ */
+size_t DSOFTTrace::size()
+{
+    std::lock_guard< std::mutex > lock(trace_mutex);
+    
+    const unsigned generation = trace_generation.load();
+    
+    size_t n = 0;
+    for (size_t i = 0; i < trace_buffers.size(); ++i)
+    {
+        n += (trace_buffers[i]->generation == generation ? trace_buffers[i]->events.size() : 0);
+    }
+    
+    return n;
+}
+
+/*!
+ * @brief           Records an event of the calling thread
+ * @details         Only takes a lock the first time a thread records an event.
+ *                  Clears the buffer of the thread on its first event after start().
+ *
+ * @param[in]       name Static name of the event
+ * @param[in]       begin Start time from DSOFTStatsTimer::now()
+ * @param[in]       end End time from DSOFTStatsTimer::now()
+ * @param[in]       M Order M of a (M, M') group or -1
+ * @param[in]       Mp Order M' of a (M, M') group or -1
+ */
+void DSOFTTrace::record(const char* name, const double& begin, const double& end, const int& M, const int& Mp)
+{
+    if (trace_local == nullptr)
+    {
+        std::lock_guard< std::mutex > lock(trace_mutex);
+        
+        trace_buffers.push_back(std::unique_ptr< trace_buffer >(new trace_buffer));
+        trace_local             = trace_buffers.back().get();
+        trace_local->tid        = static_cast< int >(trace_buffers.size()) - 1;
+        trace_local->generation = trace_generation.load();
+    }
+    
+    const unsigned generation = trace_generation.load(std::memory_order_relaxed);
+    if (trace_local->generation != generation)
+    {
+        trace_local->events.clear();
+        trace_local->generation = generation;
+    }
+    
+    DSOFTTraceEvent e = { name, begin, end, M, Mp };
+    trace_local->events.push_back(e);
+}
+
+/*!
+ * @brief           Writes the recorded events as Chrome trace JSON
+ * @details         Every event becomes a complete event with microsecond times
+ *                  relative to start(). The events of a (M, M') group carry the
+ *                  orders as arguments.
+ *
+ * @param[in]       path The path of the trace file
+ * @return          True if the file could be written
+ */
+bool DSOFTTrace::write(const char* path)
+{
+    FILE* fp = fopen(path, "w");
+    
+    pfsoft_cond_w(fp == nullptr, "could not open trace file '%s' for writing.", path);
+    
+    if (fp == nullptr)
+    {
+        return false;
+    }
+    
+    std::lock_guard< std::mutex > lock(trace_mutex);
+    
+    const unsigned generation = trace_generation.load();
+    
+    fprintf(fp, "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [\n");
+    fprintf(fp, "{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": 0, \"tid\": 0, \"args\": {\"name\": \"PFSOFTlib\"}}");
+    
+    for (size_t i = 0; i < trace_buffers.size(); ++i)
+    {
+        const trace_buffer& b = *trace_buffers[i];
+        
+        if (b.generation != generation)
+        {
+            continue;
+        }
+        
+        fprintf(fp, ",\n{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 0, \"tid\": %d, \"args\": {\"name\": \"thread %d\"}}", b.tid, b.tid);
+        
+        for (size_t j = 0; j < b.events.size(); ++j)
+        {
+            const DSOFTTraceEvent& e = b.events[j];
+            
+            fprintf(fp, ",\n{\"name\": \"%s\", \"cat\": \"dsoft\", \"ph\": \"X\", \"pid\": 0, \"tid\": %d, \"ts\": %.3f, \"dur\": %.3f",
+                    e.name, b.tid, 1e6 * (e.begin - trace_origin), 1e6 * (e.end - e.begin));
+            
+            if (e.M >= 0)
+            {
+                fprintf(fp, ", \"args\": {\"M\": %d, \"Mp\": %d}", e.M, e.Mp);
+            }
+            
+            fprintf(fp, "}");
+        }
+    }
+    
+    fprintf(fp, "\n]}\n");
+    
+    const bool ok = !ferror(fp);
+    fclose(fp);
+    
+    return ok;
+}
+
+PFSOFT_END
@@ -24,6 +24,9 @@
 /*- for Fourier Analysis purposes -*/
 #include <fftw3.h>
 
+/*- serializing the FFTW planner   -*/
+#include <mutex>
+
 /*- including function wrapper    -*/
 #include <pfsoft>
 
@@ -41,135 +44,218 @@
  */
 PFSOFT_BEGIN
 
+/*!
+ * @brief           Mutex guarding every call into the FFTW planner
+ * @details         Only the fftw_execute family of FFTW is thread safe. Plan
+ *                  creation, plan destruction and fftw_cleanup modify global
+ *                  planner state and have to be serialized.
+ */
+static std::mutex uzl_fftw_planner_mutex;
+
 /*- Wrapper for needed library functions -*/
 extern "C"
 {
-    void uzl_fftw_layer_wise_DFT2_grid3D(int cols, int rows, int lays, double* arr, int threads)
+    /*!
+     * @brief           Creates a context for layer-wise FFT2s
+     * @details         Plans a single 2D FFT for one layer of the given array. The
+     *                  planner is guarded by a mutex, so contexts can be created from
+     *                  several threads at once.
+     *
+     * @param[out]      ctx The context that gets initialized
+     * @param[in]       cols Number of columns of each layer
+     * @param[in]       rows Number of rows of each layer
+     * @param[in]       lays Number of layers
+     * @param[in]       arr The interleaved complex array the context is planned for
+     * @param[in]       sign -1 for the forward and +1 for the backward FFT2
+     */
+    void uzl_fftw_layer_context_create(uzl_fftw_layer_context* ctx, int cols, int rows, int lays, double* arr, int sign)
     {
-        #ifdef _OPENMP
+        ctx->cols      = cols;
+        ctx->rows      = rows;
+        ctx->lays      = lays;
+        ctx->sign      = sign;
+        ctx->alignment = fftw_alignment_of(arr);
+        
+        // new-array execution requires every layer to share the alignment
+        // of the first one. Otherwise FFTW may only use unaligned codelets.
+        unsigned flags = FFTW_ESTIMATE;
+        if (lays > 1 && fftw_alignment_of(arr + 2 * rows * cols) != ctx->alignment)
+        {
+            flags |= FFTW_UNALIGNED;
+        }
+        
+        std::lock_guard< std::mutex > lock(uzl_fftw_planner_mutex);
+        ctx->plan = fftw_plan_dft_2d(cols, rows, (fftw_complex*)arr, (fftw_complex*)arr, (sign < 0 ? FFTW_FORWARD : FFTW_BACKWARD), flags);
+    }
+    
+    /*!
+     * @brief           Executes the layer-wise FFT2 described by the given context
+     * @details         Executes the plan of the context on each layer of the given
+     *                  array. This function does not touch the FFTW planner and is
+     *                  therefore reentrant. While DSOFTTrace records, every layer FFT
+     *                  is recorded as an event of the thread that executed it.
+     *
+     * @param[in]       ctx The context created by uzl_fftw_layer_context_create
+     * @param[in,out]   arr The interleaved complex array that gets transformed in-place
+     * @param[in]       threads Number of threads that execute the layer FFTs
+     */
+    void uzl_fftw_layer_context_execute(const uzl_fftw_layer_context* ctx, double* arr, int threads)
+    {
+        // a context planned for another alignment can not be used on this array.
+        // Fall back to a temporary context which is correct but pays for planning.
+        if (fftw_alignment_of(arr) != ctx->alignment)
+        {
+            uzl_fftw_layer_context tmp;
+            uzl_fftw_layer_context_create(&tmp, ctx->cols, ctx->rows, ctx->lays, arr, ctx->sign);
+            uzl_fftw_layer_context_execute(&tmp, arr, threads);
+            uzl_fftw_layer_context_destroy(&tmp);
+            
+            return;
+        }
         
         // define indices
         int i;
         
-        // storage plans
-        fftw_plan plans[lays];
+        fftw_plan plan = (fftw_plan)ctx->plan;
+        int lays       = ctx->lays;
+        int size       = ctx->rows * ctx->cols;
         
-        // create plans
-        // Creating plans and destroying them is not really thread safe
-        // therefore the plans should be created and destoryed serially
+#if PFSOFT_STATS
+        const bool trace = DSOFTTrace::recording();
+#endif
+        
+        // execute the plan on every layer
+        #pragma omp parallel for private(i) shared(lays, size, plan) schedule(dynamic) num_threads(threads) if(threads > 1)
         for (i = 0; i < lays; ++i)
         {
             // get correct layer
-            fftw_complex* layer = (fftw_complex*)arr + i * rows * cols;
+            fftw_complex* layer = (fftw_complex*)arr + i * size;
+            
+#if PFSOFT_STATS
+            const double begin = (trace ? DSOFTStatsTimer::now() : 0);
+#endif
             
-            // create plan to execute an FFT
-            plans[i] = fftw_plan_dft_2d(cols, rows, layer, layer, FFTW_FORWARD, FFTW_ESTIMATE);
-        }
-        
-        // execute plans in parallel
-        #pragma omp parallel for private(i) shared(lays, plans) schedule(dynamic) num_threads(threads)
-        for (i = 0; i < lays; ++i)
-        {
             // execute FFT2 plan
-            fftw_execute(plans[i]);
-        }
-        
-        for (i = 0; i < lays; ++i)
-        {
-            fftw_destroy_plan(plans[i]);
+            fftw_execute_dft(plan, layer, layer);
+            
+#if PFSOFT_STATS
+            if (trace) { DSOFTTrace::record("layer_fft", begin, DSOFTStatsTimer::now()); }
+#endif
         }
+    }
+    
+    /*!
+     * @brief           The FFTW alignment of the given array
+     * @details         A context can only be executed without planning on arrays
+     *                  with the alignment it was created for.
+     *
+     * @param[in]       arr The interleaved complex array
+     * @return          The alignment FFTW assigns to the array
+     */
+    int uzl_fftw_alignment_of(double* arr)
+    {
+        return fftw_alignment_of(arr);
+    }
+    
+    /*!
+     * @brief           Destroys a context for layer-wise FFT2s
+     * @details         Frees the plan of the given context. The planner is guarded
+     *                  by a mutex, so contexts can be destroyed from several threads
+     *                  at once.
+     *
+     * @param[in,out]   ctx The context that gets destroyed
+     */
+    void uzl_fftw_layer_context_destroy(uzl_fftw_layer_context* ctx)
+    {
+        std::lock_guard< std::mutex > lock(uzl_fftw_planner_mutex);
         
-        // remove all additional allocated objects needed for the FFT
-        fftw_cleanup();
-        
-        #else
-        
-        // define parameters for many dft
-        int rank    = 2;            // Dimension of FFT's
-        int n[]     = {cols, rows}; // Dimension of matrix for each FFT
-        int howmany = lays;         // How many FFT's should be executed?
-        int idist   = n[0] * n[1];  // Length of memory space for each matrix
-        int odist   = idist;        // ... for output same, but is in-place...
-        int istride = 1;            // 1 because matrices are contigous in memory
-        int ostride = 1;            // ... for output same, but is still in-place...
-        int* inembed= n;
-        int* onembed= n;
-        
-        // create plan to execute an layerwise FFT2
-        fftw_plan lay_wise_fft2 = fftw_plan_many_dft(rank, n, howmany, (fftw_complex*)arr, inembed, istride, idist, (fftw_complex*)arr, onembed, ostride, odist, FFTW_FORWARD, FFTW_ESTIMATE);
-        
-        // execute layer-wise FFT2
-        fftw_execute(lay_wise_fft2);
-        
-        // free allocated memory
-        fftw_destroy_plan(lay_wise_fft2);
-        fftw_cleanup();
+        fftw_destroy_plan((fftw_plan)ctx->plan);
+        ctx->plan = nullptr;
+    }
+    
+    void uzl_fftw_layer_wise_DFT2_grid3D(int cols, int rows, int lays, double* arr, int threads)
+    {
+        uzl_fftw_layer_context ctx;
         
-        #endif
+        uzl_fftw_layer_context_create(&ctx, cols, rows, lays, arr, -1);
+        uzl_fftw_layer_context_execute(&ctx, arr, threads);
+        uzl_fftw_layer_context_destroy(&ctx);
     }
     
     void uzl_fftw_layer_wise_IDFT2_grid3D(int cols, int rows, int lays, double* arr, int threads)
     {
-        #ifdef _OPENMP
+        uzl_fftw_layer_context ctx;
         
-        // define indices
-        int i;
-        
-        // storage plans
-        fftw_plan plans[lays];
+        uzl_fftw_layer_context_create(&ctx, cols, rows, lays, arr, +1);
+        uzl_fftw_layer_context_execute(&ctx, arr, threads);
+        uzl_fftw_layer_context_destroy(&ctx);
+    }
+    
+    /*!
+     * @brief           In-place discrete sine transform of type IV
+     * @details         Computes \f$y_k = 2\sum_{j=0}^{n-1} x_j\sin(\pi(j+1/2)(k+1/2)/n)\f$
+     *                  with the FFTW_RODFT11 kind of real-to-real transforms in
+     *                  \f$O(n\log n)\f$.
+     *
+     * @param[in]       n The length of the array
+     * @param[in,out]   arr The array that gets transformed in-place
+     */
+    void uzl_fftw_RODFT11(int n, double* arr)
+    {
+        fftw_plan plan;
         
-        // create plans
-        // Creating plans and destroying them is not really thread safe
-        // therefore the plans should be created and destoryed serially
-        for (i = 0; i < lays; ++i)
         {
-            // get correct layer
-            fftw_complex* layer = (fftw_complex*)arr + i * rows * cols;
-            
-            // create plan to execute an FFT
-            plans[i] = fftw_plan_dft_2d(cols, rows, layer, layer, FFTW_BACKWARD, FFTW_ESTIMATE);
+            std::lock_guard< std::mutex > lock(uzl_fftw_planner_mutex);
+            plan = fftw_plan_r2r_1d(n, arr, arr, FFTW_RODFT11, FFTW_ESTIMATE);
         }
         
-        // execute plans in parallel
-        #pragma omp parallel for private(i) shared(lays, plans) schedule(dynamic) num_threads(threads)
-        for (i = 0; i < lays; ++i)
-        {
-            // execute FFT2 plan
-            fftw_execute(plans[i]);
-        }
+        fftw_execute(plan);
+        
+        std::lock_guard< std::mutex > lock(uzl_fftw_planner_mutex);
+        fftw_destroy_plan(plan);
+    }
+    
+#if PFSOFT_FFTWL
+    /*!
+     * @brief           In-place discrete sine transform of type IV in long double
+     * @details         Same as uzl_fftw_RODFT11 with the long double library of
+     *                  FFTW. Its planner shares the planner mutex of the double one.
+     *
+     * @param[in]       n The length of the array
+     * @param[in,out]   arr The array that gets transformed in-place
+     */
+    void uzl_fftwl_RODFT11(int n, long double* arr)
+    {
+        fftwl_plan plan;
         
-        for (i = 0; i < lays; ++i)
         {
-            fftw_destroy_plan(plans[i]);
+            std::lock_guard< std::mutex > lock(uzl_fftw_planner_mutex);
+            plan = fftwl_plan_r2r_1d(n, arr, arr, FFTW_RODFT11, FFTW_ESTIMATE);
         }
         
-        // remove all additional allocated objects needed for the FFT
-        fftw_cleanup();
-        
-        #else
-        
-        // define parameters for many dft
-        int rank    = 2;            // Dimension for IFFT's
-        int n[]     = {cols, rows}; // Dimension of matrix for each IFFT
-        int howmany = lays;         // How many IFFT's should be executed?
-        int idist   = n[0] * n[1];  // Length of memory space for each matrix
-        int odist   = idist;        // ... for output same, but is in-place...
-        int istride = 1;            // 1 because matrices are contigous in memory
-        int ostride = 1;            // ... for output same, but is still in-place...
-        int* inembed= n;
-        int* onembed= n;
+        fftwl_execute(plan);
         
-        // create plan to execute an layerwise IFFT2
-        fftw_plan lay_wise_ifft2 = fftw_plan_many_dft(rank, n, howmany, (fftw_complex*)arr, inembed, istride, idist, (fftw_complex*)arr, onembed, ostride, odist, FFTW_BACKWARD, FFTW_ESTIMATE);
-        
-        // execute layer-wise IFFT2
-        fftw_execute(lay_wise_ifft2);
+        std::lock_guard< std::mutex > lock(uzl_fftw_planner_mutex);
+        fftwl_destroy_plan(plan);
+    }
+#endif
+    
+    /*!
+     * @brief           Frees all memory FFTW keeps for accumulated wisdom
+     * @details         The transforms do not call fftw_cleanup on their own anymore
+     *                  because it would race with concurrently running transforms.
+     *                  Applications can call this function on shutdown when no
+     *                  transform is running.
+     */
+    void uzl_fftw_cleanup()
+    {
+        std::lock_guard< std::mutex > lock(uzl_fftw_planner_mutex);
         
-        // free allocated memory
-        fftw_destroy_plan(lay_wise_ifft2);
         fftw_cleanup();
         
-        #endif
+#if PFSOFT_FFTWL
+        fftwl_cleanup();
+#endif
     }
 }
 
@@ -25,64 +25,67 @@
 PFSOFT_NAMESPACE(FourierTransforms)
 
 /*!
- * @brief           The DSOFT (<b>S0</b>(3) <b>F</b>ourier <b>T</b>ransform)
- *                  describes the FFT on the rotation group \f$\mathcal{SO}(3)\f$
- * @details         The method to compute the DSOFT on the rotation group is described in
- *                  detail in the paper 'FFTs on the Rotation Group' written by Peter J.
- *                  Kostelec and Daniel N. Rockmore. The implementation that is underneath
- *                  this function is
- *                  \f[
- *                      \hat{f}^l_{M,M'} = \frac{\pi}{(2B)^2}\sum\limits_{k = 0}^{2B-1}w_B(k)
- *                          \tilde{d}^l_{M,M'}(\beta_k)\sum\limits_{j2 = 0}^{2B-1}e^{iM'\gamma_{j_2}}
- *                          \sum\limits_{j_1 = 0}^{2B-1}e^{iM\alpha_{j_1}}f(\alpha_{j_1},\beta_k,\gamma_{j_2})
- *                  \f]
- *                  where \f$B\f$ is the bandwidth of function \f$f(\alpha_{j_1},\beta_k,\gamma_{j_2})\f$.
- *                  The number of cofficients \f$\hat{f}^l_{M,M'}\f$ can be calculated by
- *                  \f[
- *                      |\{\hat{f}^l_{M,M'}\}_{l\in\{0,\dots,B-1\}, M,M'\in\{-l,\dots,l\}}| = \sum\limits_{i = 0}^{B-1}(2 * i + 1)^2
- *                  \f]
- *                  The implementation itself uses the symmetry properties of the wigner
- *                  d-function to reduce the number of wigner d-function evaluations. The
- *                  symmetries that are used are
- *                  \f{eqnarray*}{
- *                      d^{J}_{MM'}(\beta) &=& (-1)^{M-M'}d^J_{-M-M'}(\beta)\\
- *                      &=& (-1)^{M-M'}d^J_{M'M}(\beta)\\
- *                      &=& d^J_{-M'-M}(\beta)\\
- *                      &=& (-1)^{J-M'}d^J_{-MM'}(\pi-\beta)\\
- *                      &=& (-1)^{J+M}d^J_{M-M'}(\pi-\beta)\\
- *                      &=& (-1)^{J-M'}d^J_{-M'M}(\pi-\beta)\\
- *                      &=& (-1)^{J+M}d^J_{M'-M}(\pi-\beta)
- *                  \f}
- *
- * @param[in]       sample A discrete sample of function \f$f\f$ which has the
- *                  dimension of \f$2B\times 2B\times 2B\f$.
- * @param[out]      fc A Fourier coefficent managment container with capacaty for
- *                  all Fourier coefficients of \f$f\f$.
- *
- * @sa              DWT::quadrature_weights
- * @sa              DWT::wigner_d_matrix
- * @sa              DSOFTFourierCoefficients
- * @sa              complex
- * @sa              matrix
- * @sa              grid3D
- *
- * @ingroup         FourierTransforms
- *
- * @author          Denis-Michael Lux <denis.lux@icloud.com>
- * @date            14.05.2015
- *
- * @since           0.0.1
+ * @brief           The DWT of a \f$\beta\f$-line with a weighted wigner d-matrix
+ *                  of precision R
+ */
+template< typename R >
+static inline vector< complex< double > > dwt(matrix< R >& dw, const vector< complex< double > >& s)
+{
+    return convert< double >(dw * convert< R >(s));
+}
+
+/*!
+ * @brief           The DWT of a \f$\beta\f$-line in double precision, which needs
+ *                  no conversion and multiplies with the dispatched kernel
+ */
+template< >
+inline vector< complex< double > > dwt(matrix< double >& dw, const vector< complex< double > >& s)
+{
+    return dw * s;
+}
+
+/*!
+ * @brief           Stores the DWT of the orders (M, M') multiplied by norm as the
+ *                  coefficients of the highest degrees of fc
  */
-void DSOFT(grid3D< complex< double > > sample, DSOFTFourierCoefficients& fc, int threads)
+static inline void scatter(const vector< complex< double > >& sh, const double& norm, DSOFTFourierCoefficients& fc, const int& bandlimit, const int& M, const int& Mp)
+{
+    SIMD::scatter(reinterpret_cast< const double* >(&sh[0]), sh.size, norm, reinterpret_cast< double* >(&fc(0, 0, 0)), bandlimit - static_cast< int >(sh.size), M, Mp);
+}
+
+/*!
+ * @brief           The DSOFT with a DWT in precision R that records its timing
+ *                  breakdown to stats if stats is not nullptr
+ */
+template< typename R >
+static void dsoft(const grid3D< complex< double > >& input, DSOFTFourierCoefficients& fc, DSOFTStats* stats, int threads)
 {
     /*****************************************************************
      ** Check parameters                                            **
      *****************************************************************/
     // Check if the grid has same size in each dimension
-    pfsoft_cond_w_ret(sample.rows != sample.cols || sample.rows != sample.lays, "%s", "all DSOFT sample grid dimensions should be equal.");
+    pfsoft_cond_w_ret(input.rows != input.cols || input.rows != input.lays, "%s", "all DSOFT sample grid dimensions should be equal.");
     
     // Check if grid has odd dimensions
-    pfsoft_cond_w_ret(sample.rows & 1, "%s", "DSOFT sample grid dimensions are not even.");
+    pfsoft_cond_w_ret(input.rows & 1, "%s", "DSOFT sample grid dimensions are not even.");
+    
+    // Mapped samples may exceed the memory and views should not be duplicated.
+    // They are streamed slab by slab instead of being copied.
+    if (input.storage != grid3D< complex< double > >::HEAP)
+    {
+        const int block = DSOFT_slab_layers(static_cast< int >(input.cols / 2));
+        
+        if (stats != nullptr) { DSOFT_stream(input, fc, block, *stats, threads); }
+        else                  { DSOFT_stream(input, fc, block, threads);         }
+        
+        return;
+    }
+    
+    // lap timer of the stages that run on the calling thread
+    pfsoft_stats_timer(lap, stats);
+    
+    // the layer-wise FFT2 works in place on a copy of the sample
+    grid3D< complex< double > > sample(input);
     
     // Extract bandwidth
     const int bandwidth = static_cast< int >(sample.cols / 2);
@@ -90,75 +93,92 @@ void DSOFT(grid3D< complex< double > > sample, DSOFTFourierCoefficients& fc, int
     // precompute the double bandwidth
     const int bw2 = 2 * bandwidth;
     
-    // Check if Fourier coefficients container dimension matches sample dimension
-    pfsoft_cond_w_ret(bandwidth != fc.bandwidth, "%s", "DSOFT Fourier coefficients container bandwidth does not match to sample grid bandwidth.");
+    // Check if Fourier coefficients container dimension fits to the sample dimension
+    pfsoft_cond_w_ret(fc.bandwidth > bandwidth || fc.bandwidth < 1, "%s", "DSOFT Fourier coefficients container bandwidth exceeds the sample grid bandwidth.");
+    
+    // Effective bandlimit of the analysis. Only degrees l < bandlimit are
+    // computed, so (M, M') with max(|M|, |M'|) >= bandlimit are skipped.
+    const int bandlimit = fc.bandwidth;
     
     // print warinings for serial implementation
     #ifndef _OPENMP
     pfsoft_cond_w(threads != 1, "%s", "compiler does not support OpenMP. Changing the number of threads for the DSOFT has no effect.");
     #endif
     
+    // number of threads from the tuning profile and whether the
+    // (M, M') loops run in parallel for this bandwidth
+    threads             = DSOFT_threads(bandwidth, threads);
+    const bool parallel = threads > 1 && bandwidth >= DSOFT_threshold();
+    
+    if (stats != nullptr)
+    {
+        stats->reset(bandwidth, parallel ? threads : 1);
+    }
+    
     /*****************************************************************
      ** FFT2 transform layers of sample grid for fixed k            **
      *****************************************************************/
-    sample.layer_wise_DFT2(complex< double > (1.0, 0.0), threads);
+    sample.layer_wise_DFT2(complex< double > (1.0, 0.0), threads); pfsoft_stats_lap(lap, FFT);
     
     /*****************************************************************
      ** M = 0, M' = 0                                               **
      *****************************************************************/
-    vector< long double > weights(2 * bandwidth);
-    DWT::quadrature_weights< long double >(weights);
+    vector< R > weights(2 * bandwidth);
+    DWT::quadrature_weights< R >(weights);
     
-    matrix< long double > dw(bandwidth, 2 * bandwidth);
+    matrix< R > dw(bandlimit, 2 * bandwidth);
     DWT::weighted_wigner_d_matrix(dw, bandwidth, 0, 0, weights);
-    dw *= -1;
+    dw *= -1; pfsoft_stats_lap(lap, WIGNER);
     
     vector< complex< double > > s(bw2, vector< complex< double > >::COLUMN);
     
     // defining norm factor
-    complex< double > norm(constants< double >::pi / (bandwidth * bw2), 0);
+    const double norm = constants< double >::pi / (bandwidth * bw2);
     
     // defining needed indices
     int MMp, M, Mp;
     vector< complex< double > >::iterator e;
-    matrix< long double >::lin_iterator m;
+    typename matrix< R >::lin_iterator m;
     
     // DWT for M = 0, M' = 0
-    for (e = s.begin() ; e != s.end() ; ++e) { *e = sample(0, 0, e - s.begin());                            }
-    vector< complex< double > > sh = convert<double>(dw * convert<long double>(s));
-    for (e = sh.begin(); e != sh.end(); ++e) { fc(bandwidth - (sh.end() - e), 0, 0) = norm * *e;            }
+    for (e = s.begin() ; e != s.end() ; ++e) { *e = sample(0, 0, e - s.begin());                            } pfsoft_stats_lap(lap, SCATTER);
+    vector< complex< double > > sh = dwt(dw, s);                                                              pfsoft_stats_lap(lap, DWT);
+    scatter(sh, norm, fc, bandlimit, 0, 0);                                                                   pfsoft_stats_lap(lap, SCATTER);
     
     /*****************************************************************
      ** Iterate over all combinations of M and M'                   **
      *****************************************************************/
-    #pragma omp parallel default(shared) if(bandwidth >= DSOFT_THRESHOLD) num_threads(threads)
+    #pragma omp parallel default(shared) if(parallel) num_threads(threads)
     {
+        pfsoft_stats_timer(lap, stats);
         
         #pragma omp for private(M, e) firstprivate(dw, s, sh) schedule(dynamic) nowait
-        for (M = 1; M < bandwidth; ++M)
+        for (M = 1; M < bandlimit; ++M)
         {
-            access::rw(dw.rows) = bandwidth - M;
+            pfsoft_stats_group(lap, M, 0);
+            
+            access::rw(dw.rows) = bandlimit - M;
             DWT::weighted_wigner_d_matrix(dw, bandwidth, M, 0, weights);
-            dw *= -1;
+            dw *= -1; pfsoft_stats_lap(lap, WIGNER);
             
             /*****************************************************************
              ** Make use of symmetries                                      **
              *****************************************************************/
             // case f_{M,0}
-            for (e = s.begin() ; e != s.end() ; ++e) { *e = sample(0, M, e - s.begin());                    }
-            sh = convert<double>(dw * convert<long double>(s));
-            for (e = sh.begin(); e != sh.end(); ++e) { fc(bandwidth - (sh.end() - e), M, 0) = norm * *e;    }
+            for (e = s.begin() ; e != s.end() ; ++e) { *e = sample(0, M, e - s.begin());                    } pfsoft_stats_lap(lap, SCATTER);
+            sh = dwt(dw, s);                                                                                  pfsoft_stats_lap(lap, DWT);
+            scatter(sh, norm, fc, bandlimit, M, 0);                                                           pfsoft_stats_lap(lap, SCATTER);
             
             // case f_{0,M}
-            for (e = s.begin() ; e != s.end() ; ++e) { *e = sample(M, 0, e - s.begin());                    }
-            sh = convert<double>(dw * convert<long double>(s));
+            for (e = s.begin() ; e != s.end() ; ++e) { *e = sample(M, 0, e - s.begin());                    } pfsoft_stats_lap(lap, SCATTER);
+            sh = dwt(dw, s);                                                                                  pfsoft_stats_lap(lap, DWT);
             if  (M & 1)                              { sh *= -1;                                            }
-            for (e = sh.begin(); e != sh.end(); ++e) { fc(bandwidth - (sh.end() - e), 0, M) = norm * *e;    }
+            scatter(sh, norm, fc, bandlimit, 0, M);                                                           pfsoft_stats_lap(lap, SCATTER);
             
             // case f_{-M,0}
-            fliplr(dw);
-            for (e = s.begin() ; e != s.end() ; ++e) { *e = sample(0, bw2 - M, e - s.begin());              }
-            sh = convert<double>(dw * convert<long double>(s));
+            fliplr(dw);                                                                                       pfsoft_stats_lap(lap, WIGNER);
+            for (e = s.begin() ; e != s.end() ; ++e) { *e = sample(0, bw2 - M, e - s.begin());              } pfsoft_stats_lap(lap, SCATTER);
+            sh = dwt(dw, s);                                                                                  pfsoft_stats_lap(lap, DWT);
             if (M & 1)  // if M is odd
             {
                 for (e = sh.begin(); e < sh.end(); e += 2)     { *e *= -1;                                  }
@@ -167,121 +187,240 @@ void DSOFT(grid3D< complex< double > > sample, DSOFTFourierCoefficients& fc, int
             {
                 for (e = sh.begin() + 1; e < sh.end(); e += 2) { *e *= -1;                                  }
             }
-            for (e = sh.begin(); e != sh.end(); ++e) { fc(bandwidth - (sh.end() - e), -M, 0) = norm * *e;   }
+            scatter(sh, norm, fc, bandlimit, -M, 0);                                                          pfsoft_stats_lap(lap, SCATTER);
             
             // case f_{0,-M}
-            for (e = s.begin() ; e != s.end() ; ++e) { *e = sample(bw2 - M, 0, e - s.begin());              }
-            sh = convert<double>(dw * convert<long double>(s));
+            for (e = s.begin() ; e != s.end() ; ++e) { *e = sample(bw2 - M, 0, e - s.begin());              } pfsoft_stats_lap(lap, SCATTER);
+            sh = dwt(dw, s);                                                                                  pfsoft_stats_lap(lap, DWT);
             for (e = sh.begin() + 1; e < sh.end(); e += 2) { *e *= -1;                                      }
-            for (e = sh.begin(); e != sh.end(); ++e) { fc(bandwidth - (sh.end() - e), 0, -M) = norm * *e;   }
+            scatter(sh, norm, fc, bandlimit, 0, -M);                                                          pfsoft_stats_lap(lap, SCATTER);
             
             // get new wigner matrix
             DWT::weighted_wigner_d_matrix(dw, bandwidth, M, M, weights);
-            dw *= -1;
+            dw *= -1; pfsoft_stats_lap(lap, WIGNER);
             
             // case f_{M, M}
-            for (e = s.begin() ; e != s.end() ; ++e) { *e = sample(M, M, e - s.begin());                    }
-            sh = convert<double>(dw * convert<long double>(s));
-            for (e = sh.begin(); e != sh.end(); ++e) { fc(bandwidth - (sh.end() - e), M, M) = norm * *e;    }
+            for (e = s.begin() ; e != s.end() ; ++e) { *e = sample(M, M, e - s.begin());                    } pfsoft_stats_lap(lap, SCATTER);
+            sh = dwt(dw, s);                                                                                  pfsoft_stats_lap(lap, DWT);
+            scatter(sh, norm, fc, bandlimit, M, M);                                                           pfsoft_stats_lap(lap, SCATTER);
             
             // case f_{-M, -M}
-            for (e = s.begin() ; e != s.end() ; ++e) { *e = sample(bw2 - M, bw2 - M, e - s.begin());        }
-            sh = convert<double>(dw * convert<long double>(s));
-            for (e = sh.begin(); e != sh.end(); ++e) { fc(bandwidth - (sh.end() - e), -M, -M) = norm * *e;  }
+            for (e = s.begin() ; e != s.end() ; ++e) { *e = sample(bw2 - M, bw2 - M, e - s.begin());        } pfsoft_stats_lap(lap, SCATTER);
+            sh = dwt(dw, s);                                                                                  pfsoft_stats_lap(lap, DWT);
+            scatter(sh, norm, fc, bandlimit, -M, -M);                                                         pfsoft_stats_lap(lap, SCATTER);
             
             // Modify dw for the last two cases. flip matrix from left to right and negate signs of
             // every second row with odd row indices.
-            fliplr_ne2ndorow(dw);
+            fliplr_ne2ndorow(dw); pfsoft_stats_lap(lap, WIGNER);
             
             // A little arithmetic error is occuring in the following calculation... I do not exactly know why
             // case f_{M, -M}
-            for (e = s.begin() ; e != s.end() ; ++e) { *e = sample(bw2 - M, M, e - s.begin());              }
-            sh = convert<double>(dw * convert<long double>(s));
-            for (e = sh.begin(); e != sh.end(); ++e) { fc(bandwidth - (sh.end() - e), M, -M) = norm * *e;   }
+            for (e = s.begin() ; e != s.end() ; ++e) { *e = sample(bw2 - M, M, e - s.begin());              } pfsoft_stats_lap(lap, SCATTER);
+            sh = dwt(dw, s);                                                                                  pfsoft_stats_lap(lap, DWT);
+            scatter(sh, norm, fc, bandlimit, M, -M);                                                          pfsoft_stats_lap(lap, SCATTER);
             
             // case f_{-M, M}
-            for (e = s.begin() ; e != s.end() ; ++e) { *e = sample(M, bw2 - M, e - s.begin());              }
-            sh = convert<double>(dw * convert<long double>(s));
-            for (e = sh.begin(); e != sh.end(); ++e) { fc(bandwidth - (sh.end() - e), -M, M) = norm * *e;   }
+            for (e = s.begin() ; e != s.end() ; ++e) { *e = sample(M, bw2 - M, e - s.begin());              } pfsoft_stats_lap(lap, SCATTER);
+            sh = dwt(dw, s);                                                                                  pfsoft_stats_lap(lap, DWT);
+            scatter(sh, norm, fc, bandlimit, -M, M);                                                          pfsoft_stats_lap(lap, SCATTER);
         }
         
         // Fused two loops per hand
         //
-        // for (M = 1; M < bandwidth; ++M)
+        // for (M = 1; M < bandlimit; ++M)
         //     for (Mp = 1; Mp < M; ++Mp)
         //
         // which now is equivalent to the following loop
         #pragma omp for private(MMp, M, Mp, e) firstprivate(dw, s, sh) schedule(dynamic) nowait
-        for (MMp = 0; MMp < (bandwidth - 2) * (bandwidth - 1) / 2; ++MMp)
+        for (MMp = 0; MMp < (bandlimit - 2) * (bandlimit - 1) / 2; ++MMp)
         {
             // reconstructing nested loop indices
-            int i = MMp / (bandwidth - 1) + 1;
-            int j = MMp % (bandwidth - 1) + 1;
+            int i = MMp / (bandlimit - 1) + 1;
+            int j = MMp % (bandlimit - 1) + 1;
             
             // get M and M'
-            M  = j > i ? bandwidth - i : i + 1;
-            Mp = j > i ? bandwidth - j : j    ;
+            M  = j > i ? bandlimit - i : i + 1;
+            Mp = j > i ? bandlimit - j : j    ;
+            
+            pfsoft_stats_group(lap, M, Mp);
             
             // get new wigner d-matrix
-            access::rw(dw.rows) = bandwidth - std::max(abs(M), abs(Mp));
-            DWT::weighted_wigner_d_matrix(dw, bandwidth, M, Mp, weights);
+            access::rw(dw.rows) = bandlimit - std::max(abs(M), abs(Mp));
+            DWT::weighted_wigner_d_matrix(dw, bandwidth, M, Mp, weights); pfsoft_stats_lap(lap, WIGNER);
             
             // case f_{M, Mp}
-            for (e = s.begin() ; e != s.end() ; ++e) { *e = sample(Mp, M, e - s.begin());                   }
-            sh  = convert<double>(dw * convert<long double>(s));
+            for (e = s.begin() ; e != s.end() ; ++e) { *e = sample(Mp, M, e - s.begin());                   } pfsoft_stats_lap(lap, SCATTER);
+            sh  = dwt(dw, s);                                                                                 pfsoft_stats_lap(lap, DWT);
             sh *= -1;
-            for (e = sh.begin(); e != sh.end(); ++e) { fc(bandwidth - (sh.end() - e), M, Mp) = norm * *e;   }
+            scatter(sh, norm, fc, bandlimit, M, Mp);                                                          pfsoft_stats_lap(lap, SCATTER);
             
             // case f_{Mp, M}
-            for (e = s.begin() ; e != s.end() ; ++e) { *e = sample(M, Mp, e - s.begin());                   }
-            sh = convert<double>(dw * convert<long double>(s));
+            for (e = s.begin() ; e != s.end() ; ++e) { *e = sample(M, Mp, e - s.begin());                   } pfsoft_stats_lap(lap, SCATTER);
+            sh = dwt(dw, s);                                                                                  pfsoft_stats_lap(lap, DWT);
             if  (!((M - Mp) & 1))                    { sh *= -1;                                            }
-            for (e = sh.begin(); e != sh.end(); ++e) { fc(bandwidth - (sh.end() - e), Mp, M) = norm * *e;   }
+            scatter(sh, norm, fc, bandlimit, Mp, M);                                                          pfsoft_stats_lap(lap, SCATTER);
             
             // case f_{-M, -Mp}
-            for (e = s.begin() ; e != s.end() ; ++e) { *e = sample(bw2 - Mp, bw2 - M, e - s.begin());       }
-            sh = convert<double>(dw * convert<long double>(s));
+            for (e = s.begin() ; e != s.end() ; ++e) { *e = sample(bw2 - Mp, bw2 - M, e - s.begin());       } pfsoft_stats_lap(lap, SCATTER);
+            sh = dwt(dw, s);                                                                                  pfsoft_stats_lap(lap, DWT);
             if  (!((M - Mp) & 1))                    { sh *= -1;                                            }
-            for (e = sh.begin(); e != sh.end(); ++e) { fc(bandwidth - (sh.end() - e), -M, -Mp) = norm * *e; }
+            scatter(sh, norm, fc, bandlimit, -M, -Mp);                                                        pfsoft_stats_lap(lap, SCATTER);
             
             // case f_{-Mp, -M}
-            for (e = s.begin() ; e != s.end() ; ++e) { *e = sample(bw2 - M, bw2 - Mp, e - s.begin());       }
-            sh  = convert<double>(dw * convert<long double>(s));
+            for (e = s.begin() ; e != s.end() ; ++e) { *e = sample(bw2 - M, bw2 - Mp, e - s.begin());       } pfsoft_stats_lap(lap, SCATTER);
+            sh  = dwt(dw, s);                                                                                 pfsoft_stats_lap(lap, DWT);
             sh *= -1;
-            for (e = sh.begin(); e != sh.end(); ++e) { fc(bandwidth - (sh.end() - e), -Mp, -M) = norm * *e; }
+            scatter(sh, norm, fc, bandlimit, -Mp, -M);                                                        pfsoft_stats_lap(lap, SCATTER);
             
             // modify wigner d-matrix for next four cases. This just works because the weight
             // function is also symmetric like the wigner-d matrix. flip left-right the dw
             // matrix and negate each even value with even row index.
-            fliplr_ne2nderow(dw);
+            fliplr_ne2nderow(dw); pfsoft_stats_lap(lap, WIGNER);
             
             // case f_{Mp, -M}
-            for (e = s.begin() ; e != s.end() ; ++e) { *e = sample(bw2 - M, Mp, e - s.begin());             }
-            sh = convert<double>(dw * convert<long double>(s));
-            for (e = sh.begin(); e != sh.end(); ++e) { fc(bandwidth - (sh.end() - e), Mp, -M) = norm * *e;  }
+            for (e = s.begin() ; e != s.end() ; ++e) { *e = sample(bw2 - M, Mp, e - s.begin());             } pfsoft_stats_lap(lap, SCATTER);
+            sh = dwt(dw, s);                                                                                  pfsoft_stats_lap(lap, DWT);
+            scatter(sh, norm, fc, bandlimit, Mp, -M);                                                         pfsoft_stats_lap(lap, SCATTER);
             
             // case f_{M, -Mp}
-            for (e = s.begin() ; e != s.end() ; ++e) { *e = sample(bw2 - Mp, M, e - s.begin());             }
-            sh = convert<double>(dw * convert<long double>(s));
-            for (e = sh.begin(); e != sh.end(); ++e) { fc(bandwidth - (sh.end() - e), M, -Mp) = norm * *e;  }
+            for (e = s.begin() ; e != s.end() ; ++e) { *e = sample(bw2 - Mp, M, e - s.begin());             } pfsoft_stats_lap(lap, SCATTER);
+            sh = dwt(dw, s);                                                                                  pfsoft_stats_lap(lap, DWT);
+            scatter(sh, norm, fc, bandlimit, M, -Mp);                                                         pfsoft_stats_lap(lap, SCATTER);
             
             // alter signs
             if ((M - Mp) & 1)
             {
-                for (m = dw.begin(); m != dw.begin() + dw.rows * dw.cols; ++m) { *m *= -1;                  }
+                for (m = dw.begin(); m != dw.begin() + dw.rows * dw.cols; ++m) { *m *= -1;                  } pfsoft_stats_lap(lap, WIGNER);
             }
             
             // case f_{-Mp, M}
-            for (e = s.begin() ; e != s.end() ; ++e) { *e = sample(M, bw2 - Mp, e - s.begin());             }
-            sh = convert<double>(dw * convert<long double>(s));
-            for (e = sh.begin(); e != sh.end(); ++e) { fc(bandwidth - (sh.end() - e), -Mp, M) = norm * *e;  }
+            for (e = s.begin() ; e != s.end() ; ++e) { *e = sample(M, bw2 - Mp, e - s.begin());             } pfsoft_stats_lap(lap, SCATTER);
+            sh = dwt(dw, s);                                                                                  pfsoft_stats_lap(lap, DWT);
+            scatter(sh, norm, fc, bandlimit, -Mp, M);                                                         pfsoft_stats_lap(lap, SCATTER);
             
             // case f_{-M, Mp}
-            for (e = s.begin() ; e != s.end() ; ++e) { *e = sample(Mp, bw2 - M, e - s.begin());             }
-            sh = convert<double>(dw * convert<long double>(s));
-            for (e = sh.begin(); e != sh.end(); ++e) { fc(bandwidth - (sh.end() - e), -M, Mp) = norm * *e;  }
+            for (e = s.begin() ; e != s.end() ; ++e) { *e = sample(Mp, bw2 - M, e - s.begin());             } pfsoft_stats_lap(lap, SCATTER);
+            sh = dwt(dw, s);                                                                                  pfsoft_stats_lap(lap, DWT);
+            scatter(sh, norm, fc, bandlimit, -M, Mp);                                                         pfsoft_stats_lap(lap, SCATTER);
         }
+        
+        pfsoft_stats_merge(lap, true);
     }
+    
+    pfsoft_stats_loops(lap);
+    pfsoft_stats_merge(lap, false);
+}
+
+/*!
+ * @brief           The DSOFT that records its timing breakdown to stats if
+ *                  stats is not nullptr, with a DWT in the precision that
+ *                  FourierTransforms::DSOFT_double_dwt selects for the bandwidth
+ */
+static void dsoft(const grid3D< complex< double > >& input, DSOFTFourierCoefficients& fc, DSOFTStats* stats, int threads)
+{
+    if (DSOFT_double_dwt(static_cast< int >(input.cols / 2))) { dsoft< double >     (input, fc, stats, threads); }
+    else                                                      { dsoft< long double >(input, fc, stats, threads); }
+}
+
+/*!
+ * @brief           The DSOFT (<b>S0</b>(3) <b>F</b>ourier <b>T</b>ransform)
+ *                  describes the FFT on the rotation group \f$\mathcal{SO}(3)\f$
+ * @details         The method to compute the DSOFT on the rotation group is described in
+ *                  detail in the paper 'FFTs on the Rotation Group' written by Peter J.
+ *                  Kostelec and Daniel N. Rockmore. The implementation that is underneath
+ *                  this function is
+ *                  \f[
+ *                      \hat{f}^l_{M,M'} = \frac{\pi}{(2B)^2}\sum\limits_{k = 0}^{2B-1}w_B(k)
+ *                          \tilde{d}^l_{M,M'}(\beta_k)\sum\limits_{j2 = 0}^{2B-1}e^{iM'\gamma_{j_2}}
+ *                          \sum\limits_{j_1 = 0}^{2B-1}e^{iM\alpha_{j_1}}f(\alpha_{j_1},\beta_k,\gamma_{j_2})
+ *                  \f]
+ *                  where \f$B\f$ is the bandwidth of function \f$f(\alpha_{j_1},\beta_k,\gamma_{j_2})\f$.
+ *                  The number of cofficients \f$\hat{f}^l_{M,M'}\f$ can be calculated by
+ *                  \f[
+ *                      |\{\hat{f}^l_{M,M'}\}_{l\in\{0,\dots,B-1\}, M,M'\in\{-l,\dots,l\}}| = \sum\limits_{i = 0}^{B-1}(2 * i + 1)^2
+ *                  \f]
+ *                  The implementation itself uses the symmetry properties of the wigner
+ *                  d-function to reduce the number of wigner d-function evaluations. The
+ *                  symmetries that are used are
+ *                  \f{eqnarray*}{
+ *                      d^{J}_{MM'}(\beta) &=& (-1)^{M-M'}d^J_{-M-M'}(\beta)\\
+ *                      &=& (-1)^{M-M'}d^J_{M'M}(\beta)\\
+ *                      &=& d^J_{-M'-M}(\beta)\\
+ *                      &=& (-1)^{J-M'}d^J_{-MM'}(\pi-\beta)\\
+ *                      &=& (-1)^{J+M}d^J_{M-M'}(\pi-\beta)\\
+ *                      &=& (-1)^{J-M'}d^J_{-M'M}(\pi-\beta)\\
+ *                      &=& (-1)^{J+M}d^J_{M'-M}(\pi-\beta)
+ *                  \f}
+ *
+ *                  The bandwidth \f$L\f$ of the coefficients container may be smaller
+ *                  than the bandwidth \f$B\f$ of the sample. Then only the coefficients
+ *                  of degree \f$l < L\f$ are computed. All orders with
+ *                  \f$\max(|M|,|M'|)\geq L\f$ are skipped and the weighted wigner
+ *                  d-matrices get \f$L - \max(|M|,|M'|)\f$ rows. The coefficients are
+ *                  the same as the ones of degree \f$l < L\f$ of a full transform.
+ *
+ *                  A sample that is stored in a memory-mapped file or that views
+ *                  external memory is transformed by FourierTransforms::DSOFT_stream
+ *                  in slabs of FourierTransforms::DSOFT_slab_layers layers instead, so
+ *                  the sample is never copied as a whole.
+ *
+ *                  The DWT runs in long double precision unless
+ *                  FourierTransforms::DSOFT_double_dwt enables the double precision
+ *                  DWT with the SIMD kernels for the bandwidth.
+ *
+ * @param[in]       input A discrete sample of function \f$f\f$ which has the
+ *                  dimension of \f$2B\times 2B\times 2B\f$.
+ * @param[out]      fc A Fourier coefficent managment container with capacaty for
+ *                  all Fourier coefficients of \f$f\f$ up to its bandwidth, which
+ *                  must not exceed \f$B\f$.
+ *
+ * @sa              FourierTransforms::DSOFT_stream
+ * @sa              DWT::quadrature_weights
+ * @sa              DWT::wigner_d_matrix
+ * @sa              DSOFTFourierCoefficients
+ * @sa              complex
+ * @sa              matrix
+ * @sa              grid3D
+ *
+ * @ingroup         FourierTransforms
+ *
+ * @author          Denis-Michael Lux <denis.lux@icloud.com>
+ * @date            14.05.2015
+ *
+ * @since           0.0.1
+ */
+void DSOFT(const grid3D< complex< double > >& input, DSOFTFourierCoefficients& fc, int threads)
+{
+    dsoft(input, fc, nullptr, threads);
+}
+
+/*!
+ * @brief           The DSOFT with a timing breakdown
+ * @details         Computes the same coefficients as FourierTransforms::DSOFT and
+ *                  reports the wall time of the call. If the library is built with
+ *                  PFSOFT_STATS, the time of every stage and the busy time of every
+ *                  thread is reported as well. Mapped samples and views are
+ *                  transformed slab by slab, their stages are the ones of
+ *                  FourierTransforms::DSOFT_stream.
+ *
+ * @param[in]       input A discrete sample of function \f$f\f$
+ * @param[out]      fc The Fourier coefficients of \f$f\f$
+ * @param[out]      stats The timing breakdown of the call
+ * @param[in]       threads The number of threads
+ *
+ * @sa              DSOFTStats
+ *
+ * @ingroup         FourierTransforms
+ *
+ * @since           1.0.0
+ */
+void DSOFT(const grid3D< complex< double > >& input, DSOFTFourierCoefficients& fc, DSOFTStats& stats, int threads)
+{
+    stats.reset(static_cast< int >(input.cols / 2), 1);
+    
+    const double start = DSOFTStatsTimer::now();
+    dsoft(input, fc, &stats, threads);
+    stats.total = DSOFTStatsTimer::now() - start;
 }
 
 PFSOFT_NAMESPACE_END
@@ -0,0 +1,1063 @@
+//
+//  fn_dsoft_mpi.cpp
+//  PFSOFTlib
+//
+//   Created by Denis-Michael Lux on 05. November 2015.
+//
+//   This file is part of PFSOFTlib.
+//
+//   PFSOFTlib is free software: you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License as published by
+//   the Free Software Foundation, either version 3 of the License, or
+//   (at your option) any later version.
+//
+//   PFSOFTlib is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with PFSOFTlib.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <algorithm>
+#include <climits>
+
+#include <pfsoft>
+
+#if PFSOFT_USE_MPI
+
+PFSOFT_NAMESPACE(FourierTransforms)
+
+/*- Distribution of the symmetry orbits over the ranks -*/
+// The orbit representatives M >= |M'| are enumerated by r = M^2 + M + M'
+// like in the shared memory transforms. Every orbit belongs to exactly one
+// rank, which owns the beta-lines of all orders of the orbit and computes
+// their coefficients.
+struct mpi_distribution
+{
+    std::vector< std::vector< int > > reps;     // representatives per rank
+    std::vector< int >                lines;    // number of beta-lines per rank
+    std::vector< size_t >             values;   // number of coefficients per rank
+    std::vector< int >                units;    // number of coefficient units per rank
+    int                               unit;     // number of coefficients per unit
+};
+
+// the orders that share the wigner d-matrix of a representative M >= |M'|,
+// without duplicates, and their signs relative to the recurrence. The kernel
+// sign of a representative is -1, see DWT::kernel_sign.
+static int orbit_orders(const int& M, const int& Mp, int* oM, int* oN, long double* oS)
+{
+    const long double sign   = -1;
+    const long double parity = ((M - Mp) & 1 ? -1 : 1);
+    
+    const int         cM[4] = { M, Mp, -Mp, -M  };
+    const int         cN[4] = { Mp, M, -M, -Mp };
+    const long double cS[4] = { sign, parity * sign, sign, parity * sign };
+    
+    int n = 0;
+    for (int o = 0; o < 4; ++o)
+    {
+        // skip orders that already occured in this orbit
+        bool seen = false;
+        for (int p = 0; p < n; ++p)
+        {
+            seen = seen || (oM[p] == cM[o] && oN[p] == cN[o]);
+        }
+        
+        if (!seen)
+        {
+            oM[n] = cM[o];
+            oN[n] = cN[o];
+            oS[n] = cS[o];
+            ++n;
+        }
+    }
+    
+    return n;
+}
+
+// Assigns the orbits to the ranks in the symmetry groups of the shared
+// memory DSOFT, i.e. {(0, 0)}, {(M, 0), (M, M), (M, -M)} and
+// {(M, M'), (M, -M')} for 0 < M' < M. The wigner d-matrix of (M, -M') is
+// the flipped one of (M, M'), so both orbits of a pair are computed by the
+// same rank. The work of a group grows with the number of degrees B - M,
+// so the groups are handed out with decreasing work to the rank with the
+// least work so far.
+static void distribute(const int& bandlimit, const int& size, mpi_distribution& dist)
+{
+    dist.reps.assign(size, std::vector< int >());
+    dist.lines.assign(size, 0);
+    dist.values.assign(size, 0);
+    dist.units.assign(size, 0);
+    
+    std::vector< long > work(size, 0);
+    
+    int         oM[4], oN[4];
+    long double oS[4];
+    
+    for (int M = 0; M < bandlimit; ++M)
+    {
+        for (int Mp = 0; Mp <= M; ++Mp)
+        {
+            // (M, 0) opens the group of (M, M) and (M, -M)
+            if (Mp == M && M > 0)
+            {
+                continue;
+            }
+            
+            int group[3] = { M, 0, 0 }, n = 0;
+            
+            if      (M == 0)  { group[n++] = 0;                                                        }
+            else if (Mp == 0) { group[n++] = M * M + M; group[n++] = M * M + 2 * M; group[n++] = M * M; }
+            else              { group[n++] = M * M + M + Mp; group[n++] = M * M + M - Mp;               }
+            
+            const int q = static_cast< int >(std::min_element(work.begin(), work.end()) - work.begin());
+            
+            for (int i = 0; i < n; ++i)
+            {
+                const int orders = orbit_orders(M, group[i] - M * M - M, oM, oN, oS);
+                
+                dist.reps[q].push_back(group[i]);
+                dist.lines[q]  += orders;
+                dist.values[q] += orders * (bandlimit - M);
+                work[q]        += (orders + 1) * (bandlimit - M);
+            }
+        }
+    }
+    
+    // About 4/3 B^3 coefficients are gathered and scattered in total, which
+    // exceeds the int counts of MPI from B = 1170 on. They are therefore sent
+    // in units of several coefficients, and every rank pads its coefficients
+    // to whole units. A rank adds less than one unit of padding, so the units
+    // of all ranks stay below INT_MAX if a unit holds more than
+    // total / (INT_MAX - size) coefficients.
+    size_t total = 0;
+    for (int q = 0; q < size; ++q)
+    {
+        total += dist.values[q];
+    }
+    
+    dist.unit = static_cast< int >(total / (INT_MAX - size) + 1);
+    
+    for (int q = 0; q < size; ++q)
+    {
+        dist.units[q] = static_cast< int >((dist.values[q] + dist.unit - 1) / dist.unit);
+    }
+}
+
+// the number of coefficients of a rank padded to whole units
+static size_t padded(const mpi_distribution& dist, const int& q)
+{
+    return static_cast< size_t >(dist.units[q]) * dist.unit;
+}
+
+// Gathers the padded coefficients of all ranks on rank 0 one rank after
+// another. The counts and displacements are in units, see distribute.
+static void gather_coefficients(const mpi_distribution& dist, const complex< double >* values, complex< double >* all, MPI_Datatype cx, const int& rank, MPI_Comm comm)
+{
+    const int size = static_cast< int >(dist.units.size());
+    
+    std::vector< int > displs(size + 1, 0);
+    for (int q = 0; q < size; ++q)
+    {
+        displs[q + 1] = displs[q] + dist.units[q];
+    }
+    
+    MPI_Datatype unit;
+    MPI_Type_contiguous(dist.unit, cx, &unit);
+    MPI_Type_commit(&unit);
+    
+    MPI_Gatherv(values, dist.units[rank], unit, all, dist.units.data(), displs.data(), unit, 0, comm);
+    
+    MPI_Type_free(&unit);
+}
+
+// Scatters the padded coefficients of all ranks from rank 0, the inverse of
+// gather_coefficients
+static void scatter_coefficients(const mpi_distribution& dist, const complex< double >* all, complex< double >* values, MPI_Datatype cx, const int& rank, MPI_Comm comm)
+{
+    const int size = static_cast< int >(dist.units.size());
+    
+    std::vector< int > displs(size + 1, 0);
+    for (int q = 0; q < size; ++q)
+    {
+        displs[q + 1] = displs[q] + dist.units[q];
+    }
+    
+    MPI_Datatype unit;
+    MPI_Type_contiguous(dist.unit, cx, &unit);
+    MPI_Type_commit(&unit);
+    
+    MPI_Scatterv(all, dist.units.data(), displs.data(), unit, values, dist.units[rank], unit, 0, comm);
+    
+    MPI_Type_free(&unit);
+}
+
+// the beta-lines of a rank in the order of its orbits
+static void rank_lines(const mpi_distribution& dist, const int& q, const int& bw2, std::vector< size_t >& rows, std::vector< size_t >& cols)
+{
+    rows.clear();
+    cols.clear();
+    
+    int         oM[4], oN[4];
+    long double oS[4];
+    
+    for (size_t t = 0; t < dist.reps[q].size(); ++t)
+    {
+        const int r  = dist.reps[q][t];
+        const int M  = static_cast< int >(sqrt(static_cast< double >(r) + 0.5));
+        const int Mp = r - M * M - M;
+        const int n  = orbit_orders(M, Mp, oM, oN, oS);
+        
+        for (int o = 0; o < n; ++o)
+        {
+            rows.push_back(oN[o] >= 0 ? oN[o] : bw2 + oN[o]);
+            cols.push_back(oM[o] >= 0 ? oM[o] : bw2 + oM[o]);
+        }
+    }
+}
+
+// calls f(l, M, M') for the coefficients of a rank in the order of its
+// packed coefficients, i.e. by orbit, order and degree
+template< typename F >
+static void for_each_coefficient(const mpi_distribution& dist, const int& q, const int& bandlimit, const F& f)
+{
+    int         oM[4], oN[4];
+    long double oS[4];
+    
+    for (size_t t = 0; t < dist.reps[q].size(); ++t)
+    {
+        const int r  = dist.reps[q][t];
+        const int M  = static_cast< int >(sqrt(static_cast< double >(r) + 0.5));
+        const int Mp = r - M * M - M;
+        const int n  = orbit_orders(M, Mp, oM, oN, oS);
+        
+        for (int o = 0; o < n; ++o)
+        {
+            for (int l = M; l < bandlimit; ++l)
+            {
+                f(l, oM[o], oN[o]);
+            }
+        }
+    }
+}
+
+// The DWT of the orbits of a rank. The beta-lines are stored one after
+// another in the order of rank_lines, the coefficients in the order of
+// for_each_coefficient. The forward DWT maps lines to coefficients, the
+// inverse one coefficients to lines. An orbit (M, -M') that follows
+// (M, M') reuses its wigner d-matrix with flipped columns and negated odd
+// rows, like the shared memory DSOFT.
+static void orbit_dwt(const std::vector< int >& reps, const int& bandwidth, const int& bandlimit, complex< double >* line, complex< double >* values, const bool& forward, int threads)
+{
+    const int bw2 = 2 * bandwidth;
+    
+    // first line and first coefficient of every orbit, and the orbits
+    // that start a new wigner d-matrix
+    std::vector< int > lbase(reps.size() + 1, 0), vbase(reps.size() + 1, 0), starts;
+    for (size_t t = 0; t < reps.size(); ++t)
+    {
+        int         oM[4], oN[4];
+        long double oS[4];
+        
+        const int M  = static_cast< int >(sqrt(static_cast< double >(reps[t]) + 0.5));
+        const int Mp = reps[t] - M * M - M;
+        const int n  = orbit_orders(M, Mp, oM, oN, oS);
+        
+        lbase[t + 1] = lbase[t] + n;
+        vbase[t + 1] = vbase[t] + n * (bandlimit - M);
+        
+        if (!(Mp < 0 && t > 0 && reps[t - 1] == M * M + M - Mp))
+        {
+            starts.push_back(static_cast< int >(t));
+        }
+    }
+    
+    starts.push_back(static_cast< int >(reps.size()));
+    
+    // quadrature weights and norm of the analysis or the synthesis
+    vector< long double > weights(bw2);
+    DWT::quadrature_weights< long double >(weights);
+    
+    const long double norm = (forward ? constants< long double >::pi / (bandwidth * bw2) : 1 / (2 * constants< long double >::pi));
+    
+    int u;
+    #pragma omp parallel for schedule(dynamic) num_threads(threads) if(threads > 1)
+    for (u = 0; u < static_cast< int >(starts.size()) - 1; ++u)
+    {
+        const int M = static_cast< int >(sqrt(static_cast< double >(reps[starts[u]]) + 0.5));
+        
+        matrix< long double > d(bandlimit - M, bw2);
+        
+        for (int t = starts[u]; t < starts[u + 1]; ++t)
+        {
+            int         oM[4], oN[4];
+            long double oS[4];
+            
+            const int Mp = reps[t] - M * M - M;
+            const int n  = orbit_orders(M, Mp, oM, oN, oS);
+            
+            if (t == starts[u])
+            {
+                DWT::wigner_d_matrix< long double >(d, bandwidth, M, Mp);
+                
+                // the weights are symmetric, so weighting commutes with the flip
+                for (int i = 0; forward && i < bandlimit - M; ++i)
+                {
+                    for (int k = 0; k < bw2; ++k)
+                    {
+                        d(i, k) *= weights[k];
+                    }
+                }
+            }
+            else
+            {
+                // d^J_{M,-M'}(beta) = (-1)^{J-M} d^J_{M,M'}(pi - beta)
+                for (int i = 0; i < bandlimit - M; ++i)
+                {
+                    for (int k = 0; k < bandwidth; ++k)
+                    {
+                        std::swap(d(i, k), d(i, bw2 - 1 - k));
+                    }
+                    
+                    for (int k = 0; (i & 1) && k < bw2; ++k)
+                    {
+                        d(i, k) = -d(i, k);
+                    }
+                }
+            }
+            
+            for (int o = 0; o < n; ++o)
+            {
+                complex< double >*  s = line + static_cast< size_t >(lbase[t] + o) * bw2;
+                complex< double >*  v = values + vbase[t] + o * (bandlimit - M);
+                const long double   f = oS[o] * norm;
+                
+                if (forward)
+                {
+                    for (int l = M; l < bandlimit; ++l)
+                    {
+                        long double re = 0, im = 0;
+                        for (int k = 0; k < bw2; ++k)
+                        {
+                            re += s[k].re * d(l - M, k);
+                            im += s[k].im * d(l - M, k);
+                        }
+                        
+                        v[l - M] = complex< double >(static_cast< double >(f * re), static_cast< double >(f * im));
+                    }
+                }
+                else
+                {
+                    for (int k = 0; k < bw2; ++k)
+                    {
+                        long double re = 0, im = 0;
+                        for (int l = M; l < bandlimit; ++l)
+                        {
+                            re += v[l - M].re * d(l - M, k);
+                            im += v[l - M].im * d(l - M, k);
+                        }
+                        
+                        s[k] = complex< double >(static_cast< double >(f * re), static_cast< double >(f * im));
+                    }
+                }
+            }
+        }
+    }
+}
+
+/*!
+ * @brief           The \f$\beta\f$-layers of a rank for the distributed transforms
+ * @details         The \f$2B\f$ layers are distributed in contiguous blocks. The
+ *                  first \f$2B \bmod size\f$ ranks hold one layer more than the rest.
+ *
+ * @param[in]       bandwidth The bandwidth \f$B\f$ of the grid
+ * @param[in]       rank The rank
+ * @param[in]       size The number of ranks
+ * @param[out]      first The index of the first layer of the rank
+ * @param[out]      count The number of layers of the rank
+ *
+ * @sa              FourierTransforms::DSOFT_mpi
+ * @sa              FourierTransforms::IDSOFT_mpi
+ *
+ * @ingroup         FourierTransforms
+ *
+ * @since           1.0.0
+ */
+void DSOFT_mpi_layers(const int& bandwidth, const int& rank, const int& size, int& first, int& count)
+{
+    const int bw2  = 2 * bandwidth;
+    const int base = bw2 / size;
+    const int rem  = bw2 % size;
+    
+    first = rank * base + std::min(rank, rem);
+    count = base + (rank < rem ? 1 : 0);
+}
+
+/*!
+ * @brief           The forward DSOFT on a grid that is distributed over the ranks
+ *                  of an MPI communicator
+ * @details         Every rank holds the \f$\beta\f$-layers given by
+ *                  FourierTransforms::DSOFT_mpi_layers. The transform runs in three
+ *                  stages:
+ *
+ *                  1. every rank computes the layer-wise FFT2 of its layers,
+ *                  2. an all-to-all transpose sends every \f$\beta\f$-line
+ *                     \f$\hat{f}_{M,M'}(\beta_k)\f$, \f$k = 0,\dots,2B-1\f$, to the
+ *                     rank that owns the symmetry orbit of \f$(M, M')\f$,
+ *                  3. every rank computes the DWT of its orbits and the coefficients
+ *                     are gathered on rank 0.
+ *
+ *                  The orbits are distributed in the symmetry groups of the shared
+ *                  memory DSOFT such that all ranks do about the same DWT work.
+ *                  Within a rank the FFT2 and the DWT use the given number of
+ *                  threads. Lines that belong to no orbit, e.g. the orders
+ *                  \f$\pm B\f$, are not sent.
+ *
+ * @param[in]       slab The layers of this rank, a grid of \f$2B\times 2B\times count\f$
+ *                  samples
+ * @param[in]       bandwidth The bandwidth \f$B\f$ of the distributed grid
+ * @param[in,out]   fc A Fourier coefficient container with the same bandwidth on all
+ *                  ranks, which must not exceed \f$B\f$. The coefficients are
+ *                  complete on rank 0 only, other ranks keep their former content.
+ * @param[in]       comm The communicator of all ranks that hold layers
+ * @param[in]       threads The number of threads per rank
+ *
+ * @sa              FourierTransforms::IDSOFT_mpi
+ * @sa              FourierTransforms::DSOFT
+ *
+ * @ingroup         FourierTransforms
+ *
+ * @since           1.0.0
+ */
+void DSOFT_mpi(const grid3D< complex< double > >& slab, const int& bandwidth, DSOFTFourierCoefficients& fc, MPI_Comm comm, int threads)
+{
+    int rank, size;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &size);
+    
+    const int bw2       = 2 * bandwidth;
+    const int bandlimit = fc.bandwidth;
+    
+    int first, count;
+    DSOFT_mpi_layers(bandwidth, rank, size, first, count);
+    
+    /*****************************************************************
+     ** Check parameters                                            **
+     *****************************************************************/
+    pfsoft_cond_w_ret(slab.rows != static_cast< size_t >(bw2) || slab.cols != static_cast< size_t >(bw2) || slab.lays != static_cast< size_t >(count), "%s", "DSOFT slab does not hold the layers of this rank.");
+    
+    if (slab.rows != static_cast< size_t >(bw2) || slab.cols != static_cast< size_t >(bw2) || slab.lays != static_cast< size_t >(count))
+    {
+        return;
+    }
+    
+    pfsoft_cond_w_ret(bandlimit > bandwidth || bandlimit < 1, "%s", "DSOFT Fourier coefficients container bandwidth exceeds the sample grid bandwidth.");
+    
+    // print warinings for serial implementation
+    #ifndef _OPENMP
+    pfsoft_cond_w(threads != 1, "%s", "compiler does not support OpenMP. Changing the number of threads for the DSOFT has no effect.");
+    #endif
+    
+    mpi_distribution dist;
+    distribute(bandlimit, size, dist);
+    
+    MPI_Datatype cx;
+    MPI_Type_contiguous(2, MPI_DOUBLE, &cx);
+    MPI_Type_commit(&cx);
+    
+    /*****************************************************************
+     ** FFT2 of the layers of this rank                             **
+     *****************************************************************/
+    grid3D< complex< double > > buffer(bw2, bw2, std::max(count, 1));
+    
+    if (count > 0)
+    {
+        slab.copy_layers(access::rwp(buffer.mem), 0, count);
+        
+        double* data = reinterpret_cast< double* >(access::rwp(buffer.mem));
+        
+        uzl_fftw_layer_context ctx;
+        uzl_fftw_layer_context_create(&ctx, bw2, bw2, count, data, -1);
+        uzl_fftw_layer_context_execute(&ctx, data, threads);
+        uzl_fftw_layer_context_destroy(&ctx);
+    }
+    
+    /*****************************************************************
+     ** All-to-all transpose of the beta-lines                      **
+     *****************************************************************/
+    // lines are sent in units of the layers of this rank and received in
+    // units of the lines of this rank, so no count grows with B^3
+    const int lines = dist.lines[rank];
+    
+    MPI_Datatype stype, rtype;
+    MPI_Type_contiguous(std::max(count, 1), cx, &stype);
+    MPI_Type_contiguous(std::max(lines, 1), cx, &rtype);
+    MPI_Type_commit(&stype);
+    MPI_Type_commit(&rtype);
+    
+    std::vector< int > scounts(size), sdispls(size + 1, 0), rcounts(size), rdispls(size + 1, 0);
+    for (int q = 0; q < size; ++q)
+    {
+        int qfirst, qcount;
+        DSOFT_mpi_layers(bandwidth, q, size, qfirst, qcount);
+        
+        scounts[q]     = (count > 0 ? dist.lines[q] : 0);
+        rcounts[q]     = (lines > 0 ? qcount : 0);
+        sdispls[q + 1] = sdispls[q] + dist.lines[q];
+        rdispls[q + 1] = qfirst + qcount;
+    }
+    
+    std::vector< complex< double > > send(std::max(static_cast< size_t >(sdispls[size]) * count, static_cast< size_t >(1)));
+    std::vector< complex< double > > recv(std::max(static_cast< size_t >(lines) * bw2, static_cast< size_t >(1)));
+    std::vector< size_t >            rows, cols;
+    
+    for (int q = 0; q < size; ++q)
+    {
+        rank_lines(dist, q, bw2, rows, cols);
+        
+        complex< double >* s = send.data() + static_cast< size_t >(sdispls[q]) * count;
+        for (size_t i = 0; i < rows.size(); ++i)
+        {
+            for (int j = 0; j < count; ++j)
+            {
+                *s++ = buffer(rows[i], cols[i], j);
+            }
+        }
+    }
+    
+    MPI_Alltoallv(send.data(), scounts.data(), sdispls.data(), stype, recv.data(), rcounts.data(), rdispls.data(), rtype, comm);
+    
+    MPI_Type_free(&stype);
+    MPI_Type_free(&rtype);
+    
+    // reassemble complete beta-lines
+    std::vector< complex< double > > line(static_cast< size_t >(std::max(lines, 1)) * bw2);
+    
+    for (int p = 0; p < size; ++p)
+    {
+        int pfirst, pcount;
+        DSOFT_mpi_layers(bandwidth, p, size, pfirst, pcount);
+        
+        const complex< double >* r = recv.data() + static_cast< size_t >(lines) * pfirst;
+        for (int i = 0; i < lines; ++i)
+        {
+            std::copy(r + static_cast< size_t >(i) * pcount, r + static_cast< size_t >(i + 1) * pcount, line.begin() + static_cast< size_t >(i) * bw2 + pfirst);
+        }
+    }
+    
+    /*****************************************************************
+     ** DWT of the orbits of this rank                              **
+     *****************************************************************/
+    std::vector< complex< double > > values(std::max(padded(dist, rank), static_cast< size_t >(1)));
+    orbit_dwt(dist.reps[rank], bandwidth, bandlimit, line.data(), values.data(), true, threads);
+    
+    /*****************************************************************
+     ** Gather the coefficients on rank 0                           **
+     *****************************************************************/
+    size_t total = 0;
+    for (int q = 0; q < size; ++q)
+    {
+        total += padded(dist, q);
+    }
+    
+    std::vector< complex< double > > all(rank == 0 ? total : 1);
+    gather_coefficients(dist, values.data(), all.data(), cx, rank, comm);
+    
+    if (rank == 0)
+    {
+        size_t offset = 0;
+        for (int q = 0; q < size; ++q)
+        {
+            const complex< double >* v = all.data() + offset;
+            for_each_coefficient(dist, q, bandlimit, [&](const int& l, const int& M, const int& Mp) { fc(l, M, Mp) = *v++; });
+            offset += padded(dist, q);
+        }
+    }
+    
+    MPI_Type_free(&cx);
+}
+
+/*!
+ * @brief           The inverse DSOFT that synthesizes a grid distributed over the
+ *                  ranks of an MPI communicator
+ * @details         The reverse pipeline of FourierTransforms::DSOFT_mpi. The
+ *                  coefficients of every orbit are scattered from rank 0 to the
+ *                  owner of the orbit, which synthesizes the complete
+ *                  \f$\beta\f$-lines of its orders. An all-to-all transpose sends
+ *                  the lines to the ranks that hold the layers and every rank
+ *                  computes the layer-wise IFFT2 of its layers.
+ *
+ * @param[in]       fc A Fourier coefficient container with the same bandwidth on all
+ *                  ranks, which must not exceed \f$B\f$. Only the coefficients on
+ *                  rank 0 are used.
+ * @param[in]       bandwidth The bandwidth \f$B\f$ of the distributed grid
+ * @param[out]      slab The layers of this rank, a grid of \f$2B\times 2B\times count\f$
+ *                  samples
+ * @param[in]       comm The communicator of all ranks that hold layers
+ * @param[in]       threads The number of threads per rank
+ *
+ * @sa              FourierTransforms::DSOFT_mpi
+ * @sa              FourierTransforms::DSOFT_mpi_layers
+ *
+ * @ingroup         FourierTransforms
+ *
+ * @since           1.0.0
+ */
+void IDSOFT_mpi(const DSOFTFourierCoefficients& fc, const int& bandwidth, grid3D< complex< double > >& slab, MPI_Comm comm, int threads)
+{
+    int rank, size;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &size);
+    
+    const int bw2       = 2 * bandwidth;
+    const int bandlimit = fc.bandwidth;
+    
+    int first, count;
+    DSOFT_mpi_layers(bandwidth, rank, size, first, count);
+    
+    /*****************************************************************
+     ** Check parameters                                            **
+     *****************************************************************/
+    pfsoft_cond_w_ret(slab.rows != static_cast< size_t >(bw2) || slab.cols != static_cast< size_t >(bw2) || slab.lays != static_cast< size_t >(count), "%s", "IDSOFT slab does not hold the layers of this rank.");
+    
+    if (slab.rows != static_cast< size_t >(bw2) || slab.cols != static_cast< size_t >(bw2) || slab.lays != static_cast< size_t >(count))
+    {
+        return;
+    }
+    
+    pfsoft_cond_w_ret(bandlimit > bandwidth || bandlimit < 1, "%s", "IDSOFT Fourier coefficients container bandwidth exceeds the synthesis bandwidth.");
+    
+    // print warinings for serial implementation
+    #ifndef _OPENMP
+    pfsoft_cond_w(threads != 1, "%s", "compiler does not support OpenMP. Changing the number of threads for the IDSOFT has no effect.");
+    #endif
+    
+    mpi_distribution dist;
+    distribute(bandlimit, size, dist);
+    
+    MPI_Datatype cx;
+    MPI_Type_contiguous(2, MPI_DOUBLE, &cx);
+    MPI_Type_commit(&cx);
+    
+    /*****************************************************************
+     ** Scatter the coefficients from rank 0                        **
+     *****************************************************************/
+    size_t total = 0;
+    for (int q = 0; q < size; ++q)
+    {
+        total += padded(dist, q);
+    }
+    
+    std::vector< complex< double > > all(rank == 0 ? total : 1);
+    std::vector< complex< double > > values(std::max(padded(dist, rank), static_cast< size_t >(1)));
+    
+    if (rank == 0)
+    {
+        size_t offset = 0;
+        for (int q = 0; q < size; ++q)
+        {
+            complex< double >* v = all.data() + offset;
+            for_each_coefficient(dist, q, bandlimit, [&](const int& l, const int& M, const int& Mp) { *v++ = fc(l, M, Mp); });
+            offset += padded(dist, q);
+        }
+    }
+    
+    scatter_coefficients(dist, all.data(), values.data(), cx, rank, comm);
+    
+    /*****************************************************************
+     ** DWT of the orbits of this rank                              **
+     *****************************************************************/
+    const int lines = dist.lines[rank];
+    std::vector< complex< double > > line(static_cast< size_t >(std::max(lines, 1)) * bw2);
+    
+    orbit_dwt(dist.reps[rank], bandwidth, bandlimit, line.data(), values.data(), false, threads);
+    
+    /*****************************************************************
+     ** All-to-all transpose of the beta-lines                      **
+     *****************************************************************/
+    // the reverse of the forward transpose, lines are sent in units of the
+    // lines of this rank and received in units of the layers of this rank
+    MPI_Datatype stype, rtype;
+    MPI_Type_contiguous(std::max(lines, 1), cx, &stype);
+    MPI_Type_contiguous(std::max(count, 1), cx, &rtype);
+    MPI_Type_commit(&stype);
+    MPI_Type_commit(&rtype);
+    
+    std::vector< int > scounts(size), sdispls(size + 1, 0), rcounts(size), rdispls(size + 1, 0);
+    for (int q = 0; q < size; ++q)
+    {
+        int qfirst, qcount;
+        DSOFT_mpi_layers(bandwidth, q, size, qfirst, qcount);
+        
+        scounts[q]     = (lines > 0 ? qcount : 0);
+        rcounts[q]     = (count > 0 ? dist.lines[q] : 0);
+        sdispls[q + 1] = qfirst + qcount;
+        rdispls[q + 1] = rdispls[q] + dist.lines[q];
+    }
+    
+    std::vector< complex< double > > send(std::max(static_cast< size_t >(lines) * bw2, static_cast< size_t >(1)));
+    std::vector< complex< double > > recv(std::max(static_cast< size_t >(rdispls[size]) * count, static_cast< size_t >(1)));
+    
+    for (int q = 0; q < size; ++q)
+    {
+        int qfirst, qcount;
+        DSOFT_mpi_layers(bandwidth, q, size, qfirst, qcount);
+        
+        complex< double >* s = send.data() + static_cast< size_t >(lines) * qfirst;
+        for (int i = 0; i < lines; ++i)
+        {
+            const complex< double >* src = line.data() + static_cast< size_t >(i) * bw2 + qfirst;
+            s = std::copy(src, src + qcount, s);
+        }
+    }
+    
+    MPI_Alltoallv(send.data(), scounts.data(), sdispls.data(), stype, recv.data(), rcounts.data(), rdispls.data(), rtype, comm);
+    
+    MPI_Type_free(&stype);
+    MPI_Type_free(&rtype);
+    
+    /*****************************************************************
+     ** IFFT2 of the layers of this rank                            **
+     *****************************************************************/
+    if (count > 0)
+    {
+        // lines of no orbit stay zero
+        grid3D< complex< double > > buffer(bw2, bw2, count);
+        std::fill(access::rwp(buffer.mem), access::rwp(buffer.mem) + static_cast< size_t >(bw2) * bw2 * count, complex< double >(0, 0));
+        
+        std::vector< size_t > rows, cols;
+        for (int q = 0; q < size; ++q)
+        {
+            rank_lines(dist, q, bw2, rows, cols);
+            
+            const complex< double >* r = recv.data() + static_cast< size_t >(rdispls[q]) * count;
+            for (size_t i = 0; i < rows.size(); ++i)
+            {
+                for (int j = 0; j < count; ++j)
+                {
+                    buffer(rows[i], cols[i], j) = *r++;
+                }
+            }
+        }
+        
+        double* data = reinterpret_cast< double* >(access::rwp(buffer.mem));
+        
+        uzl_fftw_layer_context ctx;
+        uzl_fftw_layer_context_create(&ctx, bw2, bw2, count, data, +1);
+        uzl_fftw_layer_context_execute(&ctx, data, threads);
+        uzl_fftw_layer_context_destroy(&ctx);
+        
+        slab.assign_layers(buffer.mem, 0, count);
+    }
+    
+    MPI_Type_free(&cx);
+}
+
+/*!
+ * @brief           The forward DSOFT of a grid on rank 0 with the DWT distributed
+ *                  over the ranks of an MPI communicator
+ * @details         Unlike the slab-decomposed FourierTransforms::DSOFT_mpi the sample
+ *                  is held by rank 0, which computes the layer-wise FFT2 with the
+ *                  given number of threads. The DWT is distributed in the symmetry
+ *                  groups of FourierTransforms::DSOFT, each of which needs only the
+ *                  up to eight \f$\beta\f$-lines of its orders. Rank 0 scatters exactly
+ *                  these lines to the owner of a group and gathers the coefficients
+ *                  of every rank. This sends less than a single full transpose and
+ *                  no line twice, but rank 0 has to hold the whole grid.
+ *
+ * @param[in]       sample A discrete sample of function \f$f\f$ of dimension
+ *                  \f$2B\times 2B\times 2B\f$. Only used on rank 0.
+ * @param[in,out]   fc A Fourier coefficient container with the same bandwidth on all
+ *                  ranks, which must not exceed \f$B\f$. The coefficients are
+ *                  complete on rank 0 only, other ranks keep their former content.
+ * @param[in]       comm The communicator of all ranks that take part in the DWT
+ * @param[in]       threads The number of threads per rank
+ *
+ * @sa              FourierTransforms::IDSOFT_mpi
+ * @sa              FourierTransforms::DSOFT
+ *
+ * @ingroup         FourierTransforms
+ *
+ * @since           1.0.0
+ */
+void DSOFT_mpi(const grid3D< complex< double > >& sample, DSOFTFourierCoefficients& fc, MPI_Comm comm, int threads)
+{
+    int rank, size;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &size);
+    
+    /*****************************************************************
+     ** Check parameters                                            **
+     *****************************************************************/
+    // the bandwidth of the sample is known on rank 0 only, 0 marks an invalid sample
+    int bandwidth = 0;
+    if (rank == 0)
+    {
+        const bool valid = sample.rows == sample.cols && sample.rows == sample.lays && !(sample.rows & 1) && fc.bandwidth >= 1 && static_cast< size_t >(2 * fc.bandwidth) <= sample.rows;
+        
+        pfsoft_cond_w(!valid, "%s", "DSOFT sample grid is not a 2B x 2B x 2B grid for the bandwidth of the Fourier coefficients container.");
+        
+        bandwidth = (valid ? static_cast< int >(sample.cols / 2) : 0);
+    }
+    
+    MPI_Bcast(&bandwidth, 1, MPI_INT, 0, comm);
+    
+    if (bandwidth == 0)
+    {
+        return;
+    }
+    
+    // print warinings for serial implementation
+    #ifndef _OPENMP
+    pfsoft_cond_w(threads != 1, "%s", "compiler does not support OpenMP. Changing the number of threads for the DSOFT has no effect.");
+    #endif
+    
+    const int bw2       = 2 * bandwidth;
+    const int bandlimit = fc.bandwidth;
+    
+    mpi_distribution dist;
+    distribute(bandlimit, size, dist);
+    
+    MPI_Datatype cx;
+    MPI_Type_contiguous(2, MPI_DOUBLE, &cx);
+    MPI_Type_commit(&cx);
+    
+    // beta-lines are sent as one unit, the counts of complex elements would
+    // exceed INT_MAX from B = 640 on
+    MPI_Datatype bline;
+    MPI_Type_contiguous(bw2, cx, &bline);
+    MPI_Type_commit(&bline);
+    
+    std::vector< int > counts(size), displs(size + 1, 0);
+    for (int q = 0; q < size; ++q)
+    {
+        counts[q]     = dist.lines[q];
+        displs[q + 1] = displs[q] + counts[q];
+    }
+    
+    /*****************************************************************
+     ** FFT2 on rank 0 and scatter of the needed beta-lines         **
+     *****************************************************************/
+    std::vector< complex< double > > send(rank == 0 ? static_cast< size_t >(displs[size]) * bw2 : 1);
+    
+    if (rank == 0)
+    {
+        grid3D< complex< double > > buffer(bw2, bw2, bw2);
+        sample.copy_layers(access::rwp(buffer.mem), 0, bw2);
+        
+        double* data = reinterpret_cast< double* >(access::rwp(buffer.mem));
+        
+        uzl_fftw_layer_context ctx;
+        uzl_fftw_layer_context_create(&ctx, bw2, bw2, bw2, data, -1);
+        uzl_fftw_layer_context_execute(&ctx, data, threads);
+        uzl_fftw_layer_context_destroy(&ctx);
+        
+        std::vector< size_t > rows, cols;
+        complex< double >*    s = send.data();
+        
+        for (int q = 0; q < size; ++q)
+        {
+            rank_lines(dist, q, bw2, rows, cols);
+            
+            for (size_t i = 0; i < rows.size(); ++i)
+            {
+                for (int k = 0; k < bw2; ++k)
+                {
+                    *s++ = buffer(rows[i], cols[i], k);
+                }
+            }
+        }
+    }
+    
+    std::vector< complex< double > > line(static_cast< size_t >(std::max(counts[rank], 1)) * bw2);
+    MPI_Scatterv(send.data(), counts.data(), displs.data(), bline, line.data(), counts[rank], bline, 0, comm);
+    
+    /*****************************************************************
+     ** DWT of the symmetry groups of this rank                     **
+     *****************************************************************/
+    std::vector< complex< double > > values(std::max(padded(dist, rank), static_cast< size_t >(1)));
+    orbit_dwt(dist.reps[rank], bandwidth, bandlimit, line.data(), values.data(), true, threads);
+    
+    /*****************************************************************
+     ** Gather the coefficients on rank 0                           **
+     *****************************************************************/
+    size_t total = 0;
+    for (int q = 0; q < size; ++q)
+    {
+        total += padded(dist, q);
+    }
+    
+    std::vector< complex< double > > all(rank == 0 ? total : 1);
+    gather_coefficients(dist, values.data(), all.data(), cx, rank, comm);
+    
+    if (rank == 0)
+    {
+        size_t offset = 0;
+        for (int q = 0; q < size; ++q)
+        {
+            const complex< double >* v = all.data() + offset;
+            for_each_coefficient(dist, q, bandlimit, [&](const int& l, const int& M, const int& Mp) { fc(l, M, Mp) = *v++; });
+            offset += padded(dist, q);
+        }
+    }
+    
+    MPI_Type_free(&bline);
+    MPI_Type_free(&cx);
+}
+
+/*!
+ * @brief           The inverse DSOFT of a grid on rank 0 with the DWT distributed
+ *                  over the ranks of an MPI communicator
+ * @details         The reverse of the grid-on-root FourierTransforms::DSOFT_mpi. The
+ *                  coefficients of every symmetry group are scattered from rank 0 to
+ *                  its owner, which synthesizes the \f$\beta\f$-lines of the group.
+ *                  Rank 0 gathers the lines and computes the layer-wise IFFT2.
+ *
+ * @param[in]       fc A Fourier coefficient container with the same bandwidth on all
+ *                  ranks, which must not exceed \f$B\f$. Only the coefficients on
+ *                  rank 0 are used.
+ * @param[out]      synthesis A grid of dimension \f$2B\times 2B\times 2B\f$ on rank 0.
+ *                  Not used on other ranks.
+ * @param[in]       comm The communicator of all ranks that take part in the DWT
+ * @param[in]       threads The number of threads per rank
+ *
+ * @sa              FourierTransforms::DSOFT_mpi
+ * @sa              FourierTransforms::IDSOFT
+ *
+ * @ingroup         FourierTransforms
+ *
+ * @since           1.0.0
+ */
+void IDSOFT_mpi(const DSOFTFourierCoefficients& fc, grid3D< complex< double > >& synthesis, MPI_Comm comm, int threads)
+{
+    int rank, size;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &size);
+    
+    /*****************************************************************
+     ** Check parameters                                            **
+     *****************************************************************/
+    // the bandwidth of the synthesis is known on rank 0 only, 0 marks an invalid grid
+    int bandwidth = 0;
+    if (rank == 0)
+    {
+        const bool valid = synthesis.rows == synthesis.cols && synthesis.rows == synthesis.lays && !(synthesis.rows & 1) && fc.bandwidth >= 1 && static_cast< size_t >(2 * fc.bandwidth) <= synthesis.rows;
+        
+        pfsoft_cond_w(!valid, "%s", "IDSOFT synthesis grid is not a 2B x 2B x 2B grid for the bandwidth of the Fourier coefficients container.");
+        
+        bandwidth = (valid ? static_cast< int >(synthesis.cols / 2) : 0);
+    }
+    
+    MPI_Bcast(&bandwidth, 1, MPI_INT, 0, comm);
+    
+    if (bandwidth == 0)
+    {
+        return;
+    }
+    
+    // print warinings for serial implementation
+    #ifndef _OPENMP
+    pfsoft_cond_w(threads != 1, "%s", "compiler does not support OpenMP. Changing the number of threads for the IDSOFT has no effect.");
+    #endif
+    
+    const int bw2       = 2 * bandwidth;
+    const int bandlimit = fc.bandwidth;
+    
+    mpi_distribution dist;
+    distribute(bandlimit, size, dist);
+    
+    MPI_Datatype cx;
+    MPI_Type_contiguous(2, MPI_DOUBLE, &cx);
+    MPI_Type_commit(&cx);
+    
+    /*****************************************************************
+     ** Scatter the coefficients from rank 0                        **
+     *****************************************************************/
+    size_t total = 0;
+    for (int q = 0; q < size; ++q)
+    {
+        total += padded(dist, q);
+    }
+    
+    std::vector< complex< double > > all(rank == 0 ? total : 1);
+    std::vector< complex< double > > values(std::max(padded(dist, rank), static_cast< size_t >(1)));
+    
+    if (rank == 0)
+    {
+        size_t offset = 0;
+        for (int q = 0; q < size; ++q)
+        {
+            complex< double >* v = all.data() + offset;
+            for_each_coefficient(dist, q, bandlimit, [&](const int& l, const int& M, const int& Mp) { *v++ = fc(l, M, Mp); });
+            offset += padded(dist, q);
+        }
+    }
+    
+    scatter_coefficients(dist, all.data(), values.data(), cx, rank, comm);
+    
+    /*****************************************************************
+     ** DWT of the symmetry groups of this rank                     **
+     *****************************************************************/
+    // beta-lines are sent as one unit, the counts of complex elements would
+    // exceed INT_MAX from B = 640 on
+    MPI_Datatype bline;
+    MPI_Type_contiguous(bw2, cx, &bline);
+    MPI_Type_commit(&bline);
+    
+    std::vector< int > counts(size), displs(size + 1, 0);
+    for (int q = 0; q < size; ++q)
+    {
+        counts[q]     = dist.lines[q];
+        displs[q + 1] = displs[q] + counts[q];
+    }
+    
+    std::vector< complex< double > > line(static_cast< size_t >(std::max(counts[rank], 1)) * bw2);
+    orbit_dwt(dist.reps[rank], bandwidth, bandlimit, line.data(), values.data(), false, threads);
+    
+    /*****************************************************************
+     ** Gather the beta-lines and IFFT2 on rank 0                   **
+     *****************************************************************/
+    std::vector< complex< double > > recv(rank == 0 ? static_cast< size_t >(displs[size]) * bw2 : 1);
+    MPI_Gatherv(line.data(), counts[rank], bline, recv.data(), counts.data(), displs.data(), bline, 0, comm);
+    
+    if (rank == 0)
+    {
+        // lines of no orbit stay zero
+        grid3D< complex< double > > buffer(bw2, bw2, bw2);
+        std::fill(access::rwp(buffer.mem), access::rwp(buffer.mem) + static_cast< size_t >(bw2) * bw2 * bw2, complex< double >(0, 0));
+        
+        std::vector< size_t >    rows, cols;
+        const complex< double >* r = recv.data();
+        
+        for (int q = 0; q < size; ++q)
+        {
+            rank_lines(dist, q, bw2, rows, cols);
+            
+            for (size_t i = 0; i < rows.size(); ++i)
+            {
+                for (int k = 0; k < bw2; ++k)
+                {
+                    buffer(rows[i], cols[i], k) = *r++;
+                }
+            }
+        }
+        
+        double* data = reinterpret_cast< double* >(access::rwp(buffer.mem));
+        
+        uzl_fftw_layer_context ctx;
+        uzl_fftw_layer_context_create(&ctx, bw2, bw2, bw2, data, +1);
+        uzl_fftw_layer_context_execute(&ctx, data, threads);
+        uzl_fftw_layer_context_destroy(&ctx);
+        
+        synthesis.assign_layers(buffer.mem, 0, bw2);
+    }
+    
+    MPI_Type_free(&bline);
+    MPI_Type_free(&cx);
+}
+
+PFSOFT_NAMESPACE_END
+
+#endif
@@ -0,0 +1,310 @@
+//
+//  fn_dsoft_stream.cpp
+//  PFSOFTlib
+//
+//   Created by Denis-Michael Lux on 05. November 2015.
+//
+//   This file is part of PFSOFTlib.
+//
+//   PFSOFTlib is free software: you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License as published by
+//   the Free Software Foundation, either version 3 of the License, or
+//   (at your option) any later version.
+//
+//   PFSOFTlib is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with PFSOFTlib.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <algorithm>
+
+#include <pfsoft>
+
+PFSOFT_NAMESPACE(FourierTransforms)
+
+/*!
+ * @brief           The number of \f$\beta\f$-layers per slab for the slab-wise
+ *                  transforms of a bandwidth
+ * @details         A slab holds as many layers of \f$2B\times 2B\f$ complex
+ *                  samples as fit into DSOFT_SLAB_MEMORY bytes, but at least one
+ *                  and at most \f$2B\f$ layers.
+ *
+ * @param[in]       bandwidth The bandwidth \f$B\f$ of the grid
+ * @return          The number of layers per slab
+ *
+ * @ingroup         FourierTransforms
+ *
+ * @since           1.0.0
+ */
+int DSOFT_slab_layers(const int& bandwidth)
+{
+    const size_t layer  = 4 * static_cast< size_t >(bandwidth) * bandwidth * sizeof(complex< double >);
+    const size_t layers = static_cast< size_t >(DSOFT_SLAB_MEMORY) / std::max< size_t >(layer, 1);
+    
+    return static_cast< int >(std::max< size_t >(1, std::min< size_t >(layers, 2 * bandwidth)));
+}
+
+/*!
+ * @brief           The slab-wise DSOFT that records its timing breakdown to stats
+ *                  if stats is not nullptr
+ */
+static void dsoft_stream(const grid3D< complex< double > >& sample, DSOFTFourierCoefficients& fc, const int& block, DSOFTStats* stats, int threads)
+{
+    /*****************************************************************
+     ** Check parameters                                            **
+     *****************************************************************/
+    // Check if the grid has same size in each dimension
+    pfsoft_cond_w_ret(sample.rows != sample.cols || sample.rows != sample.lays, "%s", "all DSOFT sample grid dimensions should be equal.");
+    
+    // Check if grid has odd dimensions
+    pfsoft_cond_w_ret(sample.rows & 1, "%s", "DSOFT sample grid dimensions are not even.");
+    
+    // Extract bandwidth
+    const int bandwidth = static_cast< int >(sample.cols / 2);
+    
+    // Check if Fourier coefficients container dimension fits to the sample dimension
+    pfsoft_cond_w_ret(fc.bandwidth > bandwidth || fc.bandwidth < 1, "%s", "DSOFT Fourier coefficients container bandwidth exceeds the sample grid bandwidth.");
+    
+    // Check block size
+    pfsoft_cond_w_ret(block < 1, "%s", "DSOFT stream block size has to be positive.");
+    
+    // print warinings for serial implementation
+    #ifndef _OPENMP
+    pfsoft_cond_w(threads != 1, "%s", "compiler does not support OpenMP. Changing the number of threads for the DSOFT has no effect.");
+    #endif
+    
+    // precompute the double bandwidth and the effective bandlimit
+    const int bw2       = 2 * bandwidth;
+    const int bandlimit = fc.bandwidth;
+    const int layers    = std::min(block, bw2);
+    
+    // number of threads from the tuning profile and whether the
+    // (M, M') loop runs in parallel for this bandwidth
+    threads             = DSOFT_threads(bandwidth, threads);
+    const bool parallel = threads > 1 && bandwidth >= DSOFT_threshold();
+    
+    if (stats != nullptr)
+    {
+        stats->reset(bandwidth, parallel ? threads : 1);
+    }
+    
+    // lap timer of the stages that run on the calling thread
+    pfsoft_stats_timer(lap, stats);
+    
+    // Representatives M >= |M'| of the symmetry orbits. They are
+    // enumerated by r = M^2 + M + M'.
+    const int reps = bandlimit * bandlimit;
+    
+    // quadrature weights and norm of the analysis
+    vector< long double > weights(bw2);
+    DWT::quadrature_weights< long double >(weights);
+    
+    const long double norm = constants< long double >::pi / (bandwidth * bw2);
+    
+    // the coefficients are accumulated over all slabs
+    for (int l = 0; l < bandlimit; ++l)
+    {
+        for (int M = -l; M <= l; ++M)
+        {
+            for (int Mp = -l; Mp <= l; ++Mp)
+            {
+                fc(l, M, Mp) = complex< double >(0, 0);
+            }
+        }
+    }
+    
+    pfsoft_stats_lap(lap, SCATTER);
+    
+    // slab buffer and FFT2 plan for one slab
+    grid3D< complex< double > > buffer(bw2, bw2, layers);
+    double* data = reinterpret_cast< double* >(access::rwp(buffer.mem));
+    
+    uzl_fftw_layer_context ctx;
+    uzl_fftw_layer_context_create(&ctx, bw2, bw2, layers, data, -1);
+    
+    sample.prefetch_layers(0, layers);
+    
+    for (int first = 0; first < bw2; first += layers)
+    {
+        const int count = std::min(layers, bw2 - first);
+        
+        // read the slab and request the next one while this one is transformed
+        sample.copy_layers(access::rwp(buffer.mem), first, count);
+        
+        sample.release_layers(first, count);
+        sample.prefetch_layers(first + count, layers);
+        
+        /*****************************************************************
+         ** FFT2 of the layers of this slab                             **
+         *****************************************************************/
+        uzl_fftw_layer_context part = ctx;
+        part.lays                   = count;
+        uzl_fftw_layer_context_execute(&part, data, threads); pfsoft_stats_lap(lap, FFT);
+        
+        /*****************************************************************
+         ** DWT contribution of this slab for all orders                **
+         *****************************************************************/
+        #pragma omp parallel default(shared) if(parallel) num_threads(threads)
+        {
+            pfsoft_stats_timer(lap, stats);
+            
+            int r;
+            #pragma omp for schedule(dynamic) nowait
+            for (r = 0; r < reps; ++r)
+            {
+                // reconstruct the orders of the representative
+                int M = static_cast< int >(sqrt(static_cast< double >(r)));
+                while (M * M > r)             { --M; }
+                while ((M + 1) * (M + 1) <= r) { ++M; }
+                
+                const int Mp = r - M * M - M;
+                
+                pfsoft_stats_group(lap, M, Mp);
+                
+                // weighted wigner d-matrix for the columns of this slab
+                matrix< long double > dw(bandlimit - M, count);
+                DWT::wigner_d_matrix< long double >(dw, bandwidth, M, Mp, first);
+                
+                for (int i = 0; i < bandlimit - M; ++i)
+                {
+                    for (int j = 0; j < count; ++j)
+                    {
+                        dw(i, j) *= weights[first + j];
+                    }
+                }
+                
+                pfsoft_stats_lap(lap, WIGNER);
+                
+                // the kernel sign of a representative is -1, see DWT::kernel_sign
+                const long double sign   = -norm;
+                const long double parity = ((M - Mp) & 1 ? -1 : 1);
+                
+                // orders that share the wigner d-matrix and their signs
+                const int         oM[4] = { M, Mp, -Mp, -M  };
+                const int         oN[4] = { Mp, M, -M, -Mp };
+                const long double oS[4] = { sign, parity * sign, sign, parity * sign };
+                
+                for (int o = 0; o < 4; ++o)
+                {
+                    // skip orders that already occured in this orbit
+                    bool seen = false;
+                    for (int p = 0; p < o; ++p)
+                    {
+                        seen = seen || (oM[p] == oM[o] && oN[p] == oN[o]);
+                    }
+                    
+                    if (seen)
+                    {
+                        continue;
+                    }
+                    
+                    const size_t row = (oN[o] >= 0 ? oN[o] : bw2 + oN[o]);
+                    const size_t col = (oM[o] >= 0 ? oM[o] : bw2 + oM[o]);
+                    
+                    for (int l = M; l < bandlimit; ++l)
+                    {
+                        long double re = 0, im = 0;
+                        for (int j = 0; j < count; ++j)
+                        {
+                            const complex< double >& s = buffer(row, col, j);
+                            re += s.re * dw(l - M, j);
+                            im += s.im * dw(l - M, j);
+                        }
+                        
+                        fc(l, oM[o], oN[o]) += complex< double >(static_cast< double >(oS[o] * re), static_cast< double >(oS[o] * im));
+                    }
+                }
+                
+                pfsoft_stats_lap(lap, DWT);
+            }
+            
+            pfsoft_stats_merge(lap, true);
+        }
+        
+        pfsoft_stats_loops(lap);
+    }
+    
+    uzl_fftw_layer_context_destroy(&ctx); pfsoft_stats_lap(lap, FFT);
+    pfsoft_stats_merge(lap, false);
+}
+
+/*!
+ * @brief           The DSOFT that reads the sample slab by slab of \f$\beta\f$-layers
+ * @details         Computes the same Fourier coefficients as FourierTransforms::DSOFT
+ *                  in a single sequential pass over the sample. The quadrature sum
+ *                  over \f$k\f$ is split into slabs of layers. Every slab is copied
+ *                  into a buffer of \f$2B\times 2B\times block\f$ elements, transformed
+ *                  by the layer-wise FFT2 and its contribution
+ *                  \f[
+ *                      \frac{\pi}{(2B)^2}\sum\limits_{k\in\mathrm{slab}}w_B(k)
+ *                          \tilde{d}^l_{M,M'}(\beta_k)\hat{f}_{M,M'}(\beta_k)
+ *                  \f]
+ *                  is added to all coefficients. The wigner d-matrices are computed
+ *                  for the columns of the slab only.
+ *
+ *                  The sample is never modified and never copied as a whole, so the
+ *                  memory besides the coefficients is \f$\mathcal{O}(B^2 block)\f$.
+ *                  For a mapped sample the next slab is prefetched while the current
+ *                  one is transformed and the pages of a slab are released after it
+ *                  was copied, therefore the file is streamed sequentially instead of
+ *                  being loaded by random page faults. This allows transforms of
+ *                  samples that exceed the physical memory.
+ *
+ *                  The flip symmetries \f$\beta\mapsto\pi-\beta\f$ of the dense transform
+ *                  map layers into other slabs and are not used.
+ *
+ * @param[in]       sample A discrete sample of function \f$f\f$ which has the
+ *                  dimension of \f$2B\times 2B\times 2B\f$.
+ * @param[out]      fc A Fourier coefficent managment container with capacaty for
+ *                  all Fourier coefficients of \f$f\f$ up to its bandwidth, which
+ *                  must not exceed \f$B\f$.
+ * @param[in]       block The number of layers per slab
+ * @param[in]       threads The number of threads used for the analysis
+ *
+ * @sa              FourierTransforms::DSOFT
+ * @sa              FourierTransforms::IDSOFT_stream
+ * @sa              grid3D::prefetch_layers
+ *
+ * @ingroup         FourierTransforms
+ *
+ * @since           1.0.0
+ */
+void DSOFT_stream(const grid3D< complex< double > >& sample, DSOFTFourierCoefficients& fc, const int& block, int threads)
+{
+    dsoft_stream(sample, fc, block, nullptr, threads);
+}
+
+/*!
+ * @brief           The slab-wise DSOFT with a timing breakdown
+ * @details         Computes the same coefficients as FourierTransforms::DSOFT_stream
+ *                  and reports the wall time of the call. If the library is built
+ *                  with PFSOFT_STATS, the time of every stage and the busy time of
+ *                  every thread is reported as well. The stages and the loops are
+ *                  summed over all slabs, FFT includes reading the slabs.
+ *
+ * @param[in]       sample A discrete sample of function \f$f\f$
+ * @param[out]      fc The Fourier coefficients of \f$f\f$
+ * @param[in]       block The number of layers per slab
+ * @param[out]      stats The timing breakdown of the call
+ * @param[in]       threads The number of threads
+ *
+ * @sa              DSOFTStats
+ *
+ * @ingroup         FourierTransforms
+ *
+ * @since           1.0.0
+ */
+void DSOFT_stream(const grid3D< complex< double > >& sample, DSOFTFourierCoefficients& fc, const int& block, DSOFTStats& stats, int threads)
+{
+    stats.reset(static_cast< int >(sample.cols / 2), 1);
+    
+    const double start = DSOFTStatsTimer::now();
+    dsoft_stream(sample, fc, block, &stats, threads);
+    stats.total = DSOFTStatsTimer::now() - start;
+}
+
+PFSOFT_NAMESPACE_END
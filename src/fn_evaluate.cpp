@@ -0,0 +1,199 @@
+//
+//  fn_evaluate.cpp
+//  PFSOFTlib
+//
+//   Created by Denis-Michael Lux on 05. November 2015.
+//
+//   This file is part of PFSOFTlib.
+//
+//   PFSOFTlib is free software: you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License as published by
+//   the Free Software Foundation, either version 3 of the License, or
+//   (at your option) any later version.
+//
+//   PFSOFTlib is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with PFSOFTlib.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <pfsoft>
+
+PFSOFT_NAMESPACE(FourierTransforms)
+
+/*!
+ * @brief           Evaluates the SO(3) Fourier series of the given coefficients at
+ *                  arbitrary Euler angles
+ * @details         Computes the value that FourierTransforms::IDSOFT synthesizes,
+ *                  \f[
+ *                      f(\alpha,\beta,\gamma) = \sum\limits_{J\geq 0}\sum\limits^J_{M=-J}\sum\limits^J_{M'=-J}
+ *                          \hat{f}^J_{MM'}\tilde{D}^J_{MM'}(\alpha,\beta,\gamma)
+ *                  \f]
+ *                  at a single point that does not have to lie on the sampling grid.
+ *                  On the grid, \f$\alpha\f$ belongs to the column index \f$j_1\f$ and
+ *                  \f$\gamma\f$ to the row index \f$j_2\f$ of the synthesis. The
+ *                  wigner d-functions are computed by DWT::wigner_d_vector for the
+ *                  given \f$\beta\f$, therefore one evaluation costs
+ *                  \f$\mathcal{O}(B^3)\f$ instead of the \f$\mathcal{O}(B^4)\f$ of a
+ *                  full inverse transform.
+ *
+ * @param[in]       fc A Fourier coefficent managment container
+ * @param[in]       alpha The first Euler angle \f$\alpha\in[0,2\pi)\f$
+ * @param[in]       beta The second Euler angle \f$\beta\in[0,\pi]\f$
+ * @param[in]       gamma The third Euler angle \f$\gamma\in[0,2\pi)\f$
+ * @return          The value of the Fourier series at \f$(\alpha,\beta,\gamma)\f$
+ *
+ * @sa              DWT::wigner_d_vector
+ * @sa              FourierTransforms::IDSOFT
+ *
+ * @ingroup         FourierTransforms
+ *
+ * @since           1.0.0
+ */
+complex< double > evaluate(const DSOFTFourierCoefficients& fc, const double& alpha, const double& beta, const double& gamma)
+{
+    const int bandwidth = fc.bandwidth;
+    
+    long double re = 0, im = 0;
+    
+    for (int M = -(bandwidth - 1); M < bandwidth; ++M)
+    {
+        for (int Mp = -(bandwidth - 1); Mp < bandwidth; ++Mp)
+        {
+            const int minJ = std::max(abs(M), abs(Mp));
+            
+            vector< long double > d(bandwidth - minJ);
+            DWT::wigner_d_vector< long double >(d, bandwidth, M, Mp, beta);
+            
+            const long double sign = DWT::kernel_sign< long double >(M, Mp);
+            
+            // sum over all degrees for this order pair
+            long double sre = 0, sim = 0;
+            for (int l = minJ; l < bandwidth; ++l)
+            {
+                const complex< double >& c = fc(l, M, Mp);
+                sre += c.re * d[l - minJ];
+                sim += c.im * d[l - minJ];
+            }
+            
+            // multiply with exp(i(M alpha + M' gamma))
+            const long double phase = M * static_cast< long double >(alpha) + Mp * static_cast< long double >(gamma);
+            const long double cp    = cos(phase);
+            const long double sp    = sin(phase);
+            
+            re += sign * (sre * cp - sim * sp);
+            im += sign * (sre * sp + sim * cp);
+        }
+    }
+    
+    return complex< double >(static_cast< double >(re / (2 * constants< long double >::pi)), static_cast< double >(im / (2 * constants< long double >::pi)));
+}
+
+/*!
+ * @brief           Refines a maximum of the real part of an SO(3) Fourier series
+ *                  below the resolution of the sampling grid
+ * @details         Starting from a candidate, e.g. the largest grid value of an
+ *                  inverse transform, the angles are improved coordinate-wise by
+ *                  parabolic steps. For every angle the series is evaluated one step
+ *                  width to both sides, the vertex of the interpolating parabola is
+ *                  taken if the parabola is concave and improves the value, and the
+ *                  step width is halved after each iteration. The initial step widths
+ *                  are the grid spacings \f$\pi/B\f$ for \f$\alpha, \gamma\f$ and
+ *                  \f$\pi/(2B)\f$ for \f$\beta\f$. The value never decreases.
+ *
+ *                  Every iteration costs at most nine evaluations of
+ *                  FourierTransforms::evaluate, i.e. \f$\mathcal{O}(B^3)\f$.
+ *
+ * @param[in]       fc A Fourier coefficent managment container
+ * @param[in,out]   alpha The first Euler angle of the candidate and of the refined maximum
+ * @param[in,out]   beta The second Euler angle of the candidate and of the refined maximum
+ * @param[in,out]   gamma The third Euler angle of the candidate and of the refined maximum
+ * @param[in]       iterations The number of refinement iterations
+ * @return          The value of the Fourier series at the refined angles
+ *
+ * @sa              FourierTransforms::evaluate
+ *
+ * @ingroup         FourierTransforms
+ *
+ * @since           1.0.0
+ */
+complex< double > refine(const DSOFTFourierCoefficients& fc, double& alpha, double& beta, double& gamma, const int& iterations)
+{
+    const double pi = constants< double >::pi;
+    
+    double x[3] = { alpha, beta, gamma };
+    double h[3] = { pi / fc.bandwidth, pi / (2. * fc.bandwidth), pi / fc.bandwidth };
+    
+    complex< double > best = evaluate(fc, x[0], x[1], x[2]);
+    
+    for (int it = 0; it < iterations; ++it)
+    {
+        for (int a = 0; a < 3; ++a)
+        {
+            double xm[3] = { x[0], x[1], x[2] };
+            double xp[3] = { x[0], x[1], x[2] };
+            
+            xm[a] -= h[a];
+            xp[a] += h[a];
+            
+            // beta is restricted to [0, pi]
+            bool clamped = false;
+            if (a == 1 && (xm[1] < 0 || xp[1] > pi))
+            {
+                xm[1]   = std::max(0., xm[1]);
+                xp[1]   = std::min(pi, xp[1]);
+                clamped = true;
+            }
+            
+            complex< double > fm = evaluate(fc, xm[0], xm[1], xm[2]);
+            complex< double > fp = evaluate(fc, xp[0], xp[1], xp[2]);
+            
+            // vertex of the parabola through the three values, unless
+            // beta was clamped to the boundary
+            const double den = fm.re - 2 * best.re + fp.re;
+            if (den < 0 && !clamped)
+            {
+                const double delta = std::max(-h[a], std::min(h[a], 0.5 * h[a] * (fm.re - fp.re) / den));
+                
+                double xv[3] = { x[0], x[1], x[2] };
+                xv[a] += delta;
+                
+                complex< double > fv = evaluate(fc, xv[0], xv[1], xv[2]);
+                if (fv.re > best.re)
+                {
+                    x[a] = xv[a];
+                    best = fv;
+                    continue;
+                }
+            }
+            
+            // otherwise move to the better neighbour, if any
+            if (fm.re > best.re && fm.re >= fp.re)
+            {
+                x[a] = xm[a];
+                best = fm;
+            }
+            else if (fp.re > best.re)
+            {
+                x[a] = xp[a];
+                best = fp;
+            }
+        }
+        
+        h[0] *= 0.5;
+        h[1] *= 0.5;
+        h[2] *= 0.5;
+    }
+    
+    // wrap alpha and gamma to [0, 2pi)
+    alpha = x[0] - 2 * pi * floor(x[0] / (2 * pi));
+    beta  = x[1];
+    gamma = x[2] - 2 * pi * floor(x[2] / (2 * pi));
+    
+    return best;
+}
+
+PFSOFT_NAMESPACE_END
@@ -20,118 +20,173 @@
 //   along with PFSOFTlib.  If not, see <http://www.gnu.org/licenses/>.
 //
 
+#include <algorithm>
+
 #include <pfsoft>
 
 PFSOFT_NAMESPACE(FourierTransforms)
 
 /*!
- * @brief           The inverse DSOFT (<b>S0</b>(3) <b>F</b>ourier <b>T</b>ransform)
- *                  describes the inverse FFT on the rotation group \f$\mathcal{SO}(3)\f$
- * @details         The method to compute the inverse DSOFT on the rotation group is described
- *                  in detail in the paper 'FFTs on the Rotation Group' written by Peter J.
- *                  Kostelec and Daniel N. Rockmore. The implementation that is underneath
- *                  this function is
- *                  \f[
- *                      f(\alpha,\beta,\gamma) = \sum\limits_{J\geq 0}\sum\limits^J_{M=-J}\sum\limits^J_{M'=-J}
- *                          \hat{f}^J_{MM'}\tilde{D}^J_{MM'}(\alpha,\beta,\gamma)
- *                  \f]
- *                  where \f$\hat{f}^J_{MM'}\f$ is the Fourier coefficient of degree
- *                  \f$J\f$ and orders \f$M,\;M'\f$. For more detailed information about the
- *                  Fourier coefficients read the documentation of FourierTransforms::DSOFT.
- *                  The implementation itself uses the symmetry properties of the wigner
- *                  d-function to reduce the number of wigner d-function evaluations. The
- *                  symmetries that are used are
- *                  \f{eqnarray*}{
- *                      d^{J}_{MM'}(\beta) &=& (-1)^{M-M'}d^J_{-M-M'}(\beta)\\
- *                      &=& (-1)^{M-M'}d^J_{M'M}(\beta)\\
- *                      &=& d^J_{-M'-M}(\beta)\\
- *                      &=& (-1)^{J-M'}d^J_{-MM'}(\pi-\beta)\\
- *                      &=& (-1)^{J+M}d^J_{M-M'}(\pi-\beta)\\
- *                      &=& (-1)^{J-M'}d^J_{-M'M}(\pi-\beta)\\
- *                      &=& (-1)^{J+M}d^J_{M'-M}(\pi-\beta)
- *                  \f}
- *
- * @param[in]       fc A Fourier coefficent managment container with all Fourier coefficients
- *                  of the DSOFT.
- * @param[out]      synthesis The synthesized sample for the given Fourier coefficients.
- *
- * @sa              DWT::wigner_d_matrix
- * @sa              DSOFTFourierCoefficients
- * @sa              FourierTransforms::DSOFT
- * @sa              complex
- * @sa              matrix
- * @sa              grid3D
- *
- * @since           0.0.1
- *
- * @ingroup         FourierTransforms
- *
- * @author          Denis-Michael Lux <denis.lux@icloud.com>
- * @date            23.05.2015
+ * @brief           The synthesis of a \f$\beta\f$-line with a transposed wigner
+ *                  d-matrix of precision R
  */
-void IDSOFT(const DSOFTFourierCoefficients& fc, grid3D< complex< double > >& synthesis, int threads)
+template< typename R >
+static inline vector< complex< double > > dwt(matrix< R >& d, const vector< complex< double > >& sh)
+{
+    return convert< double >(d * convert< R >(sh));
+}
+
+/*!
+ * @brief           The synthesis of a \f$\beta\f$-line in double precision, which
+ *                  needs no conversion and multiplies with the dispatched kernel
+ */
+template< >
+inline vector< complex< double > > dwt(matrix< double >& d, const vector< complex< double > >& sh)
+{
+    return d * sh;
+}
+
+/*!
+ * @brief           Loads the coefficients of the orders (M, M') of the highest
+ *                  degrees of fc multiplied by norm
+ */
+static inline void gather(const DSOFTFourierCoefficients& fc, const double& norm, vector< complex< double > >& sh, const int& bandlimit, const int& M, const int& Mp)
+{
+    SIMD::gather(reinterpret_cast< const double* >(&fc(0, 0, 0)), sh.size, norm, reinterpret_cast< double* >(&sh[0]), bandlimit - static_cast< int >(sh.size), M, Mp);
+}
+
+/*!
+ * @brief           The batched IDSOFT with a DWT in precision R that records its
+ *                  timing breakdown to stats if stats is not nullptr
+ */
+template< typename R >
+static void idsoft(const DSOFTFourierCoefficients* const* fc, grid3D< complex< double > >* const* synthesis, const int& count, DSOFTStats* stats, int threads)
 {
     /*****************************************************************
      ** Check parameters                                            **
      *****************************************************************/
+    // Check if there is anything to transform
+    pfsoft_cond_w_ret(count < 1, "%s", "IDSOFT batch does not contain any Fourier coefficients container.");
+    
     // Check if the grid has same size in each dimension
-    pfsoft_cond_w_ret(synthesis.rows != synthesis.cols || synthesis.rows != synthesis.lays, "%s", "all IDSOFT synthesis grid dimensions should be equal.");
+    pfsoft_cond_w_ret(synthesis[0]->rows != synthesis[0]->cols || synthesis[0]->rows != synthesis[0]->lays, "%s", "all IDSOFT synthesis grid dimensions should be equal.");
     
     // Check if grid has odd dimensions
-    pfsoft_cond_w_ret(synthesis.rows & 1, "%s", "IDSOFT synthesis grid dimensions are not even.");
+    pfsoft_cond_w_ret(synthesis[0]->rows & 1, "%s", "IDSOFT synthesis grid dimensions are not even.");
     
     // Extract bandwidth
-    int bandwidth = static_cast< int >(synthesis.cols / 2);
+    int bandwidth = static_cast< int >(synthesis[0]->cols / 2);
     
     // precompute the double bandwidth
     const int bw2 = 2 * bandwidth;
     
     // Check if Fourier coefficients container dimension matches sample dimension
-    pfsoft_cond_w_ret(bandwidth != fc.bandwidth, "%s", "IDSOFT Fourier coefficients container bandwidth does not match to synthesis grid bandwidth.");
+    int n;
+    for (n = 0; n < count; ++n)
+    {
+        pfsoft_cond_w_ret(synthesis[n]->rows != synthesis[0]->rows || synthesis[n]->cols != synthesis[0]->cols || synthesis[n]->lays != synthesis[0]->lays, "%s", "all IDSOFT synthesis grids of a batch should have the same dimensions.");
+        pfsoft_cond_w_ret(fc[0]->bandwidth != fc[n]->bandwidth, "%s", "all IDSOFT Fourier coefficients containers of a batch should have the same bandwidth.");
+    }
+    
+    // Check if Fourier coefficients container bandwidth fits to the sample grid
+    pfsoft_cond_w_ret(fc[0]->bandwidth > bandwidth || fc[0]->bandwidth < 1, "%s", "IDSOFT Fourier coefficients container bandwidth exceeds the synthesis grid bandwidth.");
+    
+    // Effective bandlimit of the coefficients. Degrees l >= bandlimit are
+    // treated as zero, so only (M, M') with max(|M|, |M'|) < bandlimit are
+    // synthesized.
+    const int bandlimit = fc[0]->bandwidth;
+    
+    // strided views can not be transformed in place, each of them is
+    // synthesized on its own by the streaming synthesis
+    bool dense = true;
+    for (n = 0; n < count; ++n)
+    {
+        dense = dense && synthesis[n]->contiguous();
+    }
+    
+    if (!dense)
+    {
+        for (n = 0; n < count; ++n)
+        {
+            IDSOFT(*fc[n], *synthesis[n], threads);
+        }
+        
+        return;
+    }
     
     // print warinings for serial implementation
     #ifndef _OPENMP
     pfsoft_cond_w(threads != 1, "%s", "compiler does not support OpenMP. Changing the number of threads for the IDSOFT has no effect.");
     #endif
     
+    // number of threads from the tuning profile and whether the
+    // (M, M') loops run in parallel for this bandwidth
+    threads             = DSOFT_threads(bandwidth, threads);
+    const bool parallel = threads > 1 && bandwidth >= DSOFT_threshold();
+    
+    if (stats != nullptr)
+    {
+        stats->reset(bandwidth, parallel ? threads : 1);
+    }
+    
+    // lap timer of the stages that run on the calling thread
+    pfsoft_stats_timer(lap, stats);
+    
     /*****************************************************************
      ** M = 0, M' = 0                                               **
      *****************************************************************/
-    matrix< long double > d(bandwidth, 2 * bandwidth);
-    DWT::wigner_d_matrix< long double >(d, bandwidth, 0, 0);
+    // All orders that are not synthesized are zero for a truncated bandlimit
+    if (bandlimit < bandwidth)
+    {
+        for (n = 0; n < count; ++n)
+        {
+            std::fill(access::rwp(synthesis[n]->mem), access::rwp(synthesis[n]->mem) + bw2 * bw2 * bw2, complex< double >(0, 0));
+        }
+    }
+    
+    matrix< R > d(bandlimit, 2 * bandwidth);
+    DWT::wigner_d_matrix< R >(d, bandwidth, 0, 0);
     
     d *= -1;
-    d.transpose();
+    d.transpose(); pfsoft_stats_lap(lap, WIGNER);
     
     vector< complex< double > > sh(d.cols, vector< complex< double > >::COLUMN);
+    vector< complex< double > > s;
     
-    // defining norm factor
-    complex< double > norm((bandwidth * bw2) / constants< double >::pi, 0);
+    // defining norm factor. The scaling of the IFFT2 is folded into it, so
+    // that the synthesis grids do not have to be scaled afterwards.
+    const double norm = (bandwidth * bw2) / constants< double >::pi / (4. * bandwidth * bandwidth);
     
     // defining needed indices
     int MMp, M, Mp;
     vector< complex< double > >::iterator e;
-    matrix< long double >::lin_iterator m;
+    typename matrix< R >::lin_iterator m;
     
     // inverse DWT for M = 0, M' = 0
-    for (e = sh.begin(); e != sh.end(); ++e) { *e = norm * fc(bandwidth-(sh.end()-e), 0, 0);                }
-    vector< complex< double > > s = convert<double>(d * convert<long double>(sh));
-    for (e = s.begin() ; e != s.end() ; ++e) { synthesis(0, 0, e - s.begin()) = *e;                         }
+    for (n = 0; n < count; ++n)
+    {
+        gather(*fc[n], norm, sh, bandlimit, 0, 0);                                                               pfsoft_stats_lap(lap, SCATTER);
+        s = dwt(d, sh);                                                                                          pfsoft_stats_lap(lap, DWT);
+        for (e = s.begin() ; e != s.end() ; ++e) { (*synthesis[n])(0, 0, e - s.begin()) = *e;                  } pfsoft_stats_lap(lap, SCATTER);
+    }
     
     /*****************************************************************
      ** Iterate over all combinations of M and M'                   **
      *****************************************************************/
-    #pragma omp parallel default(shared) if(bandwidth >= DSOFT_THRESHOLD) num_threads(threads)
+    #pragma omp parallel default(shared) if(parallel) num_threads(threads)
     {
+        pfsoft_stats_timer(lap, stats);
         
-        #pragma omp for private(M, d, s, sh, e) schedule(dynamic) nowait
-        for (M = 1; M < bandwidth; ++M)
+        #pragma omp for private(M, n, d, s, sh, e) schedule(dynamic) nowait
+        for (M = 1; M < bandlimit; ++M)
         {
-            d  = matrix< long double >(bandwidth - M, 2 * bandwidth);
-            DWT::wigner_d_matrix< long double >(d, bandwidth, M, 0);
+            pfsoft_stats_group(lap, M, 0);
+            
+            d  = matrix< R >(bandlimit - M, 2 * bandwidth);
+            DWT::wigner_d_matrix< R >(d, bandwidth, M, 0);
             
             d *= -1;
-            d.transpose();
+            d.transpose(); pfsoft_stats_lap(lap, WIGNER);
             
             sh = vector< complex< double > >(d.cols, vector< complex< double > >::COLUMN);
             
@@ -139,154 +194,617 @@ void IDSOFT(const DSOFTFourierCoefficients& fc, grid3D< complex< double > >& syn
              ** Make use of symmetries                                      **
              *****************************************************************/
             // case f_{M,0}
-            for (e = sh.begin(); e != sh.end(); ++e) { *e = norm * fc(bandwidth - (sh.end() - e), M, 0);    }
-            s = convert<double>(d * convert<long double>(sh));
-            for (e = s.begin() ; e != s.end() ; ++e) { synthesis(0, M, e - s.begin()) = *e;                 }
+            for (n = 0; n < count; ++n)
+            {
+                gather(*fc[n], norm, sh, bandlimit, M, 0);                                                           pfsoft_stats_lap(lap, SCATTER);
+                s = dwt(d, sh);                                                                                      pfsoft_stats_lap(lap, DWT);
+                for (e = s.begin() ; e != s.end() ; ++e) { (*synthesis[n])(0, M, e - s.begin()) = *e;          }     pfsoft_stats_lap(lap, SCATTER);
+            }
             
             // case f_{0,M}
-            for (e = sh.begin(); e != sh.end(); ++e) { *e = norm * fc(bandwidth - (sh.end() - e), 0, M);    }
-            if  (M & 1) { s = convert<double>(d * convert<long double>(sh * -1)); } else  { s = convert<double>(d * convert<long double>(sh));   }
-            for (e = s.begin() ; e != s.end() ; ++e) { synthesis(M, 0, e - s.begin()) = *e;                 }
+            for (n = 0; n < count; ++n)
+            {
+                gather(*fc[n], norm, sh, bandlimit, 0, M);                                                                                             pfsoft_stats_lap(lap, SCATTER);
+                if  (M & 1) { s = dwt(d, sh * -1); } else { s = dwt(d, sh); }                                                                          pfsoft_stats_lap(lap, DWT);
+                for (e = s.begin() ; e != s.end() ; ++e) { (*synthesis[n])(M, 0, e - s.begin()) = *e;          }                                       pfsoft_stats_lap(lap, SCATTER);
+            }
             
-            flipud(d);
+            flipud(d); pfsoft_stats_lap(lap, WIGNER);
             
             // case f_{-M,0}
-            for (e = sh.begin(); e != sh.end(); ++e) { *e = norm * fc(bandwidth - (sh.end() - e), -M, 0);   }
-            if (M & 1)
+            for (n = 0; n < count; ++n)
             {
-                for (e = sh.begin(); e < sh.end(); e+=2)     { *e *= -1;                                    }
+                gather(*fc[n], norm, sh, bandlimit, -M, 0);                                                           pfsoft_stats_lap(lap, SCATTER);
+                if (M & 1)
+                {
+                    for (e = sh.begin(); e < sh.end(); e+=2)     { *e *= -1;                                   }
+                }
+                else
+                {
+                    for (e = sh.begin() + 1; e < sh.end(); e+=2) { *e *= -1;                                   }
+                }                                                                                                pfsoft_stats_lap(lap, SCATTER);
+                s = dwt(d, sh);                                                                                  pfsoft_stats_lap(lap, DWT);
+                for (e = s.begin() ; e != s.end() ; ++e)  { (*synthesis[n])(0, bw2 - M, e - s.begin()) = *e;   } pfsoft_stats_lap(lap, SCATTER);
             }
-            else
-            {
-                for (e = sh.begin() + 1; e < sh.end(); e+=2) { *e *= -1;                                    }
-            }
-            s = convert<double>(d * convert<long double>(sh));
-            for (e = s.begin() ; e != s.end() ; ++e)  { synthesis(0, bw2 - M, e - s.begin()) = *e;          }
             
             // case f_{0,-M}
-            for (e = sh.begin(); e != sh.end(); ++e)  { *e = norm * fc(bandwidth - (sh.end() - e), 0, -M);  }
-            for (e = sh.begin()+1; e < sh.end(); e+=2){ *e *= -1;                                           }
-            s = convert<double>(d * convert<long double>(sh));
-            for (e = s.begin() ; e != s.end() ; ++e)  { synthesis(bw2 - M, 0, e - s.begin()) = *e;          }
+            for (n = 0; n < count; ++n)
+            {
+                gather(*fc[n], norm, sh, bandlimit, 0, -M);                                                           pfsoft_stats_lap(lap, SCATTER);
+                for (e = sh.begin()+1; e < sh.end(); e+=2){ *e *= -1;                                          } pfsoft_stats_lap(lap, SCATTER);
+                s = dwt(d, sh);                                                                                  pfsoft_stats_lap(lap, DWT);
+                for (e = s.begin() ; e != s.end() ; ++e)  { (*synthesis[n])(bw2 - M, 0, e - s.begin()) = *e;   } pfsoft_stats_lap(lap, SCATTER);
+            }
             
             // get new wigner matrix
-            d  = matrix< long double >(bandwidth - M, 2 * bandwidth);
-            DWT::wigner_d_matrix< long double >(d, bandwidth, M, M);
+            d  = matrix< R >(bandlimit - M, 2 * bandwidth);
+            DWT::wigner_d_matrix< R >(d, bandwidth, M, M);
             
             d *= -1;
-            d.transpose();
+            d.transpose(); pfsoft_stats_lap(lap, WIGNER);
             
             // case f_{M,M}
-            for (e = sh.begin(); e != sh.end(); ++e) { *e = norm * fc(bandwidth - (sh.end() - e), M, M);    }
-            s = convert<double>(d * convert<long double>(sh));
-            for (e = s.begin() ; e != s.end() ; ++e) { synthesis(M, M, e - s.begin()) = *e;                 }
+            for (n = 0; n < count; ++n)
+            {
+                gather(*fc[n], norm, sh, bandlimit, M, M);                                                           pfsoft_stats_lap(lap, SCATTER);
+                s = dwt(d, sh);                                                                                      pfsoft_stats_lap(lap, DWT);
+                for (e = s.begin() ; e != s.end() ; ++e) { (*synthesis[n])(M, M, e - s.begin()) = *e;          }     pfsoft_stats_lap(lap, SCATTER);
+            }
             
             // case f_{-M,-M}
-            for (e = sh.begin(); e != sh.end(); ++e) { *e = norm * fc(bandwidth - (sh.end() - e), -M, -M);  }
-            s = convert<double>(d * convert<long double>(sh));
-            for (e = s.begin() ; e != s.end() ; ++e) { synthesis(bw2 - M, bw2 - M, e - s.begin()) = *e;     }
+            for (n = 0; n < count; ++n)
+            {
+                gather(*fc[n], norm, sh, bandlimit, -M, -M);                                                           pfsoft_stats_lap(lap, SCATTER);
+                s = dwt(d, sh);                                                                                        pfsoft_stats_lap(lap, DWT);
+                for (e = s.begin() ; e != s.end() ; ++e) { (*synthesis[n])(bw2 - M, bw2 - M, e - s.begin()) = *e; }    pfsoft_stats_lap(lap, SCATTER);
+            }
             
             // Modify dw for the last two cases. flip matrix from left to right and negate every
             // second row with odd row indices.
-            flipud_ne2ndocol(d);
+            flipud_ne2ndocol(d); pfsoft_stats_lap(lap, WIGNER);
             
             // An little arithmetic error is occuring in the following calculation... I do not exactly know why...
             // case f_{M,-M}
-            for (e = sh.begin(); e != sh.end(); ++e) { *e = norm * fc(bandwidth - (sh.end() - e), M, -M);   }
-            s = convert<double>(d * convert<long double>(sh));
-            for (e = s.begin() ; e != s.end() ; ++e) { synthesis(bw2 - M, M, e - s.begin()) = *e;           }
+            for (n = 0; n < count; ++n)
+            {
+                gather(*fc[n], norm, sh, bandlimit, M, -M);                                                           pfsoft_stats_lap(lap, SCATTER);
+                s = dwt(d, sh);                                                                                       pfsoft_stats_lap(lap, DWT);
+                for (e = s.begin() ; e != s.end() ; ++e) { (*synthesis[n])(bw2 - M, M, e - s.begin()) = *e;    }      pfsoft_stats_lap(lap, SCATTER);
+            }
             
             // case f_{-M,M}
-            for (e = sh.begin(); e != sh.end(); ++e) { *e = norm * fc(bandwidth - (sh.end() - e), -M, M);   }
-            s = convert<double>(d * convert<long double>(sh));
-            for (e = s.begin() ; e != s.end() ; ++e) { synthesis(M, bw2 - M, e - s.begin()) = *e;           }
+            for (n = 0; n < count; ++n)
+            {
+                gather(*fc[n], norm, sh, bandlimit, -M, M);                                                           pfsoft_stats_lap(lap, SCATTER);
+                s = dwt(d, sh);                                                                                       pfsoft_stats_lap(lap, DWT);
+                for (e = s.begin() ; e != s.end() ; ++e) { (*synthesis[n])(M, bw2 - M, e - s.begin()) = *e;    }      pfsoft_stats_lap(lap, SCATTER);
+            }
         }
         
         // Fused two loops per hand
         //
-        // for (M = 1; M < bandwidth; ++M)
+        // for (M = 1; M < bandlimit; ++M)
         //     for (Mp = 1; Mp < M; ++Mp)
         //
         // which now is equivalent to the following loop
-        #pragma omp for private(MMp, M, Mp, d, s, sh, e) schedule(dynamic) nowait
-        for (MMp = 0; MMp < (bandwidth - 2) * (bandwidth - 1) / 2; ++MMp)
+        #pragma omp for private(MMp, M, Mp, n, d, s, sh, e) schedule(dynamic) nowait
+        for (MMp = 0; MMp < (bandlimit - 2) * (bandlimit - 1) / 2; ++MMp)
         {
             // reconstructing indices of the two nested for loops
-            int i = MMp / (bandwidth - 1) + 1;
-            int j = MMp % (bandwidth - 1) + 1;
+            int i = MMp / (bandlimit - 1) + 1;
+            int j = MMp % (bandlimit - 1) + 1;
             
             // get M and M'
-            M  = j > i ? bandwidth - i : i + 1;
-            Mp = j > i ? bandwidth - j : j    ;
+            M  = j > i ? bandlimit - i : i + 1;
+            Mp = j > i ? bandlimit - j : j    ;
+            
+            pfsoft_stats_group(lap, M, Mp);
             
             // get new wigner d-matrix
-            d  = matrix< long double >(bandwidth - std::max(abs(M), abs(Mp)), 2 * bandwidth);
-            DWT::wigner_d_matrix< long double >(d, bandwidth, M, Mp);
-            d.transpose();
+            d  = matrix< R >(bandlimit - std::max(abs(M), abs(Mp)), 2 * bandwidth);
+            DWT::wigner_d_matrix< R >(d, bandwidth, M, Mp);
+            d.transpose(); pfsoft_stats_lap(lap, WIGNER);
             
             sh = vector< complex< double > >(d.cols, vector< complex< double > >::COLUMN);
             
             // case f_{M,Mp}
-            for (e = sh.begin(); e != sh.end(); ++e) { *e = norm * fc(bandwidth - (sh.end() - e), M, Mp);   }
-            sh *= -1;
-            s  = convert<double>(d * convert<long double>(sh));
-            for (e = s.begin() ; e != s.end() ; ++e) { synthesis(Mp, M, e - s.begin()) = *e;                }
+            for (n = 0; n < count; ++n)
+            {
+                gather(*fc[n], norm, sh, bandlimit, M, Mp);                                                           pfsoft_stats_lap(lap, SCATTER);
+                sh *= -1;
+                s  = dwt(d, sh);                                                                                 pfsoft_stats_lap(lap, DWT);
+                for (e = s.begin() ; e != s.end() ; ++e) { (*synthesis[n])(Mp, M, e - s.begin()) = *e;         } pfsoft_stats_lap(lap, SCATTER);
+            }
             
             // case f_{Mp,M}
-            for (e = sh.begin(); e != sh.end(); ++e) { *e = norm * fc(bandwidth - (sh.end() - e), Mp, M);   }
-            if  (!((M - Mp) & 1))                    { sh *= -1;                                            }
-            s = convert<double>(d * convert<long double>(sh));
-            for (e = s.begin() ; e != s.end() ; ++e) { synthesis(M, Mp, e - s.begin()) = *e;                }
+            for (n = 0; n < count; ++n)
+            {
+                gather(*fc[n], norm, sh, bandlimit, Mp, M);                                                           pfsoft_stats_lap(lap, SCATTER);
+                if  (!((M - Mp) & 1))                    { sh *= -1;                                           }
+                s = dwt(d, sh);                                                                                  pfsoft_stats_lap(lap, DWT);
+                for (e = s.begin() ; e != s.end() ; ++e) { (*synthesis[n])(M, Mp, e - s.begin()) = *e;         } pfsoft_stats_lap(lap, SCATTER);
+            }
             
             // case f_{-M,-Mp}
-            for (e = sh.begin(); e != sh.end(); ++e) { *e = norm * fc(bandwidth - (sh.end() - e), -M, -Mp); }
-            if  (!((M - Mp) & 1))                    { sh *= -1;                                            }
-            s = convert<double>(d * convert<long double>(sh));
-            for (e = s.begin() ; e != s.end() ; ++e) { synthesis(bw2 - Mp, bw2 - M, e - s.begin()) = *e;    }
+            for (n = 0; n < count; ++n)
+            {
+                gather(*fc[n], norm, sh, bandlimit, -M, -Mp);                                                           pfsoft_stats_lap(lap, SCATTER);
+                if  (!((M - Mp) & 1))                    { sh *= -1;                                           }
+                s = dwt(d, sh);                                                                                      pfsoft_stats_lap(lap, DWT);
+                for (e = s.begin() ; e != s.end() ; ++e) { (*synthesis[n])(bw2 - Mp, bw2 - M, e - s.begin()) = *e; } pfsoft_stats_lap(lap, SCATTER);
+            }
             
             // case f_{-Mp,-M}
-            for (e = sh.begin(); e != sh.end(); ++e) { *e = norm * fc(bandwidth - (sh.end() - e), -Mp, -M); }
-            sh *= -1;
-            s  = convert<double>(d * convert<long double>(sh));
-            for (e = s.begin() ; e != s.end() ; ++e) { synthesis(bw2 - M, bw2 - Mp, e - s.begin()) = *e;    }
+            for (n = 0; n < count; ++n)
+            {
+                gather(*fc[n], norm, sh, bandlimit, -Mp, -M);                                                           pfsoft_stats_lap(lap, SCATTER);
+                sh *= -1;
+                s  = dwt(d, sh);                                                                                     pfsoft_stats_lap(lap, DWT);
+                for (e = s.begin() ; e != s.end() ; ++e) { (*synthesis[n])(bw2 - M, bw2 - Mp, e - s.begin()) = *e; } pfsoft_stats_lap(lap, SCATTER);
+            }
             
             // modify wigner d-matrix for next four cases. This just works because the weight
             // function is also symmetric like the wigner-d matrix. flip up-dow the d
             // matrix and negate every second column with even row index.
-            flipud_ne2ndecol(d);
+            flipud_ne2ndecol(d); pfsoft_stats_lap(lap, WIGNER);
             
             // case f_{Mp,-M}
-            for (e = sh.begin(); e != sh.end(); ++e) { *e = norm * fc(bandwidth - (sh.end() - e), Mp, -M);  }
-            s = convert<double>(d * convert<long double>(sh));
-            for (e = s.begin() ; e != s.end() ; ++e) { synthesis(bw2 - M, Mp, e - s.begin()) = *e;          }
+            for (n = 0; n < count; ++n)
+            {
+                gather(*fc[n], norm, sh, bandlimit, Mp, -M);                                                           pfsoft_stats_lap(lap, SCATTER);
+                s = dwt(d, sh);                                                                                        pfsoft_stats_lap(lap, DWT);
+                for (e = s.begin() ; e != s.end() ; ++e) { (*synthesis[n])(bw2 - M, Mp, e - s.begin()) = *e;   }       pfsoft_stats_lap(lap, SCATTER);
+            }
             
             // case f_{M,-Mp}
-            for (e = sh.begin(); e != sh.end(); ++e) { *e = norm * fc(bandwidth - (sh.end() - e), M, -Mp);  }
-            s = convert<double>(d * convert<long double>(sh));
-            for (e = s.begin() ; e != s.end() ; ++e) { synthesis(bw2 - Mp, M, e - s.begin()) = *e;          }
+            for (n = 0; n < count; ++n)
+            {
+                gather(*fc[n], norm, sh, bandlimit, M, -Mp);                                                           pfsoft_stats_lap(lap, SCATTER);
+                s = dwt(d, sh);                                                                                        pfsoft_stats_lap(lap, DWT);
+                for (e = s.begin() ; e != s.end() ; ++e) { (*synthesis[n])(bw2 - Mp, M, e - s.begin()) = *e;   }       pfsoft_stats_lap(lap, SCATTER);
+            }
             
             // alter signs
             if ((M - Mp) & 1)
             {
-                for (m = d.begin(); m != d.end(); ++m) { access::rw(*m) *= -1;                              }
+                for (m = d.begin(); m != d.end(); ++m) { access::rw(*m) *= -1;                              } pfsoft_stats_lap(lap, WIGNER);
             }
             
             // case f_{-Mp,M}
-            for (e = sh.begin(); e != sh.end(); ++e) { *e = norm * fc(bandwidth - (sh.end() - e), -Mp, M);  }
-            s = convert<double>(d * convert<long double>(sh));
-            for (e = s.begin() ; e != s.end() ; ++e) { synthesis(M, bw2 - Mp, e - s.begin()) = *e;          }
+            for (n = 0; n < count; ++n)
+            {
+                gather(*fc[n], norm, sh, bandlimit, -Mp, M);                                                           pfsoft_stats_lap(lap, SCATTER);
+                s = dwt(d, sh);                                                                                        pfsoft_stats_lap(lap, DWT);
+                for (e = s.begin() ; e != s.end() ; ++e) { (*synthesis[n])(M, bw2 - Mp, e - s.begin()) = *e;   }       pfsoft_stats_lap(lap, SCATTER);
+            }
             
             // case f_{-M,Mp}
-            for (e = sh.begin(); e != sh.end(); ++e) { *e = norm * fc(bandwidth - (sh.end() - e), -M, Mp);  }
-            s = convert<double>(d * convert<long double>(sh));
-            for (e = s.begin() ; e != s.end() ; ++e) { synthesis(Mp, bw2 - M, e - s.begin()) = *e;          }
+            for (n = 0; n < count; ++n)
+            {
+                gather(*fc[n], norm, sh, bandlimit, -M, Mp);                                                           pfsoft_stats_lap(lap, SCATTER);
+                s = dwt(d, sh);                                                                                        pfsoft_stats_lap(lap, DWT);
+                for (e = s.begin() ; e != s.end() ; ++e) { (*synthesis[n])(Mp, bw2 - M, e - s.begin()) = *e;   }       pfsoft_stats_lap(lap, SCATTER);
+            }
         }
+        
+        pfsoft_stats_merge(lap, true);
     }
     
+    pfsoft_stats_loops(lap);
+    
     /*****************************************************************
      ** IFFT2 transform layers of input sample grid for fixed k     **
      *****************************************************************/
-    synthesis.layer_wise_IDFT2(complex< double > (1. / (4. * bandwidth * bandwidth), 0), threads);
+    uzl_fftw_layer_context ctx;
+    uzl_fftw_layer_context_create(&ctx, bw2, bw2, bw2, reinterpret_cast< double* >(access::rwp(synthesis[0]->mem)), +1);
+    
+    for (n = 0; n < count; ++n)
+    {
+        // The Nyquist row and column of every layer do not belong to any
+        // order. Clear them, since the grid may hold a previous synthesis.
+        for (int k = 0; k < bw2; ++k)
+        {
+            for (int j = 0; j < bw2; ++j)
+            {
+                (*synthesis[n])(bandwidth, j, k) = complex< double >(0, 0);
+                (*synthesis[n])(j, bandwidth, k) = complex< double >(0, 0);
+            }
+        }
+        
+        uzl_fftw_layer_context_execute(&ctx, reinterpret_cast< double* >(access::rwp(synthesis[n]->mem)), threads);
+    }
+    
+    uzl_fftw_layer_context_destroy(&ctx);
+    
+    pfsoft_stats_lap(lap, FFT);
+    pfsoft_stats_merge(lap, false);
+}
+
+/*!
+ * @brief           The batched IDSOFT that records its timing breakdown to stats
+ *                  if stats is not nullptr, with a DWT in the precision that
+ *                  FourierTransforms::DSOFT_double_dwt selects for the bandwidth
+ */
+static void idsoft(const DSOFTFourierCoefficients* const* fc, grid3D< complex< double > >* const* synthesis, const int& count, DSOFTStats* stats, int threads)
+{
+    if (count > 0 && DSOFT_double_dwt(static_cast< int >(synthesis[0]->cols / 2))) { idsoft< double >     (fc, synthesis, count, stats, threads); }
+    else                                                                            { idsoft< long double >(fc, synthesis, count, stats, threads); }
+}
+
+/*!
+ * @brief           The IDSOFT of a mapped grid or a strided view, which is written
+ *                  slab by slab by the streaming synthesis and records its timing
+ *                  breakdown to stats if stats is not nullptr
+ */
+static void idsoft_streamed(const DSOFTFourierCoefficients& fc, grid3D< complex< double > >& synthesis, DSOFTStats* stats, int threads)
+{
+    pfsoft_cond_w_ret(synthesis.rows != synthesis.cols || synthesis.rows != synthesis.lays || synthesis.rows & 1, "%s", "IDSOFT synthesis grid dimensions should be equal and even.");
+    
+    if (synthesis.rows != synthesis.cols || synthesis.rows != synthesis.lays || synthesis.rows & 1)
+    {
+        return;
+    }
+    
+    const int bandwidth = static_cast< int >(synthesis.cols / 2);
+    const int block     = DSOFT_slab_layers(bandwidth);
+    
+    IDSOFTLayerCallback write = [&synthesis](const grid3D< complex< double > >& layers, const int& first)
+    {
+        synthesis.assign_layers(layers.mem, first, layers.lays);
+        synthesis.release_layers(first, layers.lays);
+    };
+    
+    if (stats != nullptr) { IDSOFT_stream(fc, bandwidth, write, block, *stats, threads); }
+    else                  { IDSOFT_stream(fc, bandwidth, write, block, threads);         }
+}
+
+/*!
+ * @brief           The inverse DSOFT (<b>S0</b>(3) <b>F</b>ourier <b>T</b>ransform)
+ *                  describes the inverse FFT on the rotation group \f$\mathcal{SO}(3)\f$
+ * @details         The method to compute the inverse DSOFT on the rotation group is described
+ *                  in detail in the paper 'FFTs on the Rotation Group' written by Peter J.
+ *                  Kostelec and Daniel N. Rockmore. The implementation that is underneath
+ *                  this function is
+ *                  \f[
+ *                      f(\alpha,\beta,\gamma) = \sum\limits_{J\geq 0}\sum\limits^J_{M=-J}\sum\limits^J_{M'=-J}
+ *                          \hat{f}^J_{MM'}\tilde{D}^J_{MM'}(\alpha,\beta,\gamma)
+ *                  \f]
+ *                  where \f$\hat{f}^J_{MM'}\f$ is the Fourier coefficient of degree
+ *                  \f$J\f$ and orders \f$M,\;M'\f$. For more detailed information about the
+ *                  Fourier coefficients read the documentation of FourierTransforms::DSOFT.
+ *                  The implementation itself uses the symmetry properties of the wigner
+ *                  d-function to reduce the number of wigner d-function evaluations. The
+ *                  symmetries that are used are
+ *                  \f{eqnarray*}{
+ *                      d^{J}_{MM'}(\beta) &=& (-1)^{M-M'}d^J_{-M-M'}(\beta)\\
+ *                      &=& (-1)^{M-M'}d^J_{M'M}(\beta)\\
+ *                      &=& d^J_{-M'-M}(\beta)\\
+ *                      &=& (-1)^{J-M'}d^J_{-MM'}(\pi-\beta)\\
+ *                      &=& (-1)^{J+M}d^J_{M-M'}(\pi-\beta)\\
+ *                      &=& (-1)^{J-M'}d^J_{-M'M}(\pi-\beta)\\
+ *                      &=& (-1)^{J+M}d^J_{M'-M}(\pi-\beta)
+ *                  \f}
+ *
+ *                  The bandwidth \f$L\f$ of the coefficients container may be smaller
+ *                  than the bandwidth \f$B\f$ of the synthesis grid. Then only the orders
+ *                  with \f$\max(|M|,|M'|) < L\f$ are synthesized with \f$(L - \max(|M|,|M'|))\f$-row
+ *                  wigner d-matrices and the result is bit-identical to zero-padding
+ *                  the coefficients up to \f$B\f$. This up-samples a function of
+ *                  bandwidth \f$L\f$ to the finer grid at about \f$(L/B)^2\f$ of the
+ *                  DWT costs.
+ *
+ *                  A synthesis grid that is stored in a memory-mapped file or that
+ *                  views external memory with other than the dense strides is written
+ *                  by FourierTransforms::IDSOFT_stream in slabs of
+ *                  FourierTransforms::DSOFT_slab_layers layers. Dense views are
+ *                  synthesized in place.
+ *
+ *                  Like for FourierTransforms::DSOFT the DWT runs in double
+ *                  precision if FourierTransforms::DSOFT_double_dwt says so.
+ *
+ * @param[in]       fc A Fourier coefficent managment container with all Fourier coefficients
+ *                  of the DSOFT. Its bandwidth must not exceed half the grid dimension.
+ * @param[out]      synthesis The synthesized sample for the given Fourier coefficients.
+ *
+ * @sa              DWT::wigner_d_matrix
+ * @sa              DSOFTFourierCoefficients
+ * @sa              FourierTransforms::DSOFT
+ * @sa              complex
+ * @sa              matrix
+ * @sa              grid3D
+ *
+ * @since           0.0.1
+ *
+ * @ingroup         FourierTransforms
+ *
+ * @author          Denis-Michael Lux <denis.lux@icloud.com>
+ * @date            23.05.2015
+ */
+void IDSOFT(const DSOFTFourierCoefficients& fc, grid3D< complex< double > >& synthesis, int threads)
+{
+    // Mapped grids may exceed the memory and strided views can not be
+    // transformed in place. They are written slab by slab by the streaming
+    // synthesis.
+    if (synthesis.storage == grid3D< complex< double > >::MAPPED || !synthesis.contiguous())
+    {
+        idsoft_streamed(fc, synthesis, nullptr, threads);
+        return;
+    }
+    
+    const DSOFTFourierCoefficients* fcp = &fc;
+    grid3D< complex< double > >*    syp = &synthesis;
+    
+    idsoft(&fcp, &syp, 1, nullptr, threads);
+}
+
+/*!
+ * @brief           The IDSOFT with a timing breakdown
+ * @details         Computes the same synthesis as FourierTransforms::IDSOFT and
+ *                  reports the wall time of the call. If the library is built with
+ *                  PFSOFT_STATS, the time of every stage and the busy time of every
+ *                  thread is reported as well. Mapped grids and strided views are
+ *                  synthesized slab by slab, their stages are the ones of
+ *                  FourierTransforms::IDSOFT_stream.
+ *
+ * @param[in]       fc The Fourier coefficients of \f$f\f$
+ * @param[out]      synthesis The synthesis grid of \f$f\f$
+ * @param[out]      stats The timing breakdown of the call
+ * @param[in]       threads The number of threads
+ *
+ * @sa              DSOFTStats
+ *
+ * @ingroup         FourierTransforms
+ *
+ * @since           1.0.0
+ */
+void IDSOFT(const DSOFTFourierCoefficients& fc, grid3D< complex< double > >& synthesis, DSOFTStats& stats, int threads)
+{
+    stats.reset(static_cast< int >(synthesis.cols / 2), 1);
+    
+    const double start = DSOFTStatsTimer::now();
+    
+    if (synthesis.storage == grid3D< complex< double > >::MAPPED || !synthesis.contiguous())
+    {
+        idsoft_streamed(fc, synthesis, &stats, threads);
+    }
+    else
+    {
+        const DSOFTFourierCoefficients* fcp = &fc;
+        grid3D< complex< double > >*    syp = &synthesis;
+        
+        idsoft(&fcp, &syp, 1, &stats, threads);
+    }
+    
+    stats.total = DSOFTStatsTimer::now() - start;
+}
+
+/*!
+ * @brief           The batched inverse DSOFT for several coefficient containers of
+ *                  the same bandwidth
+ * @details         Synthesizes all given Fourier coefficient containers at once.
+ *                  Every wigner d-matrix is computed and rearranged by the symmetries
+ *                  only once per \f$(M, M')\f$ and then applied to all containers of
+ *                  the batch. The layer-wise IFFT2 of all grids share one FFTW plan.
+ *                  The result is equal to calling FourierTransforms::IDSOFT for
+ *                  every container separately.
+ *
+ * @param[in]       fc Array of count pointers to Fourier coefficient containers
+ * @param[out]      synthesis Array of count pointers to the synthesis grids
+ * @param[in]       count The number of transforms in the batch
+ * @param[in]       threads The number of threads used for the batch
+ *
+ * @sa              FourierTransforms::IDSOFT
+ *
+ * @since           1.0.0
+ *
+ * @ingroup         FourierTransforms
+ */
+void IDSOFT(const DSOFTFourierCoefficients* const* fc, grid3D< complex< double > >* const* synthesis, const int& count, int threads)
+{
+    idsoft(fc, synthesis, count, nullptr, threads);
+}
+
+
+/*!
+ * @brief           Orders sparse coefficients by their orders and degree
+ */
+static bool sparse_order_less(const DSOFTSparseCoefficient& a, const DSOFTSparseCoefficient& b)
+{
+    if (a.M  != b.M)  { return a.M  < b.M;  }
+    if (a.Mp != b.Mp) { return a.Mp < b.Mp; }
+    return a.l < b.l;
+}
+
+/*!
+ * @brief           The inverse DSOFT for a sparse set of Fourier coefficients
+ * @details         Synthesizes a function from a list of non-zero coefficients
+ *                  \f$\hat{f}^l_{M,M'}\f$. The entries are grouped by their orders.
+ *                  For every distinct \f$(M, M')\f$ only the wigner d-matrix rows up
+ *                  to the largest degree of the group are computed and combined into
+ *                  \f$t_{M,M'}(\beta_k) = \sum_l \hat{f}^l_{M,M'}\tilde{d}^l_{M,M'}(\beta_k)\f$.
+ *                  Instead of inverse FFTs over all \f$2B\times 2B\f$ modes only the
+ *                  non-zero modes are evaluated directly,
+ *                  \f[
+ *                      f(\alpha_{j_1},\beta_k,\gamma_{j_2}) = \frac{1}{2\pi}\sum\limits_{(M,M')}
+ *                          t_{M,M'}(\beta_k)e^{iM\alpha_{j_1}}e^{iM'\gamma_{j_2}}
+ *                  \f]
+ *                  which costs \f$\mathcal{O}(B^3)\f$ per distinct order pair. If the
+ *                  number of distinct order pairs exceeds IDSOFT_SPARSE_RATIO times the
+ *                  bandwidth, the coefficients are scattered into a dense container and
+ *                  the dense FourierTransforms::IDSOFT is used instead. Both paths give
+ *                  the same synthesis up to rounding.
+ *
+ * @param[in]       coefficients The non-zero Fourier coefficients. Entries with the
+ *                  same degree and orders are summed up.
+ * @param[out]      synthesis The synthesized sample for the given Fourier coefficients.
+ * @param[in]       threads The number of threads used for the synthesis
+ *
+ * @sa              DSOFTSparseCoefficient
+ * @sa              FourierTransforms::IDSOFT
+ *
+ * @since           1.0.0
+ *
+ * @ingroup         FourierTransforms
+ */
+void IDSOFT(const std::vector< DSOFTSparseCoefficient >& coefficients, grid3D< complex< double > >& synthesis, int threads)
+{
+    /*****************************************************************
+     ** Check parameters                                            **
+     *****************************************************************/
+    // Check if the grid has same size in each dimension
+    pfsoft_cond_w_ret(synthesis.rows != synthesis.cols || synthesis.rows != synthesis.lays, "%s", "all IDSOFT synthesis grid dimensions should be equal.");
+    
+    // Check if grid has odd dimensions
+    pfsoft_cond_w_ret(synthesis.rows & 1, "%s", "IDSOFT synthesis grid dimensions are not even.");
+    
+    // Extract bandwidth
+    const int bandwidth = static_cast< int >(synthesis.cols / 2);
+    
+    // precompute the double bandwidth
+    const int bw2 = 2 * bandwidth;
+    
+    // Check if all coefficients fit into the bandwidth
+    bool valid = true;
+    for (size_t i = 0; i < coefficients.size(); ++i)
+    {
+        const DSOFTSparseCoefficient& c = coefficients[i];
+        valid = valid && c.l >= 0 && c.l < bandwidth && abs(c.M) <= c.l && abs(c.Mp) <= c.l;
+    }
+    
+    pfsoft_cond_w(!valid, "%s", "illegal sparse IDSOFT coefficient. Condition |M|,|Mp| <= l < B violated.");
+    
+    if (!valid)
+    {
+        return;
+    }
+    
+    // group entries with equal orders
+    std::vector< DSOFTSparseCoefficient > entries(coefficients);
+    std::sort(entries.begin(), entries.end(), sparse_order_less);
+    
+    std::vector< size_t > groups;
+    for (size_t i = 0; i < entries.size(); ++i)
+    {
+        if (i == 0 || entries[i].M != entries[i - 1].M || entries[i].Mp != entries[i - 1].Mp)
+        {
+            groups.push_back(i);
+        }
+    }
+    groups.push_back(entries.size());
+    
+    const int pairs = static_cast< int >(groups.size()) - 1;
+    
+    /*****************************************************************
+     ** Dense fallback                                              **
+     *****************************************************************/
+    if (pairs > IDSOFT_SPARSE_RATIO * bandwidth)
+    {
+        DSOFTFourierCoefficients fc(bandwidth);
+        
+        for (int l = 0; l < bandwidth; ++l)
+        {
+            for (int M = -l; M <= l; ++M)
+            {
+                for (int Mp = -l; Mp <= l; ++Mp)
+                {
+                    fc(l, M, Mp) = complex< double >(0, 0);
+                }
+            }
+        }
+        
+        for (size_t i = 0; i < entries.size(); ++i)
+        {
+            fc(entries[i].l, entries[i].M, entries[i].Mp) += entries[i].value;
+        }
+        
+        IDSOFT(fc, synthesis, threads);
+        return;
+    }
+    
+    /*****************************************************************
+     ** DWT per distinct (M, M')                                    **
+     *****************************************************************/
+    // beta profiles t_{M,M'}(beta_k) and the phases of alpha and gamma
+    std::vector< complex< double > > t(pairs * bw2), pa(pairs * bw2), pg(pairs * bw2);
+    
+    const double pi = constants< double >::pi;
+    
+    int g;
+    #pragma omp parallel for schedule(dynamic) num_threads(threads) if(threads > 1 && pairs > 1)
+    for (g = 0; g < pairs; ++g)
+    {
+        const int M    = entries[groups[g]].M;
+        const int Mp   = entries[groups[g]].Mp;
+        const int minJ = std::max(abs(M), abs(Mp));
+        const int maxJ = entries[groups[g + 1] - 1].l;
+        
+        // only the rows up to the largest degree of this group
+        matrix< long double > d(maxJ - minJ + 1, bw2);
+        DWT::wigner_d_matrix< long double >(d, bandwidth, M, Mp);
+        
+        const long double sign = DWT::kernel_sign< long double >(M, Mp) / (2 * constants< long double >::pi);
+        
+        for (int k = 0; k < bw2; ++k)
+        {
+            long double re = 0, im = 0;
+            for (size_t i = groups[g]; i < groups[g + 1]; ++i)
+            {
+                re += entries[i].value.re * d(entries[i].l - minJ, k);
+                im += entries[i].value.im * d(entries[i].l - minJ, k);
+            }
+            
+            t[g * bw2 + k] = complex< double >(static_cast< double >(sign * re), static_cast< double >(sign * im));
+        }
+        
+        for (int j = 0; j < bw2; ++j)
+        {
+            pa[g * bw2 + j] = complex< double >(cos(M  * pi * j / bandwidth), sin(M  * pi * j / bandwidth));
+            pg[g * bw2 + j] = complex< double >(cos(Mp * pi * j / bandwidth), sin(Mp * pi * j / bandwidth));
+        }
+    }
+    
+    /*****************************************************************
+     ** Direct evaluation of the non-zero modes per layer           **
+     *****************************************************************/
+    const bool dense = synthesis.contiguous();
+    
+    int k;
+    #pragma omp parallel for schedule(static) num_threads(threads) if(threads > 1)
+    for (k = 0; k < bw2; ++k)
+    {
+        // strided views get their layers through a dense buffer
+        std::vector< complex< double > > buffer(dense ? 0 : bw2 * bw2);
+        
+        complex< double >* layer = (dense ? access::rwp(synthesis.mem) + static_cast< size_t >(k) * bw2 * bw2 : buffer.data());
+        std::fill(layer, layer + bw2 * bw2, complex< double >(0, 0));
+        
+        for (int p = 0; p < pairs; ++p)
+        {
+            const complex< double >& tk = t[p * bw2 + k];
+            
+            for (int j1 = 0; j1 < bw2; ++j1)
+            {
+                // t_{M,M'}(beta_k) * exp(i M alpha_{j1})
+                const complex< double >& a = pa[p * bw2 + j1];
+                const double cre = tk.re * a.re - tk.im * a.im;
+                const double cim = tk.re * a.im + tk.im * a.re;
+                
+                complex< double >* column = layer + j1 * bw2;
+                for (int j2 = 0; j2 < bw2; ++j2)
+                {
+                    // times exp(i M' gamma_{j2})
+                    const complex< double >& c = pg[p * bw2 + j2];
+                    column[j2].re += cre * c.re - cim * c.im;
+                    column[j2].im += cre * c.im + cim * c.re;
+                }
+            }
+        }
+        
+        if (!dense)
+        {
+            synthesis.assign_layers(layer, k, 1);
+        }
+    }
 }
 
 PFSOFT_NAMESPACE_END
@@ -0,0 +1,252 @@
+//
+//  fn_idsoft_stream.cpp
+//  PFSOFTlib
+//
+//   Created by Denis-Michael Lux on 05. November 2015.
+//
+//   This file is part of PFSOFTlib.
+//
+//   PFSOFTlib is free software: you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License as published by
+//   the Free Software Foundation, either version 3 of the License, or
+//   (at your option) any later version.
+//
+//   PFSOFTlib is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with PFSOFTlib.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <algorithm>
+
+#include <pfsoft>
+
+PFSOFT_NAMESPACE(FourierTransforms)
+
+/*!
+ * @brief           The block-wise IDSOFT that records its timing breakdown to
+ *                  stats if stats is not nullptr
+ */
+static void idsoft_stream(const DSOFTFourierCoefficients& fc, const int& bandwidth, const IDSOFTLayerCallback& callback, const int& block, DSOFTStats* stats, int threads)
+{
+    /*****************************************************************
+     ** Check parameters                                            **
+     *****************************************************************/
+    // Check if the Fourier coefficients container fits to the synthesis bandwidth
+    pfsoft_cond_w_ret(fc.bandwidth > bandwidth || fc.bandwidth < 1, "%s", "IDSOFT Fourier coefficients container bandwidth exceeds the synthesis bandwidth.");
+    
+    // Check block size
+    pfsoft_cond_w_ret(block < 1, "%s", "IDSOFT stream block size has to be positive.");
+    
+    // print warinings for serial implementation
+    #ifndef _OPENMP
+    pfsoft_cond_w(threads != 1, "%s", "compiler does not support OpenMP. Changing the number of threads for the IDSOFT has no effect.");
+    #endif
+    
+    // precompute the double bandwidth and the effective bandlimit
+    const int bw2       = 2 * bandwidth;
+    const int bandlimit = fc.bandwidth;
+    const int layers    = std::min(block, bw2);
+    
+    // number of threads from the tuning profile and whether the
+    // (M, M') loop runs in parallel for this bandwidth
+    threads             = DSOFT_threads(bandwidth, threads);
+    const bool parallel = threads > 1 && bandwidth >= DSOFT_threshold();
+    
+    if (stats != nullptr)
+    {
+        stats->reset(bandwidth, parallel ? threads : 1);
+    }
+    
+    // lap timer of the stages that run on the calling thread
+    pfsoft_stats_timer(lap, stats);
+    
+    // Representatives M >= |M'| of the symmetry orbits. They are
+    // enumerated by r = M^2 + M + M'.
+    const int reps = bandlimit * bandlimit;
+    
+    // norm of the synthesis with an unnormalized IFFT2
+    const long double norm = 1 / (2 * constants< long double >::pi);
+    
+    // block buffer and IFFT2 plan for one block
+    grid3D< complex< double > > buffer(bw2, bw2, layers);
+    double* data = reinterpret_cast< double* >(access::rwp(buffer.mem));
+    
+    uzl_fftw_layer_context ctx;
+    uzl_fftw_layer_context_create(&ctx, bw2, bw2, layers, data, +1); pfsoft_stats_lap(lap, FFT);
+    
+    for (int first = 0; first < bw2; first += layers)
+    {
+        const int count = std::min(layers, bw2 - first);
+        
+        // the last block may have fewer layers
+        access::rw(buffer.lays) = count;
+        std::fill(access::rwp(buffer.mem), access::rwp(buffer.mem) + bw2 * bw2 * count, complex< double >(0, 0)); pfsoft_stats_lap(lap, SCATTER);
+        
+        /*****************************************************************
+         ** DWT for all orders on the layers of this block              **
+         *****************************************************************/
+        #pragma omp parallel default(shared) if(parallel) num_threads(threads)
+        {
+            pfsoft_stats_timer(lap, stats);
+            
+            int r;
+            #pragma omp for schedule(dynamic) nowait
+            for (r = 0; r < reps; ++r)
+            {
+                // reconstruct the orders of the representative
+                int M = static_cast< int >(sqrt(static_cast< double >(r)));
+                while (M * M > r)             { --M; }
+                while ((M + 1) * (M + 1) <= r) { ++M; }
+                
+                const int Mp = r - M * M - M;
+                
+                pfsoft_stats_group(lap, M, Mp);
+                
+                // wigner d-matrix for the columns of this block
+                matrix< long double > d(bandlimit - M, count);
+                DWT::wigner_d_matrix< long double >(d, bandwidth, M, Mp, first); pfsoft_stats_lap(lap, WIGNER);
+                
+                // the kernel sign of a representative is -1, see DWT::kernel_sign
+                const long double sign   = -norm;
+                const long double parity = ((M - Mp) & 1 ? -1 : 1);
+                
+                // orders that share the wigner d-matrix and their signs
+                const int         oM[4] = { M, Mp, -Mp, -M  };
+                const int         oN[4] = { Mp, M, -M, -Mp };
+                const long double oS[4] = { sign, parity * sign, sign, parity * sign };
+                
+                for (int o = 0; o < 4; ++o)
+                {
+                    // skip orders that already occured in this orbit
+                    bool seen = false;
+                    for (int p = 0; p < o; ++p)
+                    {
+                        seen = seen || (oM[p] == oM[o] && oN[p] == oN[o]);
+                    }
+                    
+                    if (seen)
+                    {
+                        continue;
+                    }
+                    
+                    const size_t row = (oN[o] >= 0 ? oN[o] : bw2 + oN[o]);
+                    const size_t col = (oM[o] >= 0 ? oM[o] : bw2 + oM[o]);
+                    
+                    for (int j = 0; j < count; ++j)
+                    {
+                        long double re = 0, im = 0;
+                        for (int l = M; l < bandlimit; ++l)
+                        {
+                            const complex< double >& c = fc(l, oM[o], oN[o]);
+                            re += c.re * d(l - M, j);
+                            im += c.im * d(l - M, j);
+                        }
+                        
+                        buffer(row, col, j) = complex< double >(static_cast< double >(oS[o] * re), static_cast< double >(oS[o] * im));
+                    }
+                }
+                
+                pfsoft_stats_lap(lap, DWT);
+            }
+            
+            pfsoft_stats_merge(lap, true);
+        }
+        
+        pfsoft_stats_loops(lap);
+        
+        /*****************************************************************
+         ** IFFT2 of the layers of this block                           **
+         *****************************************************************/
+        uzl_fftw_layer_context part = ctx;
+        part.lays                   = count;
+        uzl_fftw_layer_context_execute(&part, data, threads); pfsoft_stats_lap(lap, FFT);
+        
+        callback(buffer, first); pfsoft_stats_lap(lap, SCATTER);
+    }
+    
+    access::rw(buffer.lays) = layers;
+    uzl_fftw_layer_context_destroy(&ctx); pfsoft_stats_lap(lap, FFT);
+    pfsoft_stats_merge(lap, false);
+}
+
+/*!
+ * @brief           The inverse DSOFT that streams the synthesis block by block of
+ *                  \f$\beta\f$-layers
+ * @details         Computes the same synthesis as FourierTransforms::IDSOFT for a
+ *                  grid of bandwidth \f$B\f$, but never holds the whole
+ *                  \f$2B\times 2B\times 2B\f$ grid. The layers are produced in blocks
+ *                  of the given number of layers. For every block the DWT results of
+ *                  all orders are collected in a buffer of \f$2B\times 2B\times block\f$
+ *                  elements, the layer-wise IFFT2 runs on the buffer as soon as the
+ *                  block is complete and the buffer is handed to the callback before
+ *                  the next block reuses it.
+ *
+ *                  The wigner d-matrices are computed for the columns of the current
+ *                  block only, so the total DWT work is independent of the block size.
+ *                  The flip symmetries \f$\beta\mapsto\pi-\beta\f$ of the dense transform
+ *                  map layers into other blocks and are not used. The remaining
+ *                  symmetries
+ *                  \f{eqnarray*}{
+ *                      d^{J}_{MM'}(\beta) &=& (-1)^{M-M'}d^J_{M'M}(\beta)\\
+ *                      &=& (-1)^{M-M'}d^J_{-M-M'}(\beta)\\
+ *                      &=& d^J_{-M'-M}(\beta)
+ *                  \f}
+ *                  still cover four orders per wigner d-matrix.
+ *
+ * @param[in]       fc A Fourier coefficent managment container. Its bandwidth must
+ *                  not exceed the bandwidth of the synthesis.
+ * @param[in]       bandwidth The bandwidth \f$B\f$ of the synthesis grid
+ * @param[in]       callback Called once per block with the synthesized layers and the
+ *                  index of the first layer of the block. Layer \f$j\f$ of the block
+ *                  belongs to \f$\beta_{first + j}\f$. The last block may have fewer
+ *                  layers. The buffer is only valid during the call.
+ * @param[in]       block The number of layers per block
+ * @param[in]       threads The number of threads used for the synthesis
+ *
+ * @sa              FourierTransforms::IDSOFT
+ * @sa              DWT::wigner_d_matrix
+ *
+ * @since           1.0.0
+ *
+ * @ingroup         FourierTransforms
+ */
+void IDSOFT_stream(const DSOFTFourierCoefficients& fc, const int& bandwidth, const IDSOFTLayerCallback& callback, const int& block, int threads)
+{
+    idsoft_stream(fc, bandwidth, callback, block, nullptr, threads);
+}
+
+/*!
+ * @brief           The block-wise IDSOFT with a timing breakdown
+ * @details         Computes the same synthesis as FourierTransforms::IDSOFT_stream
+ *                  and reports the wall time of the call. If the library is built
+ *                  with PFSOFT_STATS, the time of every stage and the busy time of
+ *                  every thread is reported as well. The stages and the loops are
+ *                  summed over all blocks, SCATTER includes the callbacks.
+ *
+ * @param[in]       fc The Fourier coefficients of \f$f\f$
+ * @param[in]       bandwidth The bandwidth \f$B\f$ of the synthesis grid
+ * @param[in]       callback Called once per block with the synthesized layers
+ * @param[in]       block The number of layers per block
+ * @param[out]      stats The timing breakdown of the call
+ * @param[in]       threads The number of threads
+ *
+ * @sa              DSOFTStats
+ *
+ * @ingroup         FourierTransforms
+ *
+ * @since           1.0.0
+ */
+void IDSOFT_stream(const DSOFTFourierCoefficients& fc, const int& bandwidth, const IDSOFTLayerCallback& callback, const int& block, DSOFTStats& stats, int threads)
+{
+    stats.reset(bandwidth, 1);
+    
+    const double start = DSOFTStatsTimer::now();
+    idsoft_stream(fc, bandwidth, callback, block, &stats, threads);
+    stats.total = DSOFTStatsTimer::now() - start;
+}
+
+PFSOFT_NAMESPACE_END
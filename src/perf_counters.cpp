@@ -0,0 +1,273 @@
+//
+//  perf_counters.cpp
+//  PFSOFTlib
+//
+//   Created by Denis-Michael Lux on 05. November 2015.
+//
+//   This file is part of PFSOFTlib.
+//
+//   PFSOFTlib is free software: you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License as published by
+//   the Free Software Foundation, either version 3 of the License, or
+//   (at your option) any later version.
+//
+//   PFSOFTlib is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with PFSOFTlib.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <pfsoft>
+
+#ifdef __linux__
+    #include <linux/perf_event.h>
+    #include <sys/syscall.h>
+    #include <sys/ioctl.h>
+#endif
+
+PFSOFT_BEGIN
+
+#ifdef __linux__
+/*!
+ * @brief           Opens a user space counter of the calling thread
+ * @return          The file descriptor or -1 if the event is not available
+ */
+static int open_event(const uint32_t& type, const uint64_t& config)
+{
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    
+    attr.size           = sizeof(attr);
+    attr.type           = type;
+    attr.config         = config;
+    attr.disabled       = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv     = 1;
+    attr.read_format    = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    
+    return static_cast< int >(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+}
+
+/*!
+ * @brief           Reads a counter and extrapolates it if it was multiplexed
+ * @return          The count or -1 if it could not be read
+ */
+static long long read_event(const int& fd)
+{
+    uint64_t data[3];
+    
+    if (fd < 0 || read(fd, data, sizeof(data)) != sizeof(data))
+    {
+        return -1;
+    }
+    
+    // data[1] is the time the event was enabled, data[2] the time it
+    // was actually counted
+    if (data[2] == 0)
+    {
+        return 0;
+    }
+    
+    return static_cast< long long >(data[0] * (static_cast< double >(data[1]) / data[2]));
+}
+
+/*!
+ * @brief           Whether the FP_ARITH_INST_RETIRED raw events can be used
+ */
+static bool intel_cpu()
+{
+    FILE* fp = fopen("/proc/cpuinfo", "r");
+    if (fp == nullptr)
+    {
+        return false;
+    }
+    
+    char line[256];
+    bool intel = false;
+    
+    while (fgets(line, sizeof(line), fp) != nullptr)
+    {
+        if (strncmp(line, "vendor_id", 9) == 0)
+        {
+            intel = strstr(line, "GenuineIntel") != nullptr;
+            break;
+        }
+    }
+    
+    fclose(fp);
+    return intel;
+}
+#endif
+
+/*!
+ * @brief           Opens the counters of the calling thread or an OpenMP team
+ * @details         The counters are opened disabled. Events that are not available
+ *                  are silently skipped. For more than one thread every thread of
+ *                  an OpenMP region with the given number of threads opens its own
+ *                  set of counters.
+ *
+ * @param[in]       flops Whether the floating point operations should be counted.
+ *                  They need four additional counters, which may cause the kernel
+ *                  to multiplex the other events.
+ * @param[in]       threads The number of threads of the team
+ */
+perf_counters::perf_counters(const bool& flops, const int& threads)
+    : fd(FDS * std::max(1, threads), -1)
+{
+    for (int e = 0; e < EVENTS; ++e)
+    {
+        counts[e] = -1;
+    }
+
+#ifdef __linux__
+    const bool intel = flops && intel_cpu();
+    const int  team  = std::max(1, threads);
+    
+    #pragma omp parallel num_threads(team) if(team > 1)
+    {
+        int thread = 0;
+        #ifdef _OPENMP
+        thread = omp_get_thread_num();
+        #endif
+        
+        int* f = &fd[FDS * thread];
+        
+        f[CYCLES]       = open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+        f[INSTRUCTIONS] = open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+        f[LLC_MISSES]   = open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+        
+        // FP_ARITH_INST_RETIRED (event 0xC7) with the umasks of the scalar,
+        // 128, 256 and 512 bit packed double precision instructions
+        if (intel)
+        {
+            const uint64_t umask[FLOP_EVENTS] = { 0x01, 0x04, 0x10, 0x40 };
+            
+            for (int i = 0; i < FLOP_EVENTS; ++i)
+            {
+                f[FLOPS + i] = open_event(PERF_TYPE_RAW, (umask[i] << 8) | 0xC7);
+            }
+        }
+    }
+#else
+    pfsoft_cond_w(true, "%s", "hardware performance counters are only available on Linux.");
+#endif
+}
+
+/*!
+ * @brief           Closes all counters
+ */
+perf_counters::~perf_counters()
+{
+    for (size_t i = 0; i < fd.size(); ++i)
+    {
+        if (fd[i] >= 0)
+        {
+            close(fd[i]);
+        }
+    }
+}
+
+/*!
+ * @brief           Resets and starts all available counters
+ */
+void perf_counters::start()
+{
+#ifdef __linux__
+    for (size_t i = 0; i < fd.size(); ++i)
+    {
+        if (fd[i] >= 0)
+        {
+            ioctl(fd[i], PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd[i], PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+#endif
+}
+
+/*!
+ * @brief           Stops all available counters and reads their counts
+ * @details         The counts of all threads are summed up. An event is available
+ *                  if the calling thread could open it.
+ */
+void perf_counters::stop()
+{
+#ifdef __linux__
+    for (size_t i = 0; i < fd.size(); ++i)
+    {
+        if (fd[i] >= 0)
+        {
+            ioctl(fd[i], PERF_EVENT_IOC_DISABLE, 0);
+        }
+    }
+    
+    // operations per instruction of the scalar and packed instructions
+    const int width[FLOP_EVENTS] = { 1, 2, 4, 8 };
+    
+    for (int e = 0; e < EVENTS; ++e)
+    {
+        counts[e] = (fd[e] >= 0 ? 0 : -1);
+    }
+    
+    for (size_t t = 0; t < fd.size(); t += FDS)
+    {
+        for (int e = 0; e < FLOPS; ++e)
+        {
+            const long long n = read_event(fd[t + e]);
+            counts[e]        += (fd[e] >= 0 && n > 0 ? n : 0);
+        }
+        
+        for (int i = 0; i < FLOP_EVENTS && fd[FLOPS] >= 0; ++i)
+        {
+            const long long n = read_event(fd[t + FLOPS + i]);
+            counts[FLOPS]    += (n > 0 ? width[i] * n : 0);
+        }
+    }
+#endif
+}
+
+/*!
+ * @brief           Whether an event could be opened
+ */
+bool perf_counters::available(const event& e) const
+{
+    return e >= 0 && e < EVENTS && fd[e] >= 0;
+}
+
+/*!
+ * @brief           The count of an event of the last measurement
+ * @return          The count between the last start() and stop() or -1 if the
+ *                  event is not available
+ */
+long long perf_counters::value(const event& e) const
+{
+    return (e >= 0 && e < EVENTS ? counts[e] : -1);
+}
+
+/*!
+ * @brief           Instructions per cycle of the last measurement
+ * @return          The instructions per cycle or -1 if not available
+ */
+double perf_counters::ipc() const
+{
+    if (counts[CYCLES] <= 0 || counts[INSTRUCTIONS] < 0)
+    {
+        return -1;
+    }
+    
+    return static_cast< double >(counts[INSTRUCTIONS]) / counts[CYCLES];
+}
+
+/*!
+ * @brief           The name of an event
+ */
+const char* perf_counters::name(const int& e)
+{
+    static const char* names[EVENTS] = { "cycles", "instructions", "llc_misses", "flops" };
+    
+    return (e >= 0 && e < EVENTS ? names[e] : "unknown");
+}
+
+PFSOFT_END
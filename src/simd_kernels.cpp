@@ -0,0 +1,294 @@
+//
+//  simd_kernels.cpp
+//  PFSOFTlib
+//
+//   Created by Denis-Michael Lux on 05. November 2015.
+//
+//   This file is part of PFSOFTlib.
+//
+//   PFSOFTlib is free software: you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License as published by
+//   the Free Software Foundation, either version 3 of the License, or
+//   (at your option) any later version.
+//
+//   PFSOFTlib is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with PFSOFTlib.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <pfsoft>
+
+PFSOFT_NAMESPACE(SIMD)
+
+#if PFSOFT_TARGET_CLONES
+// One version of the tag per clone of pfsoft_target_clones. The loader resolves
+// them with the same resolver as the kernels, so the version it picks is the
+// clone the kernels run.
+__attribute__((target("avx512f"))) static const char* resolved_variant() { return "avx512f"; }
+__attribute__((target("avx2")))    static const char* resolved_variant() { return "avx2";    }
+__attribute__((target("default"))) static const char* resolved_variant() { return "sse2";    }
+#endif
+
+/*!
+ * @brief           The variant of the kernels the loader selected
+ * @details         Reports the version of a function that is cloned for the
+ *                  same instruction sets as the kernels, so it names the
+ *                  clone the ifunc resolver picked instead of testing the
+ *                  processor again.
+ *
+ * @return          "avx512f", "avx2" or "sse2" for the clones on x86-64 and
+ *                  "generic" if the library is built without target clones
+ *
+ * @since           1.0.0
+ */
+const char* variant()
+{
+#if PFSOFT_TARGET_CLONES
+    return resolved_variant();
+#else
+    return "generic";
+#endif
+}
+
+/*!
+ * @brief           Multiplies complex values with a complex scalar
+ *
+ * @param[in,out]   x The interleaved complex values
+ * @param[in]       n The number of complex values
+ * @param[in]       re The real part of the scalar
+ * @param[in]       im The imaginary part of the scalar
+ *
+ * @since           1.0.0
+ */
+pfsoft_target_clones
+void scale(double* __restrict__ x, const size_t& n, const double& re, const double& im)
+{
+    const double sr = re;
+    const double si = im;
+    
+    for (size_t i = 0; i < n; ++i)
+    {
+        const double xr = x[2 * i];
+        const double xi = x[2 * i + 1];
+        
+        x[2 * i]     = xr * sr - xi * si;
+        x[2 * i + 1] = xr * si + xi * sr;
+    }
+}
+
+/*!
+ * @brief           Product of a real matrix and a complex vector
+ * @details         Runs over the columns of the matrix, so the inner loop reads
+ *                  the matrix and writes the result contiguously.
+ *
+ * @param[in]       A The real matrix with rows times cols elements
+ * @param[in]       rows The number of rows of A
+ * @param[in]       cols The number of columns of A
+ * @param[in]       x The interleaved complex vector of length cols
+ * @param[out]      y The interleaved complex result of length rows
+ *
+ * @since           1.0.0
+ */
+pfsoft_target_clones
+void gemv(const double* __restrict__ A, const size_t& rows, const size_t& cols, const double* __restrict__ x, double* __restrict__ y)
+{
+    const size_t r = rows;
+    const size_t c = cols;
+    
+    for (size_t j = 0; j < 2 * r; ++j)
+    {
+        y[j] = 0;
+    }
+    
+    for (size_t i = 0; i < c; ++i)
+    {
+        const double  xr  = x[2 * i];
+        const double  xi  = x[2 * i + 1];
+        const double* col = A + i * r;
+        
+        for (size_t j = 0; j < r; ++j)
+        {
+            y[2 * j]     += col[j] * xr;
+            y[2 * j + 1] += col[j] * xi;
+        }
+    }
+}
+
+/*!
+ * @brief           One step of the three-term recurrence of the wigner d-matrix
+ * @details         Computes row i + 1 of the matrix from the rows i and i - 1 for
+ *                  all sampling angles, see DWT::wigner_d_matrix. Row i - 1 is
+ *                  treated as zero for i = 0.
+ *
+ * @param[in,out]   wig The wigner d-matrix with rows times cols elements
+ * @param[in]       rows The number of rows of the matrix
+ * @param[in]       cols The number of columns of the matrix
+ * @param[in]       i The row the step starts from
+ * @param[in]       cosBeta The cosines of the sampling angles of the columns
+ * @param[in]       c1 The coefficient of row i - 1
+ * @param[in]       f1 The coefficient of row i
+ * @param[in]       f2 The shift of the cosines
+ *
+ * @since           1.0.0
+ */
+pfsoft_target_clones
+void wigner_step(double* __restrict__ wig, const size_t& rows, const size_t& cols, const size_t& i, const double* __restrict__ cosBeta, const double& c1, const double& f1, const double& f2)
+{
+    const size_t r  = rows;
+    const size_t c  = cols;
+    const double a  = c1;
+    const double b  = f1;
+    const double s  = f2;
+    
+    if (i == 0)
+    {
+        const double zero = a * 0.0;
+        
+        for (size_t j = 0; j < c; ++j)
+        {
+            wig[j * r + 1] = zero + wig[j * r] * b * (s + cosBeta[j]);
+        }
+    }
+    else
+    {
+        for (size_t j = 0; j < c; ++j)
+        {
+            wig[j * r + i + 1] = a * wig[j * r + i - 1] + wig[j * r + i] * b * (s + cosBeta[j]);
+        }
+    }
+}
+
+/*!
+ * @brief           Swaps two arrays and multiplies the elements with a sign
+ *                  depending on the parity of their index
+ * @details         The column swap of the left-right flips.
+ *
+ * @param[in,out]   a The first array
+ * @param[in,out]   b The second array
+ * @param[in]       n The length of the arrays
+ * @param[in]       even The sign of the elements with even index
+ * @param[in]       odd The sign of the elements with odd index
+ *
+ * @since           1.0.0
+ */
+pfsoft_target_clones
+void swap(double* __restrict__ a, double* __restrict__ b, const size_t& n, const double& even, const double& odd)
+{
+    const size_t len = n;
+    const double se  = even;
+    const double so  = odd;
+    
+    for (size_t k = 0; k < len; ++k)
+    {
+        const double sign = (k & 1 ? so : se);
+        const double tmp  = a[k];
+        
+        a[k] = sign * b[k];
+        b[k] = sign * tmp;
+    }
+}
+
+/*!
+ * @brief           Reverses an array and multiplies its elements with a sign
+ * @details         The column flip of the up-down flips. The middle element of an
+ *                  array of odd length is not touched.
+ *
+ * @param[in,out]   a The array
+ * @param[in]       n The length of the array
+ * @param[in]       sign The factor of the swapped elements
+ *
+ * @since           1.0.0
+ */
+pfsoft_target_clones
+void reverse(double* __restrict__ a, const size_t& n, const double& sign)
+{
+    const size_t len = n;
+    const double s   = sign;
+    
+    for (size_t j = 0; j < len / 2; ++j)
+    {
+        const double tmp = a[j];
+        
+        a[j]           = s * a[len - j - 1];
+        a[len - j - 1] = s * tmp;
+    }
+}
+
+/*!
+ * @brief           Scales complex values and stores them as the Fourier
+ *                  coefficients of consecutive degrees
+ * @details         Value k becomes the coefficient of degree first + k and orders
+ *                  (M, M') in the layout of DSOFTFourierCoefficients, see
+ *                  DSOFTFourierCoefficients::offset. Negative orders count from
+ *                  the end of their degree.
+ *
+ * @param[in]       x The interleaved complex values
+ * @param[in]       n The number of complex values
+ * @param[in]       factor The real factor of the values
+ * @param[out]      fc The interleaved coefficients of all degrees
+ * @param[in]       first The degree of the first value
+ * @param[in]       M The first order
+ * @param[in]       Mp The second order
+ *
+ * @since           1.0.0
+ */
+pfsoft_target_clones
+void scatter(const double* __restrict__ x, const size_t& n, const double& factor, double* __restrict__ fc, const int& first, const int& M, const int& Mp)
+{
+    const size_t len = n;
+    const double f   = factor;
+    const long   l0  = first;
+    const long   m   = M;
+    const long   mp  = Mp;
+    
+    for (size_t k = 0; k < len; ++k)
+    {
+        const long l   = l0 + static_cast< long >(k);
+        const long dim = 2 * l + 1;
+        const long idx = (4 * l * l * l - l) / 3 + (mp >= 0 ? mp : dim + mp) * dim + (m >= 0 ? m : dim + m);
+        
+        fc[2 * idx]     = f * x[2 * k];
+        fc[2 * idx + 1] = f * x[2 * k + 1];
+    }
+}
+
+/*!
+ * @brief           Loads the Fourier coefficients of consecutive degrees and
+ *                  scales them
+ * @details         The reverse of SIMD::scatter.
+ *
+ * @param[in]       fc The interleaved coefficients of all degrees
+ * @param[in]       n The number of complex values
+ * @param[in]       factor The real factor of the values
+ * @param[out]      x The interleaved complex values
+ * @param[in]       first The degree of the first value
+ * @param[in]       M The first order
+ * @param[in]       Mp The second order
+ *
+ * @since           1.0.0
+ */
+pfsoft_target_clones
+void gather(const double* __restrict__ fc, const size_t& n, const double& factor, double* __restrict__ x, const int& first, const int& M, const int& Mp)
+{
+    const size_t len = n;
+    const double f   = factor;
+    const long   l0  = first;
+    const long   m   = M;
+    const long   mp  = Mp;
+    
+    for (size_t k = 0; k < len; ++k)
+    {
+        const long l   = l0 + static_cast< long >(k);
+        const long dim = 2 * l + 1;
+        const long idx = (4 * l * l * l - l) / 3 + (mp >= 0 ? mp : dim + mp) * dim + (m >= 0 ? m : dim + m);
+        
+        x[2 * k]     = f * fc[2 * idx];
+        x[2 * k + 1] = f * fc[2 * idx + 1];
+    }
+}
+
+PFSOFT_NAMESPACE_END
@@ -0,0 +1,660 @@
+//
+//  so3_correlation.cpp
+//  PFSOFTlib
+//
+//   Created by Denis-Michael Lux on 05. November 2015.
+//
+//   This file is part of PFSOFTlib.
+//
+//   PFSOFTlib is free software: you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License as published by
+//   the Free Software Foundation, either version 3 of the License, or
+//   (at your option) any later version.
+//
+//   PFSOFTlib is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with PFSOFTlib.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <algorithm>
+
+#include <pfsoft>
+
+PFSOFT_BEGIN
+
+/*!
+ * @brief           Constructor for a SO3Correlation object
+ * @details         Allocates a Fourier coefficients container and an Euler angle
+ *                  grid for the given bandwidth per batch slot. They are reused
+ *                  for every correlation.
+ *
+ * @param[in]       bandlimit The bandwidth of the functions that get correlated
+ * @param[in]       batchsize The number of correlations that are synthesized at
+ *                  once when matching against several templates
+ */
+SO3Correlation::SO3Correlation(int bandlimit, int batchsize)
+    : factors(bandlimit)
+    , first(-1)
+    , chunk(1)
+    , bandwidth(bandlimit)
+    , batch(std::max(1, batchsize))
+{
+    coef      = new DSOFTFourierCoefficients*[batch];
+    synthesis = new grid3D< complex< double > >*[batch];
+    
+    for (int i = 0; i < batch; ++i)
+    {
+        coef[i]      = new DSOFTFourierCoefficients(bandwidth);
+        synthesis[i] = new grid3D< complex< double > >(2 * bandwidth);
+    }
+    
+    // The DSOFT basis functions are 1/(2pi) * sqrt((2l+1)/2) * conj(D^l_{M'M})
+    // with the Euler angles on the grid. Compensate this normalization.
+    for (int l = 0; l < bandwidth; ++l)
+    {
+        factors[l] = 2.0 * constants< double >::pi * sqrt(2.0 / (2.0 * l + 1.0));
+    }
+}
+
+/*!
+ * @brief           Destructor for the SO3Correlation object
+ */
+SO3Correlation::~SO3Correlation()
+{
+    for (int i = 0; i < batch; ++i)
+    {
+        delete coef[i];
+        delete synthesis[i];
+    }
+    
+    delete [] coef;
+    delete [] synthesis;
+}
+
+/*!
+ * @brief           Fills the Fourier coefficients of the correlation
+ * @details         Computes
+ *                  \f[
+ *                      \hat{C}^l_{M,M'} = 2\pi\sqrt{\frac{2}{2l+1}}\;f_{lM'}\;\overline{g_{lM}}
+ *                  \f]
+ *                  for all \f$l < B\f$ and \f$|M|,|M'|\leq l\f$. With these coefficients
+ *                  the IDSOFT synthesizes \f$C(R)\f$ where the grid point \f$(j_2, j_1, k)\f$
+ *                  (row, column, layer) holds the rotation
+ *                  \f$(\alpha, \beta, \gamma) = (\frac{2\pi j_2}{2B}, \frac{\pi(2k+1)}{4B}, \frac{2\pi j_1}{2B})\f$.
+ *
+ * @param[in]       f Spherical harmonic coefficients of the reference function
+ * @param[in]       g Spherical harmonic coefficients of the function that gets rotated
+ */
+void SO3Correlation::coefficients(const vector< complex< double > >& f, const vector< complex< double > >& g)
+{
+    pfsoft_cond_w_ret(f.size != static_cast< size_t >(bandwidth * bandwidth) || g.size != static_cast< size_t >(bandwidth * bandwidth), "%s", "spherical harmonic coefficients do not match the bandwidth of the SO3Correlation.");
+    
+    const vector< complex< double > >* templates = &g;
+    products(f, &templates, 1, coef);
+    
+    first = -1;
+    chunk = 1;
+}
+
+/*!
+ * @brief           Computes the correlation products of one function with a
+ *                  chunk of templates
+ * @details         Sweeps once over the degrees and orders of \f$f\f$. Every scaled
+ *                  \f$f_{lM'}\f$ is applied to all templates before the next one is
+ *                  loaded. For a fixed \f$M'\f$ the orders \f$0\leq M\leq l\f$ and
+ *                  \f$-l\leq M<0\f$ are two contiguous runs in the templates and in
+ *                  the coefficient containers, so the inner loops vectorize along
+ *                  \f$M\f$.
+ *
+ * @param[in]       f Spherical harmonic coefficients of the reference function
+ * @param[in]       g Spherical harmonic coefficients of the templates
+ * @param[in]       chunk The number of templates
+ * @param[out]      c The Fourier coefficients containers that get filled, one per template
+ *
+ * @sa              SO3Correlation::coefficients
+ */
+void SO3Correlation::products(const vector< complex< double > >& f, const vector< complex< double > >* const* g, const int& chunk, DSOFTFourierCoefficients** c) const
+{
+    for (int l = 0; l < bandwidth; ++l)
+    {
+        const int    off = l * l + l;
+        const int    len = 2 * l + 1;
+        const double fac = factors[l];
+        
+        for (int Mp = -l; Mp <= l; ++Mp)
+        {
+            // f_{lM'} scaled by the degree factor
+            const double fr = fac * f[off + Mp].re;
+            const double fi = fac * f[off + Mp].im;
+            
+            const size_t row = DSOFTFourierCoefficients::offset(l) + static_cast< size_t >(Mp >= 0 ? Mp : len + Mp) * len;
+            
+            for (int i = 0; i < chunk; ++i)
+            {
+                // g_{lM} for M = 0, ..., l and M = -l, ..., -1 and the
+                // matching runs of the container
+                const double* gp = reinterpret_cast< const double* >(&(*g[i])[off]);
+                const double* gn = reinterpret_cast< const double* >(&(*g[i])[off - l]);
+                double*       vp = reinterpret_cast< double* >(&(*c[i])(0, 0, 0)) + 2 * row;
+                double*       vn = vp + 2 * (l + 1);
+                
+                // multiply with conj(g_{lM})
+                for (int M = 0; M <= l; ++M)
+                {
+                    vp[2 * M]     = fr * gp[2 * M] + fi * gp[2 * M + 1];
+                    vp[2 * M + 1] = fi * gp[2 * M] - fr * gp[2 * M + 1];
+                }
+                
+                for (int M = 0; M < l; ++M)
+                {
+                    vn[2 * M]     = fr * gn[2 * M] + fi * gn[2 * M + 1];
+                    vn[2 * M + 1] = fi * gn[2 * M] - fr * gn[2 * M + 1];
+                }
+            }
+        }
+    }
+}
+
+/*!
+ * @brief           Correlates two functions on the sphere
+ * @details         Fills the Fourier coefficients of the correlation, synthesizes
+ *                  the correlation on the Euler angle grid with the IDSOFT and
+ *                  returns the rotation with the largest real part of the
+ *                  correlation.
+ *
+ * @param[in]       f Spherical harmonic coefficients of the reference function
+ * @param[in]       g Spherical harmonic coefficients of the function that gets rotated
+ * @param[in]       threads The number of threads used by the IDSOFT
+ * @return          The grid rotation that aligns \f$g\f$ best to \f$f\f$
+ *
+ * @sa              SO3Correlation::coefficients
+ * @sa              FourierTransforms::IDSOFT
+ */
+SO3Rotation SO3Correlation::correlate(const vector< complex< double > >& f, const vector< complex< double > >& g, int threads)
+{
+    coefficients(f, g);
+    FourierTransforms::IDSOFT(*coef[0], *synthesis[0], threads);
+    
+    return argmax();
+}
+
+/*!
+ * @brief           Correlates one function against many templates
+ * @details         The templates are processed in chunks of SO3Correlation::batch
+ *                  templates. For every chunk the correlation products are computed,
+ *                  all correlations of the chunk are synthesized with one batched
+ *                  IDSOFT and the k rotations with the largest real part of the
+ *                  correlation are extracted from every grid before the next chunk
+ *                  reuses the grids.
+ *
+ * @param[in]       f Spherical harmonic coefficients of the reference function
+ * @param[in]       templates Spherical harmonic coefficients of the templates
+ * @param[in]       k The number of best rotations that are returned per template
+ * @param[in]       threads The number of threads used by the batched IDSOFT
+ * @return          The k best grid rotations of template t sorted descending by
+ *                  the real part of the correlation at the indices
+ *                  \f$tk,\dots,(t+1)k-1\f$. An empty vector is returned if any
+ *                  coefficient set does not match the bandwidth.
+ *
+ * @sa              FourierTransforms::IDSOFT
+ */
+std::vector< SO3Rotation > SO3Correlation::correlate(const vector< complex< double > >& f, const std::vector< vector< complex< double > > >& templates, const size_t& k, int threads)
+{
+    std::vector< SO3Rotation > rotations;
+    
+    const size_t sq  = static_cast< size_t >(bandwidth * bandwidth);
+    const size_t cap = 8 * sq * bandwidth;
+    
+    bool mismatch = f.size != sq;
+    for (size_t t = 0; t < templates.size(); ++t)
+    {
+        mismatch = mismatch || templates[t].size != sq;
+    }
+    
+    pfsoft_cond_w(mismatch, "%s", "spherical harmonic coefficients do not match the bandwidth of the SO3Correlation.");
+    pfsoft_cond_w(k > cap, "%s", "more rotations requested than the correlation grid contains. Returning all grid rotations.");
+    
+    if (mismatch)
+    {
+        return rotations;
+    }
+    
+    const size_t top = std::min(k, cap);
+    rotations.resize(templates.size() * top);
+    
+    for (size_t start = 0; start < templates.size(); start += batch)
+    {
+        chunk = static_cast< int >(std::min(templates.size() - start, static_cast< size_t >(batch)));
+        first = static_cast< long >(start);
+        
+        std::vector< const vector< complex< double > >* > chunk_templates(chunk);
+        for (int i = 0; i < chunk; ++i)
+        {
+            chunk_templates[i] = &templates[start + i];
+        }
+        
+        products(f, chunk_templates.data(), chunk, coef);
+        
+        FourierTransforms::IDSOFT(coef, synthesis, chunk, threads);
+        
+        #pragma omp parallel for schedule(dynamic) num_threads(threads) if(threads > 1 && chunk > 1)
+        for (int i = 0; i < chunk; ++i)
+        {
+            best(i, top, &rotations[(start + i) * top]);
+        }
+    }
+    
+    return rotations;
+}
+
+/*!
+ * @brief           The rotation with the largest real part of the last correlation
+ * @details         Scans the Euler angle grid of the last single correlation once.
+ *                  Of grid points with the same value the one with the smallest
+ *                  index is taken.
+ *
+ * @return          The grid rotation with the largest real part of the correlation
+ */
+SO3Rotation SO3Correlation::argmax() const
+{
+    pfsoft_cond_w(first >= 0, "%s", "the last correlation was a batch. SO3Correlation::argmax refers to the first template of its last chunk.");
+    
+    const grid3D< complex< double > >& grid = *synthesis[0];
+    const size_t cap = grid.rows * grid.cols * grid.lays;
+    
+    size_t idx = 0;
+    for (size_t i = 1; i < cap; ++i)
+    {
+        if (grid.mem[i].re > grid.mem[idx].re)
+        {
+            idx = i;
+        }
+    }
+    
+    // reconstruct grid indices
+    const size_t lay = idx / (grid.rows * grid.cols);
+    const size_t col = (idx % (grid.rows * grid.cols)) / grid.rows;
+    const size_t row = idx % grid.rows;
+    
+    return rotation(row, col, lay);
+}
+
+/*!
+ * @brief           Refines a rotation of the last single correlation below the grid
+ *                  resolution
+ * @details         Evaluates the correlation series directly at Euler angles around
+ *                  the given rotation and improves them by parabolic steps. This
+ *                  costs \f$\mathcal{O}(B^3)\f$ per iteration instead of an inverse
+ *                  transform at a higher bandwidth. The coefficients of the last
+ *                  single correlation are used. After a batch the peak is returned
+ *                  unchanged, use the overload with the template index instead.
+ *
+ * @param[in]       peak A grid rotation, usually the result of SO3Correlation::argmax
+ * @param[in]       iterations The number of refinement iterations. Each halves the
+ *                  step width, starting at the grid spacing.
+ * @return          The refined rotation and the correlation value at this rotation
+ *
+ * @sa              FourierTransforms::refine
+ */
+SO3Rotation SO3Correlation::refine(const SO3Rotation& peak, const int& iterations) const
+{
+    pfsoft_cond_w(first >= 0, "%s", "the last correlation was a batch. Pass the template index to SO3Correlation::refine.");
+    
+    if (first >= 0)
+    {
+        return peak;
+    }
+    
+    return refine_slot(0, peak, iterations);
+}
+
+/*!
+ * @brief           Refines a rotation of a template of the last batch below the
+ *                  grid resolution
+ * @details         Like SO3Correlation::refine for a single correlation, with the
+ *                  coefficients of template t. Only the templates of the last chunk
+ *                  of the last batch are available. For any other template the peak
+ *                  is returned unchanged.
+ *
+ * @param[in]       t The index of the template in the last batch
+ * @param[in]       peak A grid rotation of template t, usually one of the rotations
+ *                  returned by the batched SO3Correlation::correlate
+ * @param[in]       iterations The number of refinement iterations
+ * @return          The refined rotation and the correlation value at this rotation
+ */
+SO3Rotation SO3Correlation::refine(const size_t& t, const SO3Rotation& peak, const int& iterations) const
+{
+    const int s = template_slot(t);
+    
+    pfsoft_cond_w(s < 0, "template %zu is not part of the last chunk of the last batch.", t);
+    
+    if (s < 0)
+    {
+        return peak;
+    }
+    
+    return refine_slot(s, peak, iterations);
+}
+
+/*!
+ * @brief           Refines a rotation of the correlation in a batch slot
+ */
+SO3Rotation SO3Correlation::refine_slot(const int& slot, const SO3Rotation& peak, const int& iterations) const
+{
+    // The correlation grid stores the Euler angle alpha along the rows and
+    // gamma along the columns, which is swapped to the DSOFT sampling.
+    double a = peak.gamma;
+    double b = peak.beta;
+    double g = peak.alpha;
+    
+    SO3Rotation R;
+    R.value = FourierTransforms::refine(*coef[slot], a, b, g, iterations);
+    R.alpha = g;
+    R.beta  = b;
+    R.gamma = a;
+    
+    return R;
+}
+
+/*!
+ * @brief           The batch slot that holds a template of the last batch
+ *
+ * @param[in]       t The index of the template in the last batch
+ * @return          The slot or -1 if the template is not in the last chunk
+ */
+int SO3Correlation::template_slot(const size_t& t) const
+{
+    if (first < 0 || t < static_cast< size_t >(first) || t >= static_cast< size_t >(first) + chunk)
+    {
+        return -1;
+    }
+    
+    return static_cast< int >(t - static_cast< size_t >(first));
+}
+
+/*!
+ * @brief           Whether a grid point is a local maximum of the real part
+ * @details         Compares the grid point with its 26 neighbours. The grid is
+ *                  periodic in \f$\alpha\f$ (rows) and \f$\gamma\f$ (columns) but
+ *                  not in \f$\beta\f$ (layers). Of neighbours with the same value
+ *                  only the one with the smallest index is a maximum, so a plateau
+ *                  yields a single rotation.
+ *
+ * @param[in]       grid The correlation
+ * @param[in]       idx The linear index of the grid point
+ * @return          True if no neighbour is larger
+ */
+bool SO3Correlation::local_max(const grid3D< complex< double > >& grid, const size_t& idx) const
+{
+    const long rows = static_cast< long >(grid.rows);
+    const long cols = static_cast< long >(grid.cols);
+    const long lays = static_cast< long >(grid.lays);
+    
+    const long lay = static_cast< long >(idx) / (rows * cols);
+    const long col = (static_cast< long >(idx) % (rows * cols)) / rows;
+    const long row = static_cast< long >(idx) % rows;
+    
+    const double re = grid.mem[idx].re;
+    
+    for (long dl = -1; dl <= 1; ++dl)
+    {
+        const long l = lay + dl;
+        
+        if (l < 0 || l >= lays)
+        {
+            continue;
+        }
+        
+        for (long dc = -1; dc <= 1; ++dc)
+        {
+            const long c = (col + dc + cols) % cols;
+            
+            for (long dr = -1; dr <= 1; ++dr)
+            {
+                const long   r = (row + dr + rows) % rows;
+                const size_t n = static_cast< size_t >(l * rows * cols + c * rows + r);
+                
+                if (n == idx)
+                {
+                    continue;
+                }
+                
+                const double v = grid.mem[n].re;
+                
+                if (v > re || (v == re && n < idx))
+                {
+                    return false;
+                }
+            }
+        }
+    }
+    
+    return true;
+}
+
+/*!
+ * @brief           The unit quaternion of a rotation in ZYZ Euler angles
+ * @details         The absolute inner product of two such quaternions is the cosine
+ *                  of half the angle of the rotation between them. It does not depend
+ *                  on the Euler angles, which are ambiguous near the poles of
+ *                  \f$\beta\f$ where only \f$\alpha + \gamma\f$ matters.
+ */
+static inline void quaternion(const SO3Rotation& R, double* q)
+{
+    const double cb = cos(0.5 * R.beta);
+    const double sb = sin(0.5 * R.beta);
+    
+    q[0] = cb * cos(0.5 * (R.alpha + R.gamma));
+    q[1] = sb * sin(0.5 * (R.gamma - R.alpha));
+    q[2] = sb * cos(0.5 * (R.alpha - R.gamma));
+    q[3] = cb * sin(0.5 * (R.alpha + R.gamma));
+}
+
+/*!
+ * @brief           The rotations with the largest real part of a correlation
+ * @details         Collects the local maxima of the grid and takes them by
+ *                  descending value. A maximum is skipped if the angle of the
+ *                  rotation between it and a rotation that was already taken is
+ *                  below one grid step \f$2\pi/2B\f$. The angle is compared through
+ *                  the unit quaternions of both rotations. Without this non-maximum
+ *                  suppression the k best grid points of a smooth correlation are
+ *                  neighbours on the same peak, and near the poles of \f$\beta\f$
+ *                  grid points with the same \f$\alpha + \gamma\f$ are distinct
+ *                  maxima of the same rotation. If the correlation has fewer than k
+ *                  distinct maxima, the remaining rotations are the largest other
+ *                  grid points, selected with a min-heap without sorting the grid.
+ *
+ * @param[in]       slot The batch slot of the correlation
+ * @param[in]       k The number of rotations
+ * @param[out]      rotations The k best rotations sorted descending by the real
+ *                  part of the correlation
+ */
+void SO3Correlation::best(const int& slot, const size_t& k, SO3Rotation* rotations) const
+{
+    typedef std::pair< double, size_t > entry;
+    
+    const grid3D< complex< double > >& grid = *synthesis[slot];
+    const size_t cap = grid.rows * grid.cols * grid.lays;
+    
+    // cosine of half the smallest angle between two distinct rotations
+    const double overlap = cos(0.5 * constants< double >::pi / bandwidth);
+    
+    std::vector< entry > maxima;
+    for (size_t i = 0; i < cap; ++i)
+    {
+        if (local_max(grid, i))
+        {
+            maxima.push_back(entry(grid.mem[i].re, i));
+        }
+    }
+    
+    // largest values first
+    std::sort(maxima.begin(), maxima.end(), std::greater< entry >());
+    
+    std::vector< size_t > taken;
+    std::vector< double > quaternions;
+    
+    for (size_t i = 0; i < maxima.size() && taken.size() < k; ++i)
+    {
+        // reconstruct grid indices
+        const size_t idx = maxima[i].second;
+        const size_t lay = idx / (grid.rows * grid.cols);
+        const size_t col = (idx % (grid.rows * grid.cols)) / grid.rows;
+        const size_t row = idx % grid.rows;
+        
+        const SO3Rotation R = rotation(slot, row, col, lay);
+        
+        double q[4];
+        quaternion(R, q);
+        
+        bool distinct = true;
+        for (size_t j = 0; j < quaternions.size() && distinct; j += 4)
+        {
+            const double* p = &quaternions[j];
+            distinct        = fabs(q[0] * p[0] + q[1] * p[1] + q[2] * p[2] + q[3] * p[3]) < overlap;
+        }
+        
+        if (distinct)
+        {
+            rotations[taken.size()] = R;
+            taken.push_back(idx);
+            quaternions.insert(quaternions.end(), q, q + 4);
+        }
+    }
+    
+    if (taken.size() == k)
+    {
+        return;
+    }
+    
+    // fill up with the largest grid points that were not taken
+    const size_t missing = k - taken.size();
+    std::sort(taken.begin(), taken.end());
+    
+    std::vector< entry > heap;
+    heap.reserve(missing);
+    
+    for (size_t i = 0; i < cap; ++i)
+    {
+        const double re = grid.mem[i].re;
+        
+        // the smallest value of the heap
+        if (heap.size() == missing && re <= heap[0].first)
+        {
+            continue;
+        }
+        
+        if (std::binary_search(taken.begin(), taken.end(), i))
+        {
+            continue;
+        }
+        
+        if (heap.size() < missing)
+        {
+            heap.push_back(entry(re, i));
+            std::push_heap(heap.begin(), heap.end(), std::greater< entry >());
+        }
+        else
+        {
+            std::pop_heap(heap.begin(), heap.end(), std::greater< entry >());
+            heap.back() = entry(re, i);
+            std::push_heap(heap.begin(), heap.end(), std::greater< entry >());
+        }
+    }
+    
+    // largest values first
+    std::sort_heap(heap.begin(), heap.end(), std::greater< entry >());
+    
+    for (size_t i = 0; i < heap.size(); ++i)
+    {
+        // reconstruct grid indices
+        const size_t idx = heap[i].second;
+        const size_t lay = idx / (grid.rows * grid.cols);
+        const size_t col = (idx % (grid.rows * grid.cols)) / grid.rows;
+        const size_t row = idx % grid.rows;
+        
+        rotations[taken.size() + i] = rotation(slot, row, col, lay);
+    }
+}
+
+/*!
+ * @brief           The rotation of a grid point of the correlation
+ *
+ * @param[in]       row The row index \f$j_2\f$ of the grid point
+ * @param[in]       col The column index \f$j_1\f$ of the grid point
+ * @param[in]       lay The layer index \f$k\f$ of the grid point
+ * @return          The Euler angles and the correlation value at the grid point
+ */
+SO3Rotation SO3Correlation::rotation(const size_t& row, const size_t& col, const size_t& lay) const
+{
+    return rotation(0, row, col, lay);
+}
+
+/*!
+ * @brief           The rotation of a grid point of a correlation in the batch
+ *
+ * @param[in]       slot The batch slot of the correlation
+ * @param[in]       row The row index \f$j_2\f$ of the grid point
+ * @param[in]       col The column index \f$j_1\f$ of the grid point
+ * @param[in]       lay The layer index \f$k\f$ of the grid point
+ * @return          The Euler angles and the correlation value at the grid point
+ */
+SO3Rotation SO3Correlation::rotation(const int& slot, const size_t& row, const size_t& col, const size_t& lay) const
+{
+    SO3Rotation R;
+    R.alpha = constants< double >::pi * row / bandwidth;
+    R.beta  = constants< double >::pi * (2.0 * lay + 1.0) / (4.0 * bandwidth);
+    R.gamma = constants< double >::pi * col / bandwidth;
+    R.value = (*synthesis[slot])(row, col, lay);
+    
+    return R;
+}
+
+/*!
+ * @brief           The Fourier coefficients of the last single correlation
+ * @details         After a batch the coefficients of the first template of its
+ *                  last chunk are returned and a warning is printed.
+ *
+ * @return          The DSOFT Fourier coefficients of the correlation
+ */
+const DSOFTFourierCoefficients& SO3Correlation::fourier_coefficients() const
+{
+    pfsoft_cond_w(first >= 0, "%s", "the last correlation was a batch. Pass the template index to SO3Correlation::fourier_coefficients.");
+    
+    return *coef[0];
+}
+
+/*!
+ * @brief           The Fourier coefficients of a template of the last batch
+ * @details         Only the templates of the last chunk are available. For any
+ *                  other template a warning is printed and the coefficients of the
+ *                  first slot are returned.
+ *
+ * @param[in]       t The index of the template in the last batch
+ * @return          The DSOFT Fourier coefficients of the correlation with template t
+ */
+const DSOFTFourierCoefficients& SO3Correlation::fourier_coefficients(const size_t& t) const
+{
+    const int s = template_slot(t);
+    
+    pfsoft_cond_w(s < 0, "template %zu is not part of the last chunk of the last batch.", t);
+    
+    return *coef[std::max(s, 0)];
+}
+
+/*!
+ * @brief           The last single correlation on the Euler angle grid
+ *
+ * @return          The grid holding \f$C(R)\f$. See SO3Correlation::coefficients
+ *                  for the rotation of each grid point.
+ */
+const grid3D< complex< double > >& SO3Correlation::correlation() const
+{
+    return *synthesis[0];
+}
+
+PFSOFT_END
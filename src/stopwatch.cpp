@@ -22,16 +22,23 @@
 
 #include <pfsoft>
 
+#if defined(__x86_64__) || defined(__i386__)
+    #include <x86intrin.h>
+#endif
+
 PFSOFT_BEGIN
     
 /*!
  * @brief           Private constructor for the stopwatch class
  * @details         Constructs the stopwatch by setting the start
- *                  time to the current time.
+ *                  time to the current time. The time is taken from the
+ *                  monotonic raw clock, so it has nanosecond resolution and
+ *                  is neither affected by NTP adjustments nor by setting
+ *                  the system time.
  */
 stopwatch::stopwatch()
 {
-    gettimeofday(&start, NULL);
+    clock_gettime(PFSOFT_STOPWATCH_CLOCK, &start);
 }
 
 /*!
@@ -54,27 +61,76 @@ stopwatch::~stopwatch()
 {}
 
 /*!
- * @brief           Stops the time in seconds from the stopwatch::tic() or the last
- *                  toc_<X>() time
- * @details         Stops the time and calculates the difference from toc or last tic 
- *                  command in seconds.
+ * @brief           Nanoseconds since the last tic or toc
+ * @details         Sets the start time to the current time.
  *
- * @return          The seconds elapsed from stopwatch::tic() or other toc_<X>() functions
+ * @return          The nanoseconds elapsed from stopwatch::tic() or the last toc_<X>()
  */
-double stopwatch::toc()
+double stopwatch::lap()
 {
     // set end time
-    struct timeval end;
-    gettimeofday(&end, NULL);
+    struct timespec end;
+    clock_gettime(PFSOFT_STOPWATCH_CLOCK, &end);
     
     // calculate difference
-    long elapsed = ((end.tv_sec - start.tv_sec) * 1000000L + end.tv_usec) - start.tv_usec;
+    const double elapsed = (end.tv_sec - start.tv_sec) * 1e+9 + (end.tv_nsec - start.tv_nsec);
     
     // reset time
     start = end;
     
+    return elapsed;
+}
+
+/*!
+ * @brief           Stops the time in nanoseconds from the stopwatch::tic() or the
+ *                  last toc_<X>() time
+ * @details         Stops the time and calculates the difference from toc or last tic
+ *                  command in nanoseconds.
+ *
+ * @return          The nanoseconds elapsed from stopwatch::tic() or other toc_<X>() functions
+ */
+double stopwatch::toc_nanos()
+{
+    return lap();
+}
+
+/*!
+ * @brief           Reads the time stamp counter of the processor
+ * @details         On x86 this is the rdtsc instruction, which takes only a few
+ *                  cycles and is suited to time very short code snippets. The
+ *                  counter runs at a constant rate on current processors, which
+ *                  is not necessarily the core clock. On other architectures the
+ *                  nanoseconds of the monotonic raw clock are returned.
+ *
+ * @return          The current time stamp counter
+ */
+uint64_t stopwatch::ticks()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    struct timespec now;
+    clock_gettime(PFSOFT_STOPWATCH_CLOCK, &now);
+    
+    return static_cast< uint64_t >(now.tv_sec) * 1000000000ULL + now.tv_nsec;
+#endif
+}
+
+/*!
+ * @brief           Stops the time in seconds from the stopwatch::tic() or the last
+ *                  toc_<X>() time
+ * @details         Stops the time and calculates the difference from toc or last tic 
+ *                  command in seconds.
+ *
+ * @return          The seconds elapsed from stopwatch::tic() or other toc_<X>() functions
+ */
+double stopwatch::toc()
+{
+    // nanoseconds since the last tic or toc
+    const double elapsed = lap();
+    
     // return result
-    return elapsed / 1e+6;
+    return elapsed / 1e+9;
 }
 
 /*!
@@ -87,18 +143,11 @@ double stopwatch::toc()
  */
 double stopwatch::toc_micros()
 {
-    // set end time
-    struct timeval end;
-    gettimeofday(&end, NULL);
-    
-    // calculate difference
-    long elapsed = ((end.tv_sec - start.tv_sec) * 1000000L + end.tv_usec) - start.tv_usec;
-    
-    // reset time
-    start = end;
+    // nanoseconds since the last tic or toc
+    const double elapsed = lap();
     
     // return result
-    return elapsed;
+    return elapsed / 1e+3;
 }
 
 /*!
@@ -111,18 +160,11 @@ double stopwatch::toc_micros()
  */
 double stopwatch::toc_millis()
 {
-    // set end time
-    struct timeval end;
-    gettimeofday(&end, NULL);
-    
-    // calculate difference
-    long elapsed = ((end.tv_sec - start.tv_sec) * 1000000L + end.tv_usec) - start.tv_usec;
-    
-    // reset time
-    start = end;
+    // nanoseconds since the last tic or toc
+    const double elapsed = lap();
     
     // return result
-    return elapsed / 1e+3;
+    return elapsed / 1e+6;
 }
 
 /*!
@@ -135,18 +177,11 @@ double stopwatch::toc_millis()
  */
 double stopwatch::toc_seconds()
 {
-    // set end time
-    struct timeval end;
-    gettimeofday(&end, NULL);
-    
-    // calculate difference
-    long elapsed = ((end.tv_sec - start.tv_sec) * 1000000L + end.tv_usec) - start.tv_usec;
-    
-    // reset time
-    start = end;
+    // nanoseconds since the last tic or toc
+    const double elapsed = lap();
     
     // return result
-    return elapsed / 1e+6;
+    return elapsed / 1e+9;
 }
 
 /*!
@@ -159,18 +194,11 @@ double stopwatch::toc_seconds()
  */
 double stopwatch::toc_minutes()
 {
-    // set end time
-    struct timeval end;
-    gettimeofday(&end, NULL);
-    
-    // calculate difference
-    long elapsed = ((end.tv_sec - start.tv_sec) * 1000000L + end.tv_usec) - start.tv_usec;
-    
-    // reset time
-    start = end;
+    // nanoseconds since the last tic or toc
+    const double elapsed = lap();
     
     // return result
-    return elapsed / 6e+7;
+    return elapsed / 6e+10;
 }
 
 /*!
@@ -183,18 +211,11 @@ double stopwatch::toc_minutes()
  */
 double stopwatch::toc_hours()
 {
-    // set end time
-    struct timeval end;
-    gettimeofday(&end, NULL);
-    
-    // calculate difference
-    long elapsed = ((end.tv_sec - start.tv_sec) * 1000000L + end.tv_usec) - start.tv_usec;
-    
-    // reset time
-    start = end;
+    // nanoseconds since the last tic or toc
+    const double elapsed = lap();
     
     // return result
-    return elapsed / 36e+8;
+    return elapsed / 36e+11;
 }
     
 PFSOFT_END
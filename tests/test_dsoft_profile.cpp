@@ -0,0 +1,84 @@
+//
+//  test_dsoft_profile.cpp
+//  PFSOFTlib
+//
+//   Created by Denis-Michael Lux on 05. November 2015.
+//
+//   This file is part of PFSOFTlib.
+//
+//   PFSOFTlib is free software: you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License as published by
+//   the Free Software Foundation, either version 3 of the License, or
+//   (at your option) any later version.
+//
+//   PFSOFTlib is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with PFSOFTlib.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <pfsoft>
+#include <stdio.h>
+
+using namespace pfsoft;
+using namespace FourierTransforms;
+
+static int failures = 0;
+
+#define check(condition, ...)\
+        do {\
+            if (!(condition)) {\
+                fprintf(stderr, "FAILED %s:%d: ", __FILE__, __LINE__);\
+                fprintf(stderr, __VA_ARGS__);\
+                fprintf(stderr, "\n");\
+                ++failures;\
+            }\
+        } while(0)
+
+// a hand-edited profile with unsorted and duplicate bandwidths
+static void unsorted_profile()
+{
+    const char* path = "test_dsoft_profile.txt";
+    
+    FILE* fp = fopen(path, "w");
+    check(fp != nullptr, "could not write '%s'", path);
+    
+    if (fp == nullptr)
+    {
+        return;
+    }
+    
+    fprintf(fp, "threshold 8\n");
+    fprintf(fp, "64 8\n");
+    fprintf(fp, "8 1\n");
+    fprintf(fp, "32 4\n");
+    fprintf(fp, "16 2\n");
+    fprintf(fp, "32 3\n");
+    fclose(fp);
+    
+    check(DSOFT_load_profile(path), "could not load '%s'", path);
+    remove(path);
+    
+    const int expected[][2] = { { 4, 1 }, { 8, 1 }, { 20, 2 }, { 32, 3 }, { 48, 3 }, { 64, 8 }, { 128, 8 } };
+    
+    for (size_t i = 0; i < sizeof(expected) / sizeof(expected[0]); ++i)
+    {
+        const int threads = DSOFT_threads(expected[i][0], 16);
+        check(threads == expected[i][1], "bandwidth %d: expected %d threads, got %d", expected[i][0], expected[i][1], threads);
+    }
+}
+
+int main()
+{
+    unsorted_profile();
+    
+    if (failures == 0)
+    {
+        printf("test_dsoft_profile: passed\n");
+    }
+    
+    return failures == 0 ? 0 : 1;
+}
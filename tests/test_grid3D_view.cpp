@@ -0,0 +1,166 @@
+//
+//  test_grid3D_view.cpp
+//  PFSOFTlib
+//
+//   Created by Denis-Michael Lux on 05. November 2015.
+//
+//   This file is part of PFSOFTlib.
+//
+//   PFSOFTlib is free software: you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License as published by
+//   the Free Software Foundation, either version 3 of the License, or
+//   (at your option) any later version.
+//
+//   PFSOFTlib is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with PFSOFTlib.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <pfsoft>
+#include <stdio.h>
+#include <vector>
+
+using namespace pfsoft;
+
+static int failures = 0;
+
+#define check(condition, ...)\
+        do {\
+            if (!(condition)) {\
+                fprintf(stderr, "FAILED %s:%d: ", __FILE__, __LINE__);\
+                fprintf(stderr, __VA_ARGS__);\
+                fprintf(stderr, "\n");\
+                ++failures;\
+            }\
+        } while(0)
+
+static complex< double > value(const size_t& r, const size_t& c, const size_t& l)
+{
+    return complex< double >(r + 10.0 * c + 100.0 * l, -1.0 * (r + c + l));
+}
+
+// a view on every second element of an interleaved buffer with the default
+// column and layer strides
+static void interleaved_view()
+{
+    const size_t B = 4, n = 2 * B;
+    const complex< double > sentinel(-7, -7);
+    
+    std::vector< complex< double > > buffer(2 * n * n * n, sentinel);
+    grid3D< complex< double > > view(buffer.data(), n, n, n, 2);
+    
+    check(view.strides[1] == 2 * n && view.strides[2] == 2 * n * n, "default strides %zu, %zu", view.strides[1], view.strides[2]);
+    
+    for (size_t l = 0; l < n; ++l)
+    {
+        for (size_t c = 0; c < n; ++c)
+        {
+            for (size_t r = 0; r < n; ++r)
+            {
+                view(r, c, l) = value(r, c, l);
+            }
+        }
+    }
+    
+    // every element lands in its own even slot, the odd slots stay untouched
+    bool distinct = true, untouched = true;
+    for (size_t i = 0; i < n * n * n; ++i)
+    {
+        const complex< double > v = value(i % n, (i / n) % n, i / (n * n));
+        
+        distinct  = distinct  && buffer[2 * i].re == v.re && buffer[2 * i].im == v.im;
+        untouched = untouched && buffer[2 * i + 1].re == sentinel.re && buffer[2 * i + 1].im == sentinel.im;
+    }
+    
+    check(distinct,  "%s", "elements of the view alias each other");
+    check(untouched, "%s", "the view wrote between its elements");
+    
+    // the transform of the view equals the one of a dense copy
+    grid3D< complex< double > > dense(view);
+    
+    DSOFTFourierCoefficients a(B), b(B);
+    FourierTransforms::DSOFT(view,  a, 1);
+    FourierTransforms::DSOFT(dense, b, 1);
+    
+    double error = 0;
+    for (int l = 0; l < static_cast< int >(B); ++l)
+    {
+        for (int M = -l; M <= l; ++M)
+        {
+            for (int Mp = -l; Mp <= l; ++Mp)
+            {
+                error = std::max(error, fabs(a(l, M, Mp).re - b(l, M, Mp).re) + fabs(a(l, M, Mp).im - b(l, M, Mp).im));
+            }
+        }
+    }
+    
+    check(error < 1e-12, "DSOFT of the view differs from the dense copy by %g", error);
+}
+
+// views are transformed slab by slab, their stats are the ones of the
+// streaming transforms
+static void streamed_stats()
+{
+    const size_t B = 4, n = 2 * B;
+    
+    std::vector< complex< double > > buffer(2 * n * n * n);
+    grid3D< complex< double > > view(buffer.data(), n, n, n, 2);
+    
+    DSOFTFourierCoefficients coef(B), rec(B);
+    for (int l = 0; l < static_cast< int >(B); ++l)
+    {
+        for (int M = -l; M <= l; ++M)
+        {
+            for (int Mp = -l; Mp <= l; ++Mp)
+            {
+                coef(l, M, Mp) = complex< double >(l + 0.5 * M, 0.25 * Mp);
+            }
+        }
+    }
+    
+    DSOFTStats inv, fwd;
+    FourierTransforms::IDSOFT(coef, view, inv, 1);
+    FourierTransforms::DSOFT(view, rec, fwd, 1);
+    
+    const DSOFTStats* stats[2] = { &inv, &fwd };
+    for (int i = 0; i < 2; ++i)
+    {
+        check(stats[i]->bandwidth == static_cast< int >(B) && stats[i]->total > 0, "stats %d: bandwidth %d, total %g", i, stats[i]->bandwidth, stats[i]->total);
+        
+        if (stats[i]->enabled)
+        {
+            check(stats[i]->time[DSOFTStats::FFT] > 0 && stats[i]->time[DSOFTStats::DWT] > 0 && stats[i]->loops > 0, "stats %d: stages of the slab-wise transform not recorded", i);
+        }
+    }
+    
+    double error = 0;
+    for (int l = 0; l < static_cast< int >(B); ++l)
+    {
+        for (int M = -l; M <= l; ++M)
+        {
+            for (int Mp = -l; Mp <= l; ++Mp)
+            {
+                error = std::max(error, fabs(rec(l, M, Mp).re - coef(l, M, Mp).re) + fabs(rec(l, M, Mp).im - coef(l, M, Mp).im));
+            }
+        }
+    }
+    
+    check(error < 1e-12, "round trip through the view with stats has error %g", error);
+}
+
+int main()
+{
+    interleaved_view();
+    streamed_stats();
+    
+    if (failures == 0)
+    {
+        printf("test_grid3D_view: passed\n");
+    }
+    
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,105 @@
+//
+//  test_so3_correlation.cpp
+//  PFSOFTlib
+//
+//   Created by Denis-Michael Lux on 05. November 2015.
+//
+//   This file is part of PFSOFTlib.
+//
+//   PFSOFTlib is free software: you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License as published by
+//   the Free Software Foundation, either version 3 of the License, or
+//   (at your option) any later version.
+//
+//   PFSOFTlib is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with PFSOFTlib.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <pfsoft>
+#include <stdio.h>
+#include <vector>
+
+using namespace pfsoft;
+
+static int failures = 0;
+
+#define check(condition, ...)\
+        do {\
+            if (!(condition)) {\
+                fprintf(stderr, "FAILED %s:%d: ", __FILE__, __LINE__);\
+                fprintf(stderr, __VA_ARGS__);\
+                fprintf(stderr, "\n");\
+                ++failures;\
+            }\
+        } while(0)
+
+// deterministic spherical harmonic coefficients of bandwidth B
+static vector< complex< double > > coefficients(const int& B, const double& seed)
+{
+    vector< complex< double > > c(B * B);
+    for (int i = 0; i < B * B; ++i)
+    {
+        c[i] = complex< double >(sin(seed * (i + 1)), cos(1.7 * seed * (i + 1))) * (1.0 / (1.0 + i / B));
+    }
+    
+    return c;
+}
+
+static bool same(const SO3Rotation& a, const SO3Rotation& b)
+{
+    return fabs(a.alpha - b.alpha) < 1e-12 && fabs(a.beta - b.beta) < 1e-12 && fabs(a.gamma - b.gamma) < 1e-12
+        && fabs(a.value.re - b.value.re) < 1e-9 && fabs(a.value.im - b.value.im) < 1e-9;
+}
+
+// refine after a batched correlate uses the coefficients of the given template
+static void refine_after_batch()
+{
+    const int B = 8;
+    
+    SO3Correlation corr(B, 2);
+    
+    const vector< complex< double > > f = coefficients(B, 0.3);
+    
+    std::vector< vector< complex< double > > > templates;
+    templates.push_back(coefficients(B, 0.7));
+    templates.push_back(coefficients(B, 1.1));
+    templates.push_back(coefficients(B, 1.9));
+    
+    // three templates in chunks of two, the last chunk holds template 2
+    const std::vector< SO3Rotation > peaks = corr.correlate(f, templates, 1, 1);
+    check(peaks.size() == 3, "expected 3 rotations, got %zu", peaks.size());
+    
+    const SO3Rotation batch_refined = corr.refine(2, peaks[2]);
+    
+    // templates of earlier chunks and the single refine are rejected
+    check(same(corr.refine(0, peaks[0]), peaks[0]), "%s", "template 0 of an earlier chunk was refined");
+    check(same(corr.refine(peaks[2]), peaks[2]), "%s", "single refine after a batch was not rejected");
+    
+    const double coefficient = corr.fourier_coefficients(2)(B - 1, 1, -2).re;
+    
+    // the same template as single correlation
+    const SO3Rotation peak           = corr.correlate(f, templates[2], 1);
+    const SO3Rotation single_refined = corr.refine(peak);
+    
+    check(same(peak, peaks[2]), "%s", "batch and single peak of template 2 differ");
+    check(same(batch_refined, single_refined), "batch refine (%g, %g, %g) differs from single refine (%g, %g, %g)",
+          batch_refined.alpha, batch_refined.beta, batch_refined.gamma, single_refined.alpha, single_refined.beta, single_refined.gamma);
+    check(coefficient == corr.fourier_coefficients()(B - 1, 1, -2).re, "%s", "batch and single coefficients of template 2 differ");
+}
+
+int main()
+{
+    refine_after_batch();
+    
+    if (failures == 0)
+    {
+        printf("test_so3_correlation: passed\n");
+    }
+    
+    return failures == 0 ? 0 : 1;
+}